@@ -0,0 +1,288 @@
+// 编译器各个阶段的基准测试
+// 输入由固定种子的生成器在内存中生成，同样的参数在任何机器上都得到同样的源代码，
+// 可以用--emit把生成的源代码写到文件中，再交给Scompiler或者其他版本的编译器比较
+#include "lexer/lexer.hpp"
+#include "parser/parser.hpp"
+#include "checker/checker.hpp"
+#include "translator/translator.hpp"
+#include "optimizer/optimizer.hpp"
+#include "asm_generator/asm_generator.hpp"
+
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace boost::program_options;
+namespace fs = std::filesystem;
+
+namespace {
+
+// std::mt19937的输出序列由标准规定，这里只使用它的原始输出，不使用分布(分布的实现与标准库有关)
+class Generator {
+ public:
+  explicit Generator(uint32_t seed) : engine_(seed) {}
+  int next(std::size_t n) { return static_cast<int>(engine_() % n); }
+
+  // 变量或者字面量
+  std::string atom(const std::vector<std::string> &vars) {
+    if (next(3) == 0) return std::to_string(next(3000) - 500);
+    return vars[next(vars.size())];
+  }
+
+  // 随机的算术、比较和逻辑表达式，vars为可以读取的变量，depth为最大嵌套深度
+  std::string expr(const std::vector<std::string> &vars, int depth) {
+    if (depth == 0 || next(4) == 0) return atom(vars);
+    static const char *ops[] = {"+", "-", "*", "/", "%", "<", ">", "<=", ">=", "==", "!=", "&&", "||"};
+    switch (next(8)) {
+      case 0: return "-" + expr(vars, depth - 1);
+      case 1: return "!" + expr(vars, depth - 1);
+      case 2:
+        return "(" + expr(vars, depth - 1) + " ? " + expr(vars, depth - 1) + " : " + expr(vars, depth - 1) + ")";
+      case 3: return "(" + expr(vars, depth - 1) + ")";
+      default: {
+        std::string op = ops[next(std::size(ops))];
+        if (op == "/" || op == "%") {  // 除数总是非零的字面量
+          return expr(vars, depth - 1) + " " + op + " " + std::to_string(1 + next(50));
+        }
+        return expr(vars, depth - 1) + " " + op + " " + expr(vars, depth - 1);
+      }
+    }
+  }
+
+ private:
+  std::mt19937 engine_;
+};
+
+// 普通的程序：全局变量和数组、带参数的函数、各种循环和分支、?:、&&和||以及函数调用，
+// 每个函数有8个局部变量和blocks个循环或分支，每个循环或分支中有几条赋值语句
+std::string gen_program(int functions, int blocks, uint32_t seed) {
+  Generator gen(seed);
+  std::ostringstream os;
+  os << "int g0;\nint g1;\nint table[64];\n";
+  for (int f = 0; f < functions; ++f) {
+    os << "int f" << f << "(int p0, int p1) {\n";
+    std::vector<std::string> vars = {"g0", "g1", "p0", "p1"};
+    for (int i = 0; i < 8; ++i) {
+      os << "  int v" << i << " = " << gen.expr(vars, 2) << ";\n";
+      vars.push_back("v" + std::to_string(i));
+    }
+    auto local = [&] { return vars[2 + gen.next(vars.size() - 2)]; };  // 参数或局部变量
+    for (int b = 0; b < blocks; ++b) {
+      std::string var = local();
+      int kind = gen.next(4);
+      if (kind == 0) {
+        os << "  for (int i = 0; i < " << 1 + gen.next(100) << "; i = i + 1) {\n";
+      } else if (kind == 1) {
+        os << "  while (" << var << " < " << gen.atom(vars) << " && " << gen.expr(vars, 1) << ") {\n";
+      } else if (kind == 2) {
+        os << "  if (" << gen.expr(vars, 2) << ") {\n";
+      } else {
+        os << "  do {\n";
+      }
+      for (int s = 0; s < 3; ++s) {
+        os << "    " << local() << " = " << gen.expr(vars, 3) << ";\n";
+      }
+      os << "    table[" << var << " % 64] = " << var << ";\n";
+      if (f > 0 && gen.next(4) == 0) {
+        os << "    " << local() << " = f" << gen.next(f) << "(" << gen.atom(vars) << ", " << gen.atom(vars) << ");\n";
+      }
+      os << "    " << var << " = " << var << " + 1;\n";
+      if (kind == 3) {
+        os << "  } while (" << var << " < " << gen.atom(vars) << ");\n";
+      } else {
+        os << "  }\n";
+      }
+    }
+    os << "  return " << gen.expr(vars, 2) << ";\n}\n";
+  }
+  os << "int main() {\n  return f" << functions - 1 << "(1, 2);\n}\n";
+  return os.str();
+}
+
+// 表达式密集的程序：每条语句是一个嵌套很深的表达式或者连续赋值，用于测试表达式的分析和翻译
+std::string gen_expressions(int functions, int statements, int depth, uint32_t seed) {
+  Generator gen(seed);
+  std::ostringstream os;
+  for (int f = 0; f < functions; ++f) {
+    os << "int e" << f << "(int a, int b) {\n";
+    std::vector<std::string> vars = {"a", "b"};
+    for (int i = 0; i < 4; ++i) {
+      os << "  int x" << i << " = a + " << i << ";\n";
+      vars.push_back("x" + std::to_string(i));
+    }
+    for (int s = 0; s < statements; ++s) {
+      if (gen.next(3) == 0) {
+        os << "  x0 = x1 = x2 = " << gen.expr(vars, depth) << ";\n";
+      } else {
+        os << "  " << vars[2 + gen.next(4)] << " = " << gen.expr(vars, depth) << ";\n";
+      }
+    }
+    os << "  return x0 + x1 + x2 + x3;\n}\n";
+  }
+  os << "int main() {\n  return e0(1, 2);\n}\n";
+  return os.str();
+}
+
+using steady_clock = std::chrono::steady_clock;
+
+double elapsed_ms(steady_clock::time_point begin) {
+  return std::chrono::duration<double, std::milli>(steady_clock::now() - begin).count();
+}
+
+void print_row(const std::string &name, double ms) {
+  std::cout << "  " << std::left << std::setw(28) << name << std::right << std::setw(10)
+            << std::fixed << std::setprecision(2) << ms << " ms" << std::endl;
+}
+
+// 大文件：分别测量各个词法分析器，以及语法分析之后的每个阶段
+void bench_large(const std::string &name, const std::string &code, int reps, int jobs) {
+  auto token_stream = lex(code);
+  std::cout << name << ": " << code.size() << " bytes, " << token_stream.size() << " tokens, average of "
+            << reps << " runs" << std::endl;
+  auto time_lex = [&](const std::string &lexer_name, int lex_jobs) {
+    double total = 0;
+    for (int r = 0; r < reps; ++r) {
+      auto begin = steady_clock::now();
+      auto result = lex(code, lexer_name, lex_jobs);
+      total += elapsed_ms(begin);
+    }
+    return total / reps;
+  };
+  for (const char *lexer_name : {"handwritten", "table", "spirit"}) {
+    print_row(std::string("lex ") + lexer_name, time_lex(lexer_name, 1));
+  }
+  print_row("lex handwritten -j" + std::to_string(jobs), time_lex("handwritten", jobs));
+
+  double parse_ms = 0, parallel_parse_ms = 0, check_ms = 0, translate_ms = 0, optimize_ms = 0, generate_ms = 0;
+  std::size_t nodes = 0, arena_bytes = 0, ir_count = 0, parallel_items = 0, parallel_nodes = 0;
+  for (int r = 0; r < reps; ++r) {
+    {
+      Arena arena;
+      auto begin = steady_clock::now();
+      auto program = parse(token_stream, arena, jobs);
+      parallel_parse_ms += elapsed_ms(begin);
+      parallel_items = program->func_decl_vec().size();
+      parallel_nodes = arena.object_count();
+    }
+    Arena arena;
+    auto begin = steady_clock::now();
+    auto program = parse(token_stream, arena);
+    parse_ms += elapsed_ms(begin);
+    nodes = arena.object_count();
+    arena_bytes = arena.allocated_bytes();
+    // 并行和顺序的语法分析应该得到同样的AST
+    if (parallel_items != program->func_decl_vec().size() || parallel_nodes != nodes) {
+      throw std::logic_error("parse -j" + std::to_string(jobs) + " got " + std::to_string(parallel_items)
+                                 + " functions and " + std::to_string(parallel_nodes) + " ast nodes, expected "
+                                 + std::to_string(program->func_decl_vec().size()) + " and " + std::to_string(nodes));
+    }
+
+    begin = steady_clock::now();
+    check(program);
+    check_ms += elapsed_ms(begin);
+
+    begin = steady_clock::now();
+    auto ir_builder = translate(program);
+    translate_ms += elapsed_ms(begin);
+    ir_count = ir_builder->ircode_list().size();
+
+    begin = steady_clock::now();
+    optimize(ir_builder, 0);
+    optimize_ms += elapsed_ms(begin);
+
+    begin = steady_clock::now();
+    auto asm_vec = generate(ir_builder);
+    generate_ms += elapsed_ms(begin);
+  }
+  print_row("parse", parse_ms / reps);
+  print_row("parse -j" + std::to_string(jobs), parallel_parse_ms / reps);
+  print_row("check", check_ms / reps);
+  print_row("translate", translate_ms / reps);
+  print_row("optimize + regalloc", optimize_ms / reps);
+  print_row("generate asm", generate_ms / reps);
+  std::cout << "  ast nodes " << nodes << ", arena " << arena_bytes / 1024 << " KB, ir " << ir_count << std::endl;
+}
+
+// 小文件：每次都重新创建词法分析器并完成整个编译过程，测量每次调用编译器时的固定开销
+void bench_small(const std::string &code, int repeat) {
+  std::cout << "small: " << code.size() << " bytes, total of " << repeat << " compilations" << std::endl;
+  for (const char *lexer_name : {"handwritten", "table", "spirit"}) {
+    auto begin = steady_clock::now();
+    for (int r = 0; r < repeat; ++r) {
+      auto token_stream = lex(code, lexer_name);
+    }
+    print_row(std::string("lex ") + lexer_name, elapsed_ms(begin));
+  }
+  auto begin = steady_clock::now();
+  for (int r = 0; r < repeat; ++r) {
+    auto token_stream = lex(code, "spirit");
+    Arena arena;
+    auto program = parse(token_stream, arena);
+    check(program);
+    auto ir_builder = translate(program);
+    optimize(ir_builder, 0);
+    auto asm_vec = generate(ir_builder);
+  }
+  print_row("compile (spirit lexer)", elapsed_ms(begin));
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  options_description desc{"Options"};
+  desc.add_options()
+      ("help,h", "print help message")
+      ("functions", value<int>()->default_value(200), "functions in the generated program")
+      ("blocks", value<int>()->default_value(50), "loops and branches per function in the generated program")
+      ("expr-functions", value<int>()->default_value(100), "functions in the generated expression file")
+      ("statements", value<int>()->default_value(40), "statements per function in the generated expression file")
+      ("depth", value<int>()->default_value(8), "max nesting depth of generated expressions")
+      ("small-repeat", value<int>()->default_value(1000), "times the small file is compiled")
+      ("reps,r", value<int>()->default_value(5), "runs averaged for each large file")
+      ("jobs,j", value<int>()->default_value(0), "threads used by the parallel lexer and parser (0 for all cores)")
+      ("seed", value<uint32_t>()->default_value(1), "seed of the source generator")
+      ("emit", value<std::string>(), "write the generated sources to this directory and exit");
+  variables_map vm;
+  store(parse_command_line(argc, argv, desc), vm);
+  if (vm.count("help")) {
+    std::cout << "Usage: scompiler_bench [options]\n" << desc;
+    return 0;
+  }
+  auto seed = vm["seed"].as<uint32_t>();
+  int reps = std::max(1, vm["reps"].as<int>());
+  int jobs = vm["jobs"].as<int>();
+  if (jobs <= 0) jobs = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+  auto program = gen_program(vm["functions"].as<int>(), vm["blocks"].as<int>(), seed);
+  auto expressions = gen_expressions(vm["expr-functions"].as<int>(), vm["statements"].as<int>(),
+                                     vm["depth"].as<int>(), seed);
+  auto small = gen_program(3, 4, seed);
+
+  if (vm.count("emit")) {
+    fs::path dir = vm["emit"].as<std::string>();
+    fs::create_directories(dir);
+    std::ofstream(dir / "program.c") << program;
+    std::ofstream(dir / "expressions.c") << expressions;
+    std::ofstream(dir / "small.c") << small;
+    std::cout << "sources written to " << dir << std::endl;
+    return 0;
+  }
+  try {
+    bench_large("program", program, reps, jobs);
+    bench_large("expressions", expressions, reps, jobs);
+    bench_small(small, vm["small-repeat"].as<int>());
+  } catch (const std::logic_error &e) {  // 生成器的输入总是合法的，出错(包括compile_error)说明编译器或者生成器有问题
+    std::cerr << "error: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
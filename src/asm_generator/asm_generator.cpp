@@ -21,6 +21,11 @@ std::string op_to_asm(IROp op) {
     case IROp::GT: return "sgt";
     case IROp::JMP: return "j";
     case IROp::BEQZ: return "beqz";
+    case IROp::BNEZ: return "bnez";
+    case IROp::BEQ: return "beq";
+    case IROp::BNE: return "bne";
+    case IROp::BLT: return "blt";
+    case IROp::BGE: return "bge";
     case IROp::CALL: return "call";
     case IROp::LA: return "la";
     case IROp::LOAD: return "lw";
@@ -30,21 +35,88 @@ std::string op_to_asm(IROp op) {
   assert(false);
 }
 
-std::vector<std::string> ASMGenerator::generate(const std::list<IRCodePtr> &ir_list) {
+std::vector<std::string> ASMGenerator::generate(const IRList &ir_list) {
   std::vector<std::string> asmcode_vec;
-  auto get_reg_num = [&](IRAddrPtr &addr, int default_reg) -> int { // 如果addr为imm，则使用default_reg作为加载imm
-    if (addr->is_imm()) {
-      asmcode_vec.push_back(build_string("\tli x", default_reg, ", ", addr->imm()));
+  auto get_reg_num = [&](IRAddr &addr, int default_reg) -> int { // 如果addr为imm，则使用default_reg作为加载imm
+    if (addr.is_imm()) {
+      asmcode_vec.push_back(build_string("\tli x", default_reg, ", ", addr.imm()));
       return default_reg;
     }
-    return addr->var().num();
+    return addr.var().num();
   };
-  for (auto &ir : ir_list) {
+  auto get_reg_num_or_x0 = [&](IRAddr &addr, int default_reg) -> int {  // 立即数0直接使用x0
+    if (addr.is_imm() && addr.imm() == 0) return reg_x0;
+    return get_reg_num(addr, default_reg);
+  };
+  // 第二个源操作数为立即数的二元运算，能用I型指令(或者移位)完成时直接生成，不再用li加载立即数
+  auto gen_binary_imm = [&](IRCodePtr ir) -> bool {
+    if (!ir->a1().is_var() || !ir->a2().is_imm()) return false;
+    int a0_reg = ir->a0().var().num();
+    int a1_reg = ir->a1().var().num();
+    int64_t imm = ir->a2().imm();
+    auto gen_i = [&](const char *op, int rd, int rs, int64_t i) {
+      asmcode_vec.push_back(build_string("\t", op, " x", rd, ", x", rs, ", ", i));
+    };
+    switch (ir->op()) {
+      case IROp::ADD:
+        if (!is_imm12(imm)) return false;
+        gen_i("addi", a0_reg, a1_reg, imm);
+        return true;
+      case IROp::SUB:
+        if (!is_imm12(-imm)) return false;
+        gen_i("addi", a0_reg, a1_reg, -imm);
+        return true;
+      case IROp::MUL:  // 乘以2的幂
+        if (imm <= 0 || (imm & (imm - 1)) != 0) return false;
+        if (imm == 1) {
+          asmcode_vec.push_back(build_string("\tmv x", a0_reg, ", x", a1_reg));
+        } else {
+          gen_i("slli", a0_reg, a1_reg, __builtin_ctzll(imm));
+        }
+        return true;
+      case IROp::LT:
+        if (!is_imm12(imm)) return false;
+        gen_i("slti", a0_reg, a1_reg, imm);
+        return true;
+      case IROp::LE:  // a1 <= imm 等价于 a1 < imm + 1
+        if (!is_imm12(imm + 1)) return false;
+        gen_i("slti", a0_reg, a1_reg, imm + 1);
+        return true;
+      case IROp::GT:  // a1 > imm 等价于 !(a1 < imm + 1)
+        if (!is_imm12(imm + 1)) return false;
+        gen_i("slti", a0_reg, a1_reg, imm + 1);
+        gen_i("xori", a0_reg, a0_reg, 1);
+        return true;
+      case IROp::GE:
+        if (!is_imm12(imm)) return false;
+        gen_i("slti", a0_reg, a1_reg, imm);
+        gen_i("xori", a0_reg, a0_reg, 1);
+        return true;
+      case IROp::EQ:
+      case IROp::NE: {
+        if (!is_imm12(imm)) return false;
+        int reg = a1_reg;
+        if (imm != 0) {
+          gen_i("xori", a0_reg, a1_reg, imm);
+          reg = a0_reg;
+        }
+        asmcode_vec.push_back(build_string(ir->op() == IROp::EQ ? "\tseqz x" : "\tsnez x", a0_reg, ", x", reg));
+        return true;
+      }
+      default:
+        return false;
+    }
+  };
+  if (!source_file_.empty()) {
+    asmcode_vec.push_back(build_string("\t.file 1 \"", source_file_, "\""));
+  }
+  for (auto ir : ir_list) {
+    if (is_binary_op(ir->op()) && gen_binary_imm(ir)) continue;
     switch (ir->op()) {
       case IROp::FUNBEG: {
-        cur_func_name_ = ir->a0()->name();
-        cur_fp_sp_diff_ = ir->a1()->imm();
-        cur_array_offset_ = ir->a2()->imm();
+        cur_func_name_ = ir->a0().name();
+        cur_fp_sp_diff_ = ir->a1().imm();
+        cur_array_offset_ = ir->a2().imm();
         asmcode_vec.push_back(build_string("\t.text"));
         asmcode_vec.push_back(build_string("\t.global ", cur_func_name_));
         asmcode_vec.push_back(build_string(cur_func_name_, ":"));
@@ -65,33 +137,37 @@ std::vector<std::string> ASMGenerator::generate(const std::list<IRCodePtr> &ir_l
         break;
       }
       case IROp::RET: {
-        if (ir->a0()->is_imm()) {
-          asmcode_vec.push_back(build_string("\tli a0, ", ir->a0()->imm()));
+        if (ir->a0().is_imm()) {
+          asmcode_vec.push_back(build_string("\tli a0, ", ir->a0().imm()));
         } else {  // 是一个寄存器号
-          asmcode_vec.push_back(build_string("\tmv a0, x", ir->a0()->var().num()));
+          asmcode_vec.push_back(build_string("\tmv a0, x", ir->a0().var().num()));
         }
         asmcode_vec.push_back(build_string("\tj ", cur_func_name_, "_epilogue"));
         break;
       }
       case IROp::MOV: {
+        if (ir->a1().is_imm()) {
+          asmcode_vec.push_back(build_string("\tli x", ir->a0().var().num(), ", ", ir->a1().imm()));
+          break;
+        }
         int a1_reg = get_reg_num(ir->a1(), reg_t0);
-        asmcode_vec.push_back(build_string("\tmv x", ir->a0()->var().num(), " , x", a1_reg));
+        asmcode_vec.push_back(build_string("\tmv x", ir->a0().var().num(), " , x", a1_reg));
         break;
       }
       case IROp::NEG: {
-        asmcode_vec.push_back(build_string("\tneg x", ir->a0()->var().num(), " ,x", ir->a1()->var().num()));
+        asmcode_vec.push_back(build_string("\tneg x", ir->a0().var().num(), " ,x", ir->a1().var().num()));
         break;
       }
       case IROp::NOT: {
-        asmcode_vec.push_back(build_string("\tnot x", ir->a0()->var().num(), " ,x", ir->a1()->var().num()));
+        asmcode_vec.push_back(build_string("\tnot x", ir->a0().var().num(), " ,x", ir->a1().var().num()));
         break;
       }
       case IROp::LNOT: {
-        asmcode_vec.push_back(build_string("\tseqz x", ir->a0()->var().num(), " ,x", ir->a1()->var().num()));
+        asmcode_vec.push_back(build_string("\tseqz x", ir->a0().var().num(), " ,x", ir->a1().var().num()));
         break;
       }
       case IROp::LABEL: {
-        asmcode_vec.push_back(build_string(".L", ir->a0()->imm()));
+        asmcode_vec.push_back(build_string(".L", ir->a0().imm()));
         break;
       }
       case IROp::MUL:
@@ -101,7 +177,7 @@ std::vector<std::string> ASMGenerator::generate(const std::list<IRCodePtr> &ir_l
       case IROp::SUB:
       case IROp::LT:
       case IROp::GT: {
-        int a0_reg = ir->a0()->var().num();
+        int a0_reg = ir->a0().var().num();
         int a1_reg = get_reg_num(ir->a1(), reg_t0);
         int a2_reg = get_reg_num(ir->a2(), reg_t1);
         asmcode_vec.push_back(build_string("\t", op_to_asm(ir->op()),
@@ -111,7 +187,7 @@ std::vector<std::string> ASMGenerator::generate(const std::list<IRCodePtr> &ir_l
         break;
       }
       case IROp::LE: {
-        int a0_reg = ir->a0()->var().num();
+        int a0_reg = ir->a0().var().num();
         int a1_reg = get_reg_num(ir->a1(), reg_t0);
         int a2_reg = get_reg_num(ir->a2(), reg_t1);
         asmcode_vec.push_back(build_string("\tsgt x", a0_reg,
@@ -123,7 +199,7 @@ std::vector<std::string> ASMGenerator::generate(const std::list<IRCodePtr> &ir_l
         break;
       }
       case IROp::GE: {
-        int a0_reg = ir->a0()->var().num();
+        int a0_reg = ir->a0().var().num();
         int a1_reg = get_reg_num(ir->a1(), reg_t0);
         int a2_reg = get_reg_num(ir->a2(), reg_t1);
         asmcode_vec.push_back(build_string("\t slt x", a0_reg,
@@ -135,7 +211,7 @@ std::vector<std::string> ASMGenerator::generate(const std::list<IRCodePtr> &ir_l
         break;
       }
       case IROp::EQ: {
-        int a0_reg = ir->a0()->var().num();
+        int a0_reg = ir->a0().var().num();
         int a1_reg = get_reg_num(ir->a1(), reg_t0);
         int a2_reg = get_reg_num(ir->a2(), reg_t1);
         asmcode_vec.push_back(build_string("\tsub x", a0_reg,
@@ -146,7 +222,7 @@ std::vector<std::string> ASMGenerator::generate(const std::list<IRCodePtr> &ir_l
         break;
       }
       case IROp::NE: {
-        int a0_reg = ir->a0()->var().num();
+        int a0_reg = ir->a0().var().num();
         int a1_reg = get_reg_num(ir->a1(), reg_t0);
         int a2_reg = get_reg_num(ir->a2(), reg_t1);
         asmcode_vec.push_back(build_string("\tsub x", a0_reg,
@@ -157,7 +233,7 @@ std::vector<std::string> ASMGenerator::generate(const std::list<IRCodePtr> &ir_l
         break;
       }
       case IROp::LAND: {
-        int a0_reg = ir->a0()->var().num();
+        int a0_reg = ir->a0().var().num();
         int a1_reg = get_reg_num(ir->a1(), reg_t0);
         int a2_reg = get_reg_num(ir->a2(), reg_t1);
         asmcode_vec.push_back(build_string("\tsnez x", a0_reg,
@@ -173,7 +249,7 @@ std::vector<std::string> ASMGenerator::generate(const std::list<IRCodePtr> &ir_l
         break;
       }
       case IROp::LOR: {
-        int a0_reg = ir->a0()->var().num();
+        int a0_reg = ir->a0().var().num();
         int a1_reg = get_reg_num(ir->a1(), reg_t0);
         int a2_reg = get_reg_num(ir->a2(), reg_t1);
         asmcode_vec.push_back(build_string("\tor x", a0_reg,
@@ -184,40 +260,63 @@ std::vector<std::string> ASMGenerator::generate(const std::list<IRCodePtr> &ir_l
         break;
       }
       case IROp::JMP: {
-        asmcode_vec.push_back(build_string("\tj .L", ir->a0()->imm()));
+        asmcode_vec.push_back(build_string("\tj .L", ir->a0().imm()));
         break;
       }
-      case IROp::BEQZ: {
+      case IROp::BEQZ:
+      case IROp::BNEZ: {
         int a0_reg = get_reg_num(ir->a0(), reg_t0);
-        asmcode_vec.push_back(build_string("\tbeqz x", a0_reg, ", .L", ir->a1()->imm()));
+        asmcode_vec.push_back(build_string("\t", op_to_asm(ir->op()), " x", a0_reg, ", .L", ir->a1().imm()));
+        break;
+      }
+      case IROp::BEQ:
+      case IROp::BNE:
+      case IROp::BLT:
+      case IROp::BGE: {
+        int a0_reg = get_reg_num_or_x0(ir->a0(), reg_t0);
+        int a1_reg = get_reg_num_or_x0(ir->a1(), reg_t1);
+        asmcode_vec.push_back(build_string("\t", op_to_asm(ir->op()),
+                                           " x", a0_reg,
+                                           ", x", a1_reg,
+                                           ", .L", ir->a2().imm()));
+        break;
+      }
+      case IROp::BGT:
+      case IROp::BLE: {  // 交换操作数，用blt和bge实现
+        int a0_reg = get_reg_num_or_x0(ir->a0(), reg_t0);
+        int a1_reg = get_reg_num_or_x0(ir->a1(), reg_t1);
+        asmcode_vec.push_back(build_string(ir->op() == IROp::BGT ? "\tblt" : "\tbge",
+                                           " x", a1_reg,
+                                           ", x", a0_reg,
+                                           ", .L", ir->a2().imm()));
         break;
       }
       case IROp::PARAM: {
         asmcode_vec.push_back(build_string("\taddi sp, sp, -4"));
-        asmcode_vec.push_back(build_string("\tsw x", ir->a0()->var().num(), ", 0(sp)"));
+        asmcode_vec.push_back(build_string("\tsw x", ir->a0().var().num(), ", 0(sp)"));
         ++cur_param_num_;
         break;
       }
       case IROp::CALL: {
-        asmcode_vec.push_back(build_string("\tcall ", ir->a1()->name()));
-        asmcode_vec.push_back(build_string("\tmv x", ir->a0()->var().num(), ", a0"));
+        asmcode_vec.push_back(build_string("\tcall ", ir->a1().name()));
+        asmcode_vec.push_back(build_string("\tmv x", ir->a0().var().num(), ", a0"));
         asmcode_vec.push_back(build_string("\taddi sp, sp, ", cur_param_num_ * 4));
         cur_param_num_ = 0;
         break;
       }
       case IROp::LA: {
-        asmcode_vec.push_back(build_string("\tla x", ir->a0()->var().num(), ", ", ir->a1()->name()));
+        asmcode_vec.push_back(build_string("\tla x", ir->a0().var().num(), ", ", ir->a1().name()));
         break;
       }
       case IROp::LOAD: {
-        int a0_reg = ir->a0()->var().num();
-        int a1_reg = ir->a1()->var().num();
-        if (ir->a2()->is_imm()) {
+        int a0_reg = ir->a0().var().num();
+        int a1_reg = ir->a1().var().num();
+        if (ir->a2().is_imm()) {
           asmcode_vec.push_back(build_string("\tlw x", a0_reg,
-                                             ", ", ir->a2()->imm(),
+                                             ", ", ir->a2().imm(),
                                              "(x", a1_reg, ")"));
         } else {  // 按照目前的中间代码翻译，else分支不会被执行
-          int a2_reg = ir->a2()->var().num();
+          int a2_reg = ir->a2().var().num();
           asmcode_vec.push_back(build_string("\tadd x", reg_t0,
                                              ", x", a1_reg,
                                              ", x", a2_reg));
@@ -227,14 +326,14 @@ std::vector<std::string> ASMGenerator::generate(const std::list<IRCodePtr> &ir_l
         break;
       }
       case IROp::STORE: {
-        int a0_reg = ir->a0()->var().num();
-        int a1_reg = ir->a1()->var().num();
-        if (ir->a2()->is_imm()) {
+        int a0_reg = get_reg_num_or_x0(ir->a0(), reg_t1);
+        int a1_reg = ir->a1().var().num();
+        if (ir->a2().is_imm()) {
           asmcode_vec.push_back(build_string("\tsw x", a0_reg,
-                                             ", ", ir->a2()->imm(),
+                                             ", ", ir->a2().imm(),
                                              "(x", a1_reg, ")"));
         } else {  // 按照目前的中间代码翻译，else分支不会被执行
-          int a2_reg = ir->a2()->var().num();
+          int a2_reg = ir->a2().var().num();
           asmcode_vec.push_back(build_string("\tadd x", reg_t0,
                                              ", x", a1_reg,
                                              ", x", a2_reg));
@@ -246,34 +345,40 @@ std::vector<std::string> ASMGenerator::generate(const std::list<IRCodePtr> &ir_l
       case IROp::ALLOC: assert(false);
       case IROp::GBSS: {
         asmcode_vec.push_back(build_string(".bss"));
-        asmcode_vec.push_back(build_string(".global ", ir->a0()->name()));
-        asmcode_vec.push_back(build_string(ir->a0()->name(), ":"));
-        asmcode_vec.push_back(build_string("\t.space ", ir->a1()->imm()));
+        asmcode_vec.push_back(build_string(".global ", ir->a0().name()));
+        asmcode_vec.push_back(build_string(ir->a0().name(), ":"));
+        asmcode_vec.push_back(build_string("\t.space ", ir->a1().imm()));
         break;
       }
       case IROp::GINI: {
         asmcode_vec.push_back(build_string(".data"));
-        asmcode_vec.push_back(build_string(".global ", ir->a0()->name()));
-        asmcode_vec.push_back(build_string(ir->a0()->name(), ":"));
-        asmcode_vec.push_back(build_string("\t.word ", ir->a1()->imm()));
+        asmcode_vec.push_back(build_string(".global ", ir->a0().name()));
+        asmcode_vec.push_back(build_string(ir->a0().name(), ":"));
+        asmcode_vec.push_back(build_string("\t.word ", ir->a1().imm()));
+        break;
+      }
+      case IROp::LOC: {
+        if (!source_file_.empty()) {
+          asmcode_vec.push_back(build_string("\t.loc 1 ", ir->a0().imm(), " ", ir->a1().imm()));
+        }
         break;
       }
       case IROp::LOADFP: {
-        int a0_reg = ir->a0()->var().num();
+        int a0_reg = ir->a0().var().num();
         asmcode_vec.push_back(build_string("\tlw x", a0_reg,
-                                           ", ", ir->a1()->imm(), "(fp)"));
+                                           ", ", ir->a1().imm(), "(fp)"));
         break;
       }
       case IROp::STOREFP: {
-        int a0_reg = ir->a0()->var().num();
+        int a0_reg = ir->a0().var().num();
         asmcode_vec.push_back(build_string("\tsw x", a0_reg,
-                                           ", ", ir->a1()->imm(), "(fp)"));
+                                           ", ", ir->a1().imm(), "(fp)"));
         break;
       }
       case IROp::LARRAY: {
-        int a0_reg = ir->a0()->var().num();
+        int a0_reg = ir->a0().var().num();
         asmcode_vec.push_back(build_string("\tlw x", a0_reg,
-                                           ", ", -(ir->a1()->imm() + cur_array_offset_), "(fp)"));
+                                           ", ", -(ir->a1().imm() + cur_array_offset_), "(fp)"));
         break;
       }
     }
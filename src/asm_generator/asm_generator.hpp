@@ -9,17 +9,20 @@
 class ASMGenerator {
  public:
   ASMGenerator() = default;
+  // source_file不为空时生成.file指令，IR中的LOC指令被翻译为.loc指令
+  explicit ASMGenerator(std::string source_file) : source_file_(std::move(source_file)) {}
   ~ASMGenerator() = default;
-  std::vector<std::string> generate(const std::list<IRCodePtr> &ir_list);
+  std::vector<std::string> generate(const IRList &ir_list);
  private:
-  std::string cur_func_name_;  // 当前正在翻译的函数
+  Symbol cur_func_name_;  // 当前正在翻译的函数
   int cur_fp_sp_diff_{0};      // 当前函数fp-sp的大小
   int cur_array_offset_{0};    // 当前函数局部数组开始地址距离fp的offset
   int cur_param_num_{0};
+  std::string source_file_;
 };
 
-inline std::vector<std::string> generate(IRBuilderPtr &ir_builder) {
-  ASMGenerator generator;
+inline std::vector<std::string> generate(IRBuilderPtr &ir_builder, const std::string &source_file = "") {
+  ASMGenerator generator(source_file);
   return generator.generate(ir_builder->ircode_list());
 }
 
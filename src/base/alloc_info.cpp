@@ -31,10 +31,11 @@ int AllocInfo::find_var_in_stack(const IRVar &var) const {
   return -(result->second + kSavedRegisterSize) - 4;
 }
 
-void AllocInfo::clear_dead_reg(const std::set<IRVar> &live_variables) {
+void AllocInfo::clear_dead_reg(const std::map<IRVar, int> &live_end, int pos) {
   for (auto &reg : registers_) {
     if (reg.used()) {
-      if (!live_variables.count(reg.var())) { // 不在活跃变量中
+      auto it = live_end.find(reg.var());
+      if (it == live_end.end() || it->second < pos) { // 之后不再活跃
         reg.clear();
       }
     }
@@ -43,8 +44,7 @@ void AllocInfo::clear_dead_reg(const std::set<IRVar> &live_variables) {
 
 std::pair<int, int> AllocInfo::spill_var(const IRVar &new_var) {
   // TODO: 可以采取更好的溢出策略
-  static int i = 0;
-  ++i;
+  int i = ++spill_index_;
   IRVar var = registers_[i].var();
   spill_map_[var] = spill_size_;
   spill_size_ += 4;
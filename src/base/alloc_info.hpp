@@ -65,7 +65,9 @@ class AllocInfo {
   [[nodiscard]] bool has_free_register() const; // 有空闲的寄存器
   int alloc_for_var(const IRVar &var);  // 为变量分配寄存器，并返回分配的寄存器号
   [[nodiscard]] int find_var_in_stack(const IRVar &var) const; // 从栈中查找变量，返回相对fp的偏移地址
-  void clear_dead_reg(const std::set<IRVar> &live_variables);
+  [[nodiscard]] bool is_in_stack(const IRVar &var) const { return spill_map_.count(var) != 0; }  // 变量已经被溢出到栈中
+  // 释放不再活跃的变量占用的寄存器，live_end为变量最后一次活跃的位置，在pos之前结束的变量才是不再活跃的
+  void clear_dead_reg(const std::map<IRVar, int> &live_end, int pos);
   std::pair<int, int> spill_var(const IRVar &new_var);
   int alloc_tmp_reg() {
     if (!t0_used_) {
@@ -98,6 +100,7 @@ class AllocInfo {
   static const int kSavedRegisterSize = 8;  // 只需保存fp寄存器和ra寄存器, 一个寄存器4字节
   std::vector<Register> registers_;
   int spill_size_{0};
+  int spill_index_{0};  // 上一次溢出的寄存器下标
   int array_size_{0};
   std::map<IRVar, int> spill_map_;
   bool t0_used_{false};
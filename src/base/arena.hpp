@@ -0,0 +1,90 @@
+#ifndef SCOMPILER_SRC_BASE_ARENA_HPP_
+#define SCOMPILER_SRC_BASE_ARENA_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+template<typename T>
+using ArenaVector = std::pmr::vector<T>;
+
+// 线性分配的内存池，AST节点都分配在其中，Arena析构时一次性释放所有内存块
+// Arena中的对象不会被析构，所以它们的成员也只能使用Arena中的内存，例如ArenaVector<T> vec(&arena)和string()复制的字符串
+class Arena : public std::pmr::memory_resource {
+ public:
+  Arena() = default;
+  ~Arena() override = default;
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  template<typename T, typename... Args>
+  T *make(Args &&... args) {
+    ++object_count_;
+    return new(allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+  // 将字符串复制到Arena中
+  std::string_view string(std::string_view str) {
+    auto *data = static_cast<char *>(allocate(str.size(), 1));
+    std::memcpy(data, str.data(), str.size());
+    return {data, str.size()};
+  }
+
+  // 创建一个与本Arena同时释放的子Arena，供其他线程分配对象(Arena本身不是线程安全的)
+  // 只能在启动使用子Arena的线程之前调用
+  Arena &fork() {
+    child_vec_.push_back(std::make_unique<Arena>());
+    return *child_vec_.back();
+  }
+
+  // 包括所有子Arena
+  [[nodiscard]] std::size_t object_count() const {
+    auto count = object_count_;
+    for (const auto &child : child_vec_) count += child->object_count();
+    return count;
+  }
+  [[nodiscard]] std::size_t allocated_bytes() const {
+    auto bytes = allocated_bytes_;
+    for (const auto &child : child_vec_) bytes += child->allocated_bytes();
+    return bytes;
+  }
+
+ private:
+  static constexpr std::size_t kMinBlockSize = 64 * 1024;
+  static constexpr std::size_t kMaxBlockSize = 4 * 1024 * 1024;
+
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    auto cur = (reinterpret_cast<std::uintptr_t>(cur_) + alignment - 1) & ~(alignment - 1);
+    if (cur + bytes > reinterpret_cast<std::uintptr_t>(end_)) {
+      // 内存块的大小逐渐翻倍(最大4MB)，减少申请内存块的次数
+      block_size_ = std::min(block_size_ * 2, kMaxBlockSize);
+      auto size = std::max(block_size_, bytes + alignment);
+      block_vec_.emplace_back(new char[size]);
+      cur_ = block_vec_.back().get();
+      end_ = cur_ + size;
+      cur = (reinterpret_cast<std::uintptr_t>(cur_) + alignment - 1) & ~(alignment - 1);
+    }
+    allocated_bytes_ += bytes;
+    cur_ = reinterpret_cast<char *>(cur + bytes);
+    return reinterpret_cast<void *>(cur);
+  }
+  void do_deallocate(void *, std::size_t, std::size_t) override {}  // 只在Arena析构时统一释放
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+
+  std::vector<std::unique_ptr<char[]>> block_vec_;
+  std::vector<std::unique_ptr<Arena>> child_vec_;
+  char *cur_{nullptr};
+  char *end_{nullptr};
+  std::size_t block_size_{kMinBlockSize / 2};
+  std::size_t object_count_{0};
+  std::size_t allocated_bytes_{0};
+};
+
+#endif //SCOMPILER_SRC_BASE_ARENA_HPP_
@@ -1,286 +1,214 @@
 #ifndef SCOMPILER_SRC_BASE_AST_HPP_
 #define SCOMPILER_SRC_BASE_AST_HPP_
 
+#include "arena.hpp"
 #include "token.hpp"
+#include "source_location.hpp"
 #include "variable.hpp"
 #include "support_type.hpp"
 
+#include <optional>
 #include <utility>
-#include <vector>
-#include <memory>
+#include <variant>
 
-class Expression;
-using ExpressionPtr = std::shared_ptr<Expression>;
-
-class Primary {
+// 表达式节点由优先级爬升(Pratt)分析得到：只有出现运算符时才产生节点，括号也不单独产生节点
+// 所有表达式节点都继承自Expression，通过kind()区分具体的类型
+// offset：Literal、Ref、Call为其第一个token的位置，其余节点为运算符的位置
+class Expression : public SourceNode {
  public:
-  using value_type = std::variant<int, ExpressionPtr, std::string>;
-  explicit Primary(value_type v) : value_(std::move(v)) {}
-  ~Primary() = default;
-
-  value_type &value() { return value_; }
+  enum class Kind {
+    Literal,
+    Ref,
+    Call,
+    Index,
+    Unary,
+    Binary,
+    Conditional,
+    Assign,
+  };
+  [[nodiscard]] Kind kind() const { return kind_; }
+ protected:
+  explicit Expression(Kind kind) : kind_(kind) {}
+  ~Expression() = default;
  private:
-  value_type value_;
+  Kind kind_;
 };
-using PrimaryPtr = std::shared_ptr<Primary>;
+using ExpressionPtr = Expression *;
 
-class ExpressionList;
-using ExpressionListPtr = std::shared_ptr<ExpressionList>;
-
-class FuncCall {
+// 整数字面量
+class Literal : public Expression {
  public:
-  FuncCall(std::string &func_name, ExpressionListPtr exp_list)
-      : func_name_(func_name), expression_list_(std::move(exp_list)) {}
-  ~FuncCall() = default;
+  explicit Literal(int value) : Expression(Kind::Literal), value_(value) {}
+  ~Literal() = default;
 
-  std::string &func_name() { return func_name_; }
-  ExpressionListPtr &expression_list() { return expression_list_; }
+  int &value() { return value_; }
  private:
-  std::string func_name_;
-  ExpressionListPtr expression_list_;
+  int value_;
 };
-using FuncCallPtr = std::shared_ptr<FuncCall>;
+using LiteralPtr = Literal *;
 
-// 因为当前不支持指针，所以其实Array解析的时候postfix只能递归到primary,而不能递归到func call，不过为了符合文法，还是支持该语法
-class Array {
+// 变量名，checker将其绑定到对应的变量，之后的阶段不再需要按名字查找
+class Ref : public Expression {
  public:
-  using value_type = std::variant<FuncCallPtr, PrimaryPtr>;
-  Array(value_type name, std::vector<ExpressionPtr> expressions)
-      : name_(std::move(name)),
-        expression_vec_(std::move(expressions)) {}
-  ~Array() = default;
-
-  value_type &name() { return name_; }
-  std::vector<ExpressionPtr> &expression_vec() { return expression_vec_; }
+  explicit Ref(Symbol name) : Expression(Kind::Ref), name_(name) {}
+  ~Ref() = default;
+
+  Symbol &name() { return name_; }
+  VariablePtr &variable() { return variable_; }
  private:
-  value_type name_;
-  std::vector<ExpressionPtr> expression_vec_;
+  Symbol name_;
+  VariablePtr variable_{nullptr};  // 由checker设置
 };
-using ArrayPtr = std::shared_ptr<Array>;
+using RefPtr = Ref *;
 
-class Postfix {
+class ExpressionList {
  public:
-  using value_type = std::variant<PrimaryPtr, FuncCallPtr, ArrayPtr>;
-  explicit Postfix(value_type p) : value_(std::move(p)) {}
-  ~Postfix() = default;
+  ExpressionList() = default;
+  explicit ExpressionList(ArenaVector<ExpressionPtr> exps)
+      : expression_vec_(std::move(exps)) {}
+  ~ExpressionList() = default;
 
-  value_type &value() { return value_; }
+  ArenaVector<ExpressionPtr> &expression_vec() { return expression_vec_; }
  private:
-  value_type value_;
+  ArenaVector<ExpressionPtr> expression_vec_;
 };
-using PostfixPtr = std::shared_ptr<Postfix>;
+using ExpressionListPtr = ExpressionList *;
+
+class Function;
 
-class Unary {
-  using UnaryPtr = std::shared_ptr<Unary>;
-  using value_type = std::variant<PostfixPtr, UnaryPtr>;
+// identifier '(' expression_list ')'
+class Call : public Expression {
  public:
-  enum class Op {
-    Sub,
-    Not,
-    Lnot,
-  };
-  explicit Unary(PostfixPtr value) : op_(Op::Sub), value_(std::move(value)) {}
-  Unary(Op op, UnaryPtr value)
-      : op_(op), value_(std::move(value)) {}
-  ~Unary() = default;
+  Call(Symbol func_name, ExpressionListPtr exp_list)
+      : Expression(Kind::Call), func_name_(func_name), expression_list_(exp_list) {}
+  ~Call() = default;
 
-  Op &op() { return op_; }
-  value_type &value() { return value_; }
+  Symbol &func_name() { return func_name_; }
+  ExpressionListPtr &expression_list() { return expression_list_; }
+  // 被调用函数的第一个声明或定义，由checker设置
+  Function *&function() { return function_; }
  private:
-  Op op_;
-  value_type value_;
+  Symbol func_name_;
+  ExpressionListPtr expression_list_;
+  Function *function_{nullptr};
 };
-using UnaryPtr = std::shared_ptr<Unary>;
+using CallPtr = Call *;
 
-class Multiplicative {
-  using MultiplicativePtr = std::shared_ptr<Multiplicative>;
+// base ('[' expression ']')+，多维数组的所有下标放在同一个节点中
+// 因为当前不支持指针，所以base其实只能是Ref，不过为了符合文法，也允许base为Call
+class Index : public Expression {
  public:
-  enum class Op {
-    Times,
-    Divide,
-    Mod,
-  };
-  explicit Multiplicative(UnaryPtr right) : left_(nullptr), op_(Op::Divide), right_(std::move(right)) {}
-  Multiplicative(MultiplicativePtr left, Op op, UnaryPtr right)
-      : left_(std::move(left)), op_(op), right_(std::move(right)) {}
-  ~Multiplicative() = default;
+  Index(ExpressionPtr base, ArenaVector<ExpressionPtr> index_vec)
+      : Expression(Kind::Index), base_(base), index_vec_(std::move(index_vec)) {}
+  ~Index() = default;
 
-  MultiplicativePtr &left() { return left_; }
-  Op &op() { return op_; }
-  UnaryPtr &right() { return right_; }
+  ExpressionPtr &base() { return base_; }
+  ArenaVector<ExpressionPtr> &index_vec() { return index_vec_; }
  private:
-  MultiplicativePtr left_;
-  Op op_;
-  UnaryPtr right_;
+  ExpressionPtr base_;
+  ArenaVector<ExpressionPtr> index_vec_;
 };
-using MultiplicativePtr = std::shared_ptr<Multiplicative>;
+using IndexPtr = Index *;
 
-class Additive {
-  using AdditivePtr = std::shared_ptr<Additive>;
+class UnaryExpr : public Expression {
  public:
   enum class Op {
-    Add,
     Sub,
+    Not,
+    Lnot,
   };
-  explicit Additive(MultiplicativePtr right) : left_(nullptr), op_(Op::Add), right_(std::move(right)) {}
-  Additive(AdditivePtr left, Op op, MultiplicativePtr right)
-      : left_(std::move(left)), op_(op), right_(std::move(right)) {}
-  ~Additive() = default;
+  UnaryExpr(Op op, ExpressionPtr operand) : Expression(Kind::Unary), op_(op), operand_(operand) {}
+  ~UnaryExpr() = default;
 
-  AdditivePtr &left() { return left_; }
   Op &op() { return op_; }
-  MultiplicativePtr &right() { return right_; }
+  ExpressionPtr &operand() { return operand_; }
  private:
-  AdditivePtr left_;
   Op op_;
-  MultiplicativePtr right_;
+  ExpressionPtr operand_;
 };
-using AdditivePtr = std::shared_ptr<Additive>;
-
-class Relational {
-  using RelationalPtr = std::shared_ptr<Relational>;
+using UnaryExprPtr = UnaryExpr *;
+
+// 字面量和取负的字面量(例如-5，文法中是作用于字面量的一元减)是常量，返回其值，其他表达式返回空
+// 取负按补码进行，与NEG指令的结果一致，-2147483648得到INT_MIN
+inline std::optional<int> constant_value(ExpressionPtr exp) {
+  if (exp->kind() == Expression::Kind::Literal) {
+    return static_cast<LiteralPtr>(exp)->value();
+  }
+  if (exp->kind() == Expression::Kind::Unary) {
+    auto unary_expr = static_cast<UnaryExprPtr>(exp);
+    if (unary_expr->op() == UnaryExpr::Op::Sub && unary_expr->operand()->kind() == Expression::Kind::Literal) {
+      auto value = static_cast<LiteralPtr>(unary_expr->operand())->value();
+      return static_cast<int>(0u - static_cast<unsigned>(value));
+    }
+  }
+  return std::nullopt;
+}
+
+class BinaryExpr : public Expression {
  public:
+  // 按优先级从高到低排列
   enum class Op {
+    Times,
+    Divide,
+    Mod,
+    Add,
+    Sub,
     Less,
     Greater,
     Le,
     Ge,
-  };
-  explicit Relational(AdditivePtr right) : left_(nullptr), op_(Op::Ge), right_(std::move(right)) {}
-  Relational(RelationalPtr left, Op op, AdditivePtr right)
-      : left_(std::move(left)), op_(op), right_(std::move(right)) {}
-  ~Relational() = default;
-
-  RelationalPtr &left() { return left_; }
-  Op &op() { return op_; }
-  AdditivePtr &right() { return right_; }
- private:
-  RelationalPtr left_;
-  Op op_;
-  AdditivePtr right_;
-};
-using RelationalPtr = std::shared_ptr<Relational>;
-
-class Equality {
-  using EqualityPtr = std::shared_ptr<Equality>;
- public:
-  enum class Op {
     Equal,
     Nequal,
+    Land,
+    Lor,
   };
-  explicit Equality(RelationalPtr right) : left_(nullptr), op_(Op::Equal), right_(std::move(right)) {}
-  Equality(EqualityPtr left, Op op, RelationalPtr right)
-      : left_(std::move(left)), op_(op), right_(std::move(right)) {}
-  ~Equality() = default;
+  BinaryExpr(ExpressionPtr left, Op op, ExpressionPtr right)
+      : Expression(Kind::Binary), left_(left), op_(op), right_(right) {}
+  ~BinaryExpr() = default;
 
-  EqualityPtr &left() { return left_; }
+  ExpressionPtr &left() { return left_; }
   Op &op() { return op_; }
-  RelationalPtr &right() { return right_; }
+  ExpressionPtr &right() { return right_; }
  private:
-  EqualityPtr left_;
+  ExpressionPtr left_;
   Op op_;
-  RelationalPtr right_;
-};
-using EqualityPtr = std::shared_ptr<Equality>;
-
-class LogicalAnd {
-  using LogicalAndPtr = std::shared_ptr<LogicalAnd>;
- public:
-  explicit LogicalAnd(EqualityPtr right) : left_(nullptr), right_(std::move(right)) {}
-  LogicalAnd(LogicalAndPtr left, EqualityPtr right)
-      : left_(std::move(left)), right_(std::move(right)) {}
-  ~LogicalAnd() = default;
-
-  LogicalAndPtr &left() { return left_; }
-  EqualityPtr &right() { return right_; }
- private:
-  LogicalAndPtr left_;
-  EqualityPtr right_;
+  ExpressionPtr right_;
 };
-using LogicalAndPtr = std::shared_ptr<LogicalAnd>;
+using BinaryExprPtr = BinaryExpr *;
 
-class LogicalOr {
-  using LogicalOrPtr = std::shared_ptr<LogicalOr>;
+// cond '?' cond_true ':' cond_false
+class ConditionalExpr : public Expression {
  public:
-  explicit LogicalOr(LogicalAndPtr right) : left_(nullptr), right_(std::move(right)) {}
-  LogicalOr(LogicalOrPtr left, LogicalAndPtr right)
-      : left_(std::move(left)), right_(std::move(right)) {}
-  ~LogicalOr() = default;
+  ConditionalExpr(ExpressionPtr cond, ExpressionPtr cond_true, ExpressionPtr cond_false)
+      : Expression(Kind::Conditional), cond_(cond), cond_true_(cond_true), cond_false_(cond_false) {}
+  ~ConditionalExpr() = default;
 
-  LogicalOrPtr &left() { return left_; }
-  LogicalAndPtr &right() { return right_; }
- private:
-  LogicalOrPtr left_; // nullptr for only logical_and
-  LogicalAndPtr right_;
-};
-using LogicalOrPtr = std::shared_ptr<LogicalOr>;
-
-class Conditional {
-  using ConditionalPtr = std::shared_ptr<Conditional>;
- public:
-  Conditional(LogicalOrPtr cond, ExpressionPtr cond_true, ConditionalPtr cond_false)
-      : cond_(std::move(cond)), cond_true_(std::move(cond_true)), cond_false_(std::move(cond_false)) {}
-  ~Conditional() = default;
-  LogicalOrPtr &cond() { return cond_; }
+  ExpressionPtr &cond() { return cond_; }
   ExpressionPtr &cond_true() { return cond_true_; }
-  ConditionalPtr &cond_false() { return cond_false_; }
+  ExpressionPtr &cond_false() { return cond_false_; }
  private:
-  LogicalOrPtr cond_;
+  ExpressionPtr cond_;
   ExpressionPtr cond_true_;
-  ConditionalPtr cond_false_;
+  ExpressionPtr cond_false_;
 };
-using ConditionalPtr = std::shared_ptr<Conditional>;
+using ConditionalExprPtr = ConditionalExpr *;
 
 // unary '=' expression
-class AssignExp {
+class AssignExpr : public Expression {
  public:
-  AssignExp(UnaryPtr left, ExpressionPtr right)
-      : left_(std::move(left)), right_(std::move(right)) {}
-  ~AssignExp() = default;
+  AssignExpr(ExpressionPtr left, ExpressionPtr right)
+      : Expression(Kind::Assign), left_(left), right_(right) {}
+  ~AssignExpr() = default;
 
-  UnaryPtr &left() { return left_; }
+  ExpressionPtr &left() { return left_; }
   ExpressionPtr &right() { return right_; }
  private:
-  UnaryPtr left_;
+  ExpressionPtr left_;
   ExpressionPtr right_;
 };
-using AssignExpPtr = std::shared_ptr<AssignExp>;
+using AssignExprPtr = AssignExpr *;
 
-class Assignment {
- public:
-  using value_type = std::variant<ConditionalPtr, AssignExpPtr>;
-  explicit Assignment(value_type v) : value_(std::move(v)) {}
-  ~Assignment() = default;
-
-  value_type &value() { return value_; }
- private:
-  value_type value_;
-};
-using AssignmentPtr = std::shared_ptr<Assignment>;
-
-class Expression {
- public:
-  explicit Expression(AssignmentPtr assignment)
-      : assignment_(std::move(assignment)) {}
-  ~Expression() = default;
-  AssignmentPtr &assignment() { return assignment_; }
- private:
-  AssignmentPtr assignment_;
-};
-
-class ExpressionList {
- public:
-  ExpressionList() = default;
-  explicit ExpressionList(std::vector<ExpressionPtr> exps)
-      : expression_vec_(std::move(exps)) {}
-  ~ExpressionList() = default;
-
-  std::vector<ExpressionPtr> &expression_vec() { return expression_vec_; }
- private:
-  std::vector<ExpressionPtr> expression_vec_;
-};
-
-class Declaration {
+class Declaration : public SourceNode {
  public:
   Declaration(VariablePtr var, ExpressionPtr init_exp)
       : var_(std::move(var)), init_exp_(std::move(init_exp)) {}
@@ -291,12 +219,12 @@ class Declaration {
   VariablePtr var_;
   ExpressionPtr init_exp_;  // nullptr for not initialized
 };
-using DeclarationPtr = std::shared_ptr<Declaration>;
+using DeclarationPtr = Declaration *;
 
 class Statement;
-using StatementPtr = std::shared_ptr<Statement>;
+using StatementPtr = Statement *;
 class CompoundStatement;
-using CompoundStatementPtr = std::shared_ptr<CompoundStatement>;
+using CompoundStatementPtr = CompoundStatement *;
 
 // 'return' expression ';'
 class ReturnStatement {
@@ -405,21 +333,21 @@ class DoStatement {
   ExpressionPtr cond_exp_;
 };
 // 'break' ';'
-class BreakStatement {};
+class BreakStatement : public SourceNode {};
 // 'continue' ';'
-class ContinueStatement {};
-
-using ReturnStatementPtr = std::shared_ptr<ReturnStatement>;
-using ExpStatementPtr = std::shared_ptr<ExpStatement>;
-using IfStatementPtr = std::shared_ptr<IfStatement>;
-using ForExpStatementPtr = std::shared_ptr<ForExpStatement>;
-using ForDecStatementPtr = std::shared_ptr<ForDecStatement>;
-using WhileStatementPtr = std::shared_ptr<WhileStatement>;
-using DoStatementPtr = std::shared_ptr<DoStatement>;
-using BreakStatementPtr = std::shared_ptr<BreakStatement>;
-using ContinueStatementPtr = std::shared_ptr<ContinueStatement>;
-
-class Statement {
+class ContinueStatement : public SourceNode {};
+
+using ReturnStatementPtr = ReturnStatement *;
+using ExpStatementPtr = ExpStatement *;
+using IfStatementPtr = IfStatement *;
+using ForExpStatementPtr = ForExpStatement *;
+using ForDecStatementPtr = ForDecStatement *;
+using WhileStatementPtr = WhileStatement *;
+using DoStatementPtr = DoStatement *;
+using BreakStatementPtr = BreakStatement *;
+using ContinueStatementPtr = ContinueStatement *;
+
+class Statement : public SourceNode {
  public:
   using value_type = std::variant<ReturnStatementPtr,
                                   ExpStatementPtr,
@@ -450,28 +378,28 @@ class BlockItem {
  private:
   value_type value_;
 };
-using BlockItemPtr = std::shared_ptr<BlockItem>;
+using BlockItemPtr = BlockItem *;
 
 class CompoundStatement {
  public:
-  explicit CompoundStatement(std::vector<BlockItemPtr> vec) : block_item_vec_(std::move(vec)) {}
+  explicit CompoundStatement(ArenaVector<BlockItemPtr> vec) : block_item_vec_(std::move(vec)) {}
   ~CompoundStatement() = default;
-  std::vector<BlockItemPtr> &block_item_vec() { return block_item_vec_; }
+  ArenaVector<BlockItemPtr> &block_item_vec() { return block_item_vec_; }
  private:
-  std::vector<BlockItemPtr> block_item_vec_;
+  ArenaVector<BlockItemPtr> block_item_vec_;
 };
-using CompoundStatementPtr = std::shared_ptr<CompoundStatement>;
+using CompoundStatementPtr = CompoundStatement *;
 
 class ParameterList {
  public:
   ParameterList() = default;
-  explicit ParameterList(std::vector<VariablePtr> vars) : variable_vec_(std::move(vars)) {}
+  explicit ParameterList(ArenaVector<VariablePtr> vars) : variable_vec_(std::move(vars)) {}
   ~ParameterList() = default;
-  std::vector<VariablePtr> &variables() { return variable_vec_; }
+  ArenaVector<VariablePtr> &variables() { return variable_vec_; }
  private:
-  std::vector<VariablePtr> variable_vec_;
+  ArenaVector<VariablePtr> variable_vec_;
 };
-using ParameterListPtr = std::shared_ptr<ParameterList>;
+using ParameterListPtr = ParameterList *;
 
 class BaseType {
  public:
@@ -485,40 +413,52 @@ class BaseType {
   SupportType type_;
 };
 
-class Function {
+class Function : public SourceNode {  // offset为函数名的位置
  public:
   Function(BaseType ret_type,
-           std::string func_name,
+           Symbol func_name,
            ParameterListPtr parameter_list,
            CompoundStatementPtr compound_statement)
       : ret_type_(ret_type),
-        func_name_(std::move(func_name)),
+        func_name_(func_name),
         parameter_list_(std::move(parameter_list)),
         compound_statement_(std::move(compound_statement)) {}
   ~Function() = default;
 
-  std::string &name() { return func_name_; }
+  Symbol &name() { return func_name_; }
   BaseType &ret_type() { return ret_type_; }
   ParameterListPtr &parameter_list() { return parameter_list_; }
   CompoundStatementPtr &compound_statement() { return compound_statement_; }
+
+  // 惰性分析时只记录函数体在TokenStream中的范围[body_begin, body_end)，见LazyParser
+  // 函数体被分析之前compound_statement为nullptr，检查和翻译时与函数声明相同
+  void set_body_range(std::size_t body_begin, std::size_t body_end) {
+    body_begin_ = body_begin;
+    body_end_ = body_end;
+  }
+  [[nodiscard]] std::size_t body_begin() const { return body_begin_; }
+  [[nodiscard]] std::size_t body_end() const { return body_end_; }
+  [[nodiscard]] bool has_lazy_body() const { return !compound_statement_ && body_end_ > body_begin_; }
  private:
   BaseType ret_type_;
-  std::string func_name_;
+  Symbol func_name_;
   ParameterListPtr parameter_list_;
   CompoundStatementPtr compound_statement_; // nullptr for declaration
+  std::size_t body_begin_{0};
+  std::size_t body_end_{0};
 };
-using FunctionPtr = std::shared_ptr<Function>;
+using FunctionPtr = Function *;
 
 class Program {
  public:
   using value_type = std::variant<FunctionPtr, DeclarationPtr>;
-  explicit Program(std::vector<value_type> vec) : func_decl_vec_(std::move(vec)) {}
+  explicit Program(ArenaVector<value_type> vec) : func_decl_vec_(std::move(vec)) {}
   ~Program() = default;
 
-  std::vector<value_type> &func_decl_vec() { return func_decl_vec_; }
+  ArenaVector<value_type> &func_decl_vec() { return func_decl_vec_; }
  private:
-  std::vector<value_type> func_decl_vec_;
+  ArenaVector<value_type> func_decl_vec_;
 };
-using ProgramPtr = std::shared_ptr<Program>;
+using ProgramPtr = Program *;
 
 #endif //SCOMPILER_SRC_BASE_AST_HPP_
@@ -1,16 +1,39 @@
 #ifndef SCOMPILER_SRC_BASE_ERROR_HPP_
 #define SCOMPILER_SRC_BASE_ERROR_HPP_
 
+#include "source_location.hpp"
+
 #include <stdexcept>
 
-class lex_error : public std::logic_error {
+// offset为出错位置在源文件中的偏移，不知道位置时为kNoOffset
+class compile_error : public std::logic_error {
+ public:
+  compile_error(const std::string &str, SourceOffset offset) : std::logic_error(str), offset_(offset) {}
+
+  [[nodiscard]] SourceOffset offset() const { return offset_; }
+ private:
+  SourceOffset offset_;
+};
+
+class lex_error : public compile_error {
+ public:
+  explicit lex_error(const std::string &str, SourceOffset offset = kNoOffset) : compile_error(str, offset) {}
+};
+
+class parse_error : public compile_error {
+ public:
+  explicit parse_error(const std::string &str, SourceOffset offset = kNoOffset) : compile_error(str, offset) {}
+};
+
+class check_error : public compile_error {
  public:
-  explicit lex_error(const std::string &str) : std::logic_error(str) {}
+  explicit check_error(const std::string &str, SourceOffset offset = kNoOffset) : compile_error(str, offset) {}
 };
 
-class check_error : public std::logic_error {
+// 读取的IR格式不对或者结构不合法
+class ir_error : public compile_error {
  public:
-  explicit check_error(const std::string &str) : std::logic_error(str) {}
+  explicit ir_error(const std::string &str, SourceOffset offset = kNoOffset) : compile_error(str, offset) {}
 };
 
 #endif //SCOMPILER_SRC_BASE_ERROR_HPP_
@@ -2,33 +2,49 @@
 #define SCOMPILER_SRC_BASE_IR_HPP_
 
 #include "ast.hpp"
+#include "arena.hpp"
 
-#include <string>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <memory>
-#include <list>
-#include <utility>
-#include <variant>
 
+// IR的操作数，直接保存在IRCode中：立即数、名字(函数名或全局变量名)或者变量，默认为空(不使用)
+// 只占8个字节，可以按值复制
 class IRAddr {
  public:
-  // int代表立即数，string代表名字，IRVar代表变量
-  using value_type = std::variant<int, std::string, IRVar>;
-  explicit IRAddr(value_type value) : value_(std::move(value)) {}
-
-  [[nodiscard]] bool is_var() const { return std::holds_alternative<IRVar>(value_); }
-  [[nodiscard]] bool is_imm() const { return std::holds_alternative<int>(value_); }
-  [[nodiscard]] bool is_name() const { return std::holds_alternative<std::string>(value_); }
-  int &imm() { return std::get<int>(value_); }
-  IRVar &var() { return std::get<IRVar>(value_); }
-  std::string &name() { return std::get<std::string>(value_); }
+  enum class Kind : uint8_t { None, Imm, Name, Var };
+  IRAddr() : kind_(Kind::None), imm_(0) {}
+  explicit IRAddr(int imm) : kind_(Kind::Imm), imm_(imm) {}
+  explicit IRAddr(Symbol name) : kind_(Kind::Name), name_(name) {}
+  explicit IRAddr(IRVar var) : kind_(Kind::Var), var_(var) {}
+
+  [[nodiscard]] Kind kind() const { return kind_; }
+  [[nodiscard]] bool empty() const { return kind_ == Kind::None; }
+  [[nodiscard]] bool is_var() const { return kind_ == Kind::Var; }
+  [[nodiscard]] bool is_imm() const { return kind_ == Kind::Imm; }
+  [[nodiscard]] bool is_name() const { return kind_ == Kind::Name; }
+  int &imm() {
+    assert(is_imm());
+    return imm_;
+  }
+  IRVar &var() {
+    assert(is_var());
+    return var_;
+  }
+  Symbol &name() {
+    assert(is_name());
+    return name_;
+  }
  private:
-  value_type value_;
+  Kind kind_;
+  union {
+    int imm_;
+    Symbol name_;
+    IRVar var_;
+  };
 };
-using IRAddrPtr = std::shared_ptr<IRAddr>;
-
-inline IRAddrPtr new_ir_addr(const IRAddr::value_type &v) {
-  return std::make_shared<IRAddr>(v);
-}
 
 // str代表字符串类型，imm代表数字类型，var代表变量类型, null代表不使用
 // Op       a0      a1      a2      作用
@@ -55,20 +71,28 @@ inline IRAddrPtr new_ir_addr(const IRAddr::value_type &v) {
 // LOR      var     var|imm var|imm a0 = (a1 || a2)
 // JMP      imm     null    null    跳转到a0对应的标签
 // BEQZ     var|imm imm     null    如果a0 == 0,则跳转到a1对应的标签
+// BNEZ     var|imm imm     null    如果a0 != 0,则跳转到a1对应的标签
+// BEQ      var     var|imm imm     如果a0 == a1,则跳转到a2对应的标签
+// BNE      var     var|imm imm     如果a0 != a1,则跳转到a2对应的标签
+// BLT      var     var|imm imm     如果a0 < a1,则跳转到a2对应的标签
+// BGE      var     var|imm imm     如果a0 >= a1,则跳转到a2对应的标签
+// BGT      var     var|imm imm     如果a0 > a1,则跳转到a2对应的标签
+// BLE      var     var|imm imm     如果a0 <= a1,则跳转到a2对应的标签
 // PARAM    var     null    null    将a0作为参数进行传递
 // CALL     var     str     null    调用函数a1，将返回值存放在a0中
 // LA       var     str     null    将全局变量a1的地址加载到a0中
 // LOAD     var     var     var|imm 以a1为基地址，a2为偏移地址的对应地址的值加载到a0中
-// STORE    var     var     var|imm 将a0的值存放到以a1为基地址，a2为偏移地址的对应地址
+// STORE    var|imm var     var|imm 将a0的值存放到以a1为基地址，a2为偏移地址的对应地址
 // ALLOC    var     imm     null    为局部数组分配a1大小的空间，返回首地址到var中
 // GBSS     str     imm     null    为全局变量a0分配a1大小的空间(可能是数组)
 // GINI     str     imm     null    为全局变量a0分配内存，并初始化为imm(不为数组)
+// LOC      imm     imm     null    之后的代码对应源文件的第a0行第a1列，只用于生成调试信息
 // 以下指令只会在寄存器分配后使用
 // FUNBEG   str     imm     imm     相比原来的FUNBEG，添加a2，表示局部数组的开始地址, a1更新为fp-sp的大小
 // LOADFP   var     imm     null    以a1为偏移地址, fp寄存器为基址的地址的值加载到寄存器a0中
 // STOREFP  var     imm     null    将寄存器a0的值存放到以a1为偏移地址, fp寄存器为基址的地址中
 // LARRAY   var     imm     null    结合新的FUNBEG中的a2一起翻译，a1为相对偏移，将局部数组的首地址加载到a0中, 由ALLOC指令转换而来
-enum class IROp {
+enum class IROp : uint8_t {
   FUNBEG,
   FUNEND,
   LABEL,
@@ -92,6 +116,13 @@ enum class IROp {
   LOR,
   JMP,
   BEQZ,
+  BNEZ,
+  BEQ,
+  BNE,
+  BLT,
+  BGE,
+  BGT,
+  BLE,
   PARAM,
   CALL,
   LA,
@@ -100,116 +131,291 @@ enum class IROp {
   ALLOC,
   GBSS,
   GINI,
+  LOC,
   LOADFP,
   STOREFP,
   LARRAY,
 };
+class IRList;
+
+// IR指令，分配在IRBuilder的Arena中，操作数直接保存在指令中
+// 指令本身也是IRList中的节点(侵入式链表)，同一时刻只能属于一个IRList
 class IRCode {
  public:
-  IRCode(IROp op, IRAddrPtr a0, IRAddrPtr a1, IRAddrPtr a2)
-      : op_(op), a0_(std::move(a0)), a1_(std::move(a1)), a2_(std::move(a2)) {}
+  IRCode(IROp op, IRAddr a0, IRAddr a1, IRAddr a2) : op_(op), a0_(a0), a1_(a1), a2_(a2) {}
   ~IRCode() = default;
   IROp &op() { return op_; }
-  IRAddrPtr &a0() { return a0_; }
-  IRAddrPtr &a1() { return a1_; }
-  IRAddrPtr &a2() { return a2_; }
+  IRAddr &a0() { return a0_; }
+  IRAddr &a1() { return a1_; }
+  IRAddr &a2() { return a2_; }
  private:
-  IROp op_;
-  IRAddrPtr a0_;
-  IRAddrPtr a1_;
-  IRAddrPtr a2_;
+  friend class IRList;
+  IRCode() = default;  // 只用于IRList的哨兵节点
+
+  IROp op_{IROp::FUNEND};
+  IRAddr a0_;
+  IRAddr a1_;
+  IRAddr a2_;
+  IRCode *prev_{this};
+  IRCode *next_{this};
 };
-using IRCodePtr = std::shared_ptr<IRCode>;
+using IRCodePtr = IRCode *;
 
-inline IRCodePtr new_ir(IROp op,
-                        const IRAddrPtr &a0 = nullptr,
-                        const IRAddrPtr &a1 = nullptr,
-                        const IRAddrPtr &a2 = nullptr) {
-  return std::make_shared<IRCode>(op, a0, a1, a2);
-}
+// 以IRCode为节点的双向循环链表，带一个哨兵节点，插入、删除和拼接都不需要申请内存
+// 链表不拥有其中的指令，指令的内存由IRBuilder的Arena管理
+class IRList {
+ public:
+  class iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = IRCodePtr;
+    using difference_type = std::ptrdiff_t;
+    using pointer = IRCodePtr *;
+    using reference = IRCodePtr;
+
+    iterator() = default;
+    explicit iterator(IRCodePtr node) : node_(node) {}
+    IRCodePtr operator*() const { return node_; }
+    IRCodePtr operator->() const { return node_; }
+    iterator &operator++() {
+      node_ = node_->next_;
+      return *this;
+    }
+    iterator operator++(int) {
+      auto old = *this;
+      node_ = node_->next_;
+      return old;
+    }
+    iterator &operator--() {
+      node_ = node_->prev_;
+      return *this;
+    }
+    iterator operator--(int) {
+      auto old = *this;
+      node_ = node_->prev_;
+      return old;
+    }
+    bool operator==(const iterator &other) const { return node_ == other.node_; }
+    bool operator!=(const iterator &other) const { return node_ != other.node_; }
+   private:
+    IRCodePtr node_{nullptr};
+  };
+  using reverse_iterator = std::reverse_iterator<iterator>;
+
+  IRList() = default;
+  ~IRList() = default;
+  IRList(const IRList &) = delete;
+  IRList &operator=(const IRList &) = delete;
+  IRList(IRList &&other) noexcept { splice(other); }
+  IRList &operator=(IRList &&other) noexcept {
+    if (this != &other) {
+      clear();
+      splice(other);
+    }
+    return *this;
+  }
+
+  [[nodiscard]] iterator begin() const { return iterator(head_.next_); }
+  [[nodiscard]] iterator end() const { return iterator(const_cast<IRCodePtr>(&head_)); }
+  [[nodiscard]] reverse_iterator rbegin() const { return reverse_iterator(end()); }
+  [[nodiscard]] reverse_iterator rend() const { return reverse_iterator(begin()); }
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+  [[nodiscard]] std::size_t size() const { return size_; }
+  [[nodiscard]] IRCodePtr front() const { return head_.next_; }
+  [[nodiscard]] IRCodePtr back() const { return head_.prev_; }
+
+  // 将code插入到pos之前，返回指向code的迭代器
+  iterator insert(iterator pos, IRCodePtr code) {
+    auto next = *pos;
+    code->prev_ = next->prev_;
+    code->next_ = next;
+    next->prev_->next_ = code;
+    next->prev_ = code;
+    ++size_;
+    return iterator(code);
+  }
+  void push_back(IRCodePtr code) { insert(end(), code); }
+  // 从链表中摘下pos指向的指令，返回下一条指令的迭代器
+  iterator erase(iterator pos) {
+    auto code = *pos;
+    auto next = code->next_;
+    code->prev_->next_ = next;
+    next->prev_ = code->prev_;
+    code->prev_ = code->next_ = code;
+    --size_;
+    return iterator(next);
+  }
+  IRCodePtr pop_front() {
+    auto code = front();
+    erase(begin());
+    return code;
+  }
+  IRCodePtr pop_back() {
+    auto code = back();
+    erase(iterator(code));
+    return code;
+  }
+  // 将other中的所有指令移动到末尾
+  void splice(IRList &other) {
+    if (other.empty()) return;
+    auto first = other.head_.next_, last = other.head_.prev_;
+    first->prev_ = head_.prev_;
+    last->next_ = &head_;
+    head_.prev_->next_ = first;
+    head_.prev_ = last;
+    size_ += other.size_;
+    other.clear();
+  }
+  // 只清空链表，不释放指令
+  void clear() {
+    head_.prev_ = head_.next_ = &head_;
+    size_ = 0;
+  }
+ private:
+  IRCode head_;  // 哨兵，head_.next_为第一条指令，head_.prev_为最后一条指令
+  std::size_t size_{0};
+};
 
 class IRBuilder {
  public:
-  using iterator = std::list<IRCodePtr>::iterator;
+  using iterator = IRList::iterator;
 
   IRBuilder() = default;
   ~IRBuilder() = default;
 
+  // 在Arena中分配一条指令，但不加入任何链表，用于IR优化
+  IRCodePtr make_ir(IROp op, IRAddr a0 = IRAddr(), IRAddr a1 = IRAddr(), IRAddr a2 = IRAddr()) {
+    return arena_.make<IRCode>(op, a0, a1, a2);
+  }
   // 不带迭代器的版本用于中间代码生成
   // 带迭代器的版本用于IR优化
-  // 暂时未提供erase相关接口
-  iterator new_ir(IROp op,
-                  const IRAddrPtr &a0 = nullptr,
-                  const IRAddrPtr &a1 = nullptr,
-                  const IRAddrPtr &a2 = nullptr) {
+  iterator new_ir(IROp op, IRAddr a0 = IRAddr(), IRAddr a1 = IRAddr(), IRAddr a2 = IRAddr()) {
     return new_ir(ircode_list_.end(), op, a0, a1, a2);
   }
-  iterator new_ir(iterator pos,
-                  IROp op,
-                  const IRAddrPtr &a0 = nullptr,
-                  const IRAddrPtr &a1 = nullptr,
-                  const IRAddrPtr &a2 = nullptr) {
-    return ircode_list_.insert(pos, std::make_shared<IRCode>(op, a0, a1, a2));
+  iterator new_ir(iterator pos, IROp op, IRAddr a0 = IRAddr(), IRAddr a1 = IRAddr(), IRAddr a2 = IRAddr()) {
+    return ircode_list_.insert(pos, make_ir(op, a0, a1, a2));
   }
-  IRCodePtr &last_ir() { return ircode_list_.back(); }
+  IRCodePtr last_ir() { return ircode_list_.back(); }
 
-  std::list<IRCodePtr> &ircode_list() { return ircode_list_; }
+  IRList &ircode_list() { return ircode_list_; }
+  [[nodiscard]] const Arena &arena() const { return arena_; }
  private:
-  std::list<IRCodePtr> ircode_list_;
+  Arena arena_;
+  IRList ircode_list_;
 };
 using IRBuilderPtr = std::shared_ptr<IRBuilder>;
 
 // some convert functions
-inline IROp to_ir_op(Unary::Op op) {
+inline IROp to_ir_op(UnaryExpr::Op op) {
   switch (op) {
-    case Unary::Op::Sub: return IROp::NEG;
-    case Unary::Op::Not: return IROp::NOT;
-    case Unary::Op::Lnot: return IROp::LNOT;
+    case UnaryExpr::Op::Sub: return IROp::NEG;
+    case UnaryExpr::Op::Not: return IROp::NOT;
+    case UnaryExpr::Op::Lnot: return IROp::LNOT;
   }
   assert(false);
 }
 
-inline IROp to_ir_op(Multiplicative::Op op) {
+inline IROp to_ir_op(BinaryExpr::Op op) {
   switch (op) {
-    case Multiplicative::Op::Times: return IROp::MUL;
-    case Multiplicative::Op::Divide: return IROp::DIV;
-    case Multiplicative::Op::Mod: return IROp::REM;
+    case BinaryExpr::Op::Times: return IROp::MUL;
+    case BinaryExpr::Op::Divide: return IROp::DIV;
+    case BinaryExpr::Op::Mod: return IROp::REM;
+    case BinaryExpr::Op::Add: return IROp::ADD;
+    case BinaryExpr::Op::Sub: return IROp::SUB;
+    case BinaryExpr::Op::Less: return IROp::LT;
+    case BinaryExpr::Op::Greater: return IROp::GT;
+    case BinaryExpr::Op::Le: return IROp::LE;
+    case BinaryExpr::Op::Ge: return IROp::GE;
+    case BinaryExpr::Op::Equal: return IROp::EQ;
+    case BinaryExpr::Op::Nequal: return IROp::NE;
+    case BinaryExpr::Op::Land: return IROp::LAND;
+    case BinaryExpr::Op::Lor: return IROp::LOR;
   }
   assert(false);
 }
 
-inline IROp to_ir_op(Additive::Op op) {
+// RISC-V的I型指令和访存指令中的立即数为12位有符号数
+inline bool is_imm12(int64_t imm) {
+  return imm >= -2048 && imm <= 2047;
+}
+
+// 比较成立时跳转的指令
+inline IROp to_branch_op(BinaryExpr::Op op) {
   switch (op) {
-    case Additive::Op::Add: return IROp::ADD;
-    case Additive::Op::Sub: return IROp::SUB;
+    case BinaryExpr::Op::Less: return IROp::BLT;
+    case BinaryExpr::Op::Greater: return IROp::BGT;
+    case BinaryExpr::Op::Le: return IROp::BLE;
+    case BinaryExpr::Op::Ge: return IROp::BGE;
+    case BinaryExpr::Op::Equal: return IROp::BEQ;
+    case BinaryExpr::Op::Nequal: return IROp::BNE;
+    default: break;
   }
   assert(false);
 }
 
-inline IROp to_ir_op(Relational::Op op) {
+// 条件相反的跳转指令
+inline IROp negate_branch_op(IROp op) {
   switch (op) {
-    case Relational::Op::Less: return IROp::LT;
-    case Relational::Op::Greater: return IROp::GT;
-    case Relational::Op::Le: return IROp::LE;
-    case Relational::Op::Ge: return IROp::GE;
+    case IROp::BEQZ: return IROp::BNEZ;
+    case IROp::BNEZ: return IROp::BEQZ;
+    case IROp::BEQ: return IROp::BNE;
+    case IROp::BNE: return IROp::BEQ;
+    case IROp::BLT: return IROp::BGE;
+    case IROp::BGE: return IROp::BLT;
+    case IROp::BGT: return IROp::BLE;
+    case IROp::BLE: return IROp::BGT;
+    default: break;
   }
   assert(false);
 }
 
-inline IROp to_ir_op(Equality::Op op) {
+// 交换两个操作数后结果不变的指令(比较需要同时交换比较的方向)
+inline bool can_swap_operands(IROp op) {
   switch (op) {
-    case Equality::Op::Equal: return IROp::EQ;
-    case Equality::Op::Nequal: return IROp::NE;
+    case IROp::ADD: case IROp::MUL:
+    case IROp::LT: case IROp::GT: case IROp::LE: case IROp::GE: case IROp::EQ: case IROp::NE:
+    case IROp::BEQ: case IROp::BNE: case IROp::BLT: case IROp::BGE: case IROp::BGT: case IROp::BLE:
+      return true;
+    default:
+      return false;
   }
-  assert(false);
+}
+
+// 交换两个操作数后对应的指令
+inline IROp swap_operands_op(IROp op) {
+  switch (op) {
+    case IROp::LT: return IROp::GT;
+    case IROp::GT: return IROp::LT;
+    case IROp::LE: return IROp::GE;
+    case IROp::GE: return IROp::LE;
+    case IROp::BLT: return IROp::BGT;
+    case IROp::BGT: return IROp::BLT;
+    case IROp::BLE: return IROp::BGE;
+    case IROp::BGE: return IROp::BLE;
+    default: break;
+  }
+  assert(can_swap_operands(op));
+  return op;
 }
 
 inline bool is_jmp_op(IROp op) {
-  return op >= IROp::JMP && op <= IROp::BEQZ;
+  return op >= IROp::JMP && op <= IROp::BLE;
 }
 
 inline bool is_conditional_jmp_op(IROp op) {
-  return op == IROp::BEQZ;
+  return op >= IROp::BEQZ && op <= IROp::BLE;
+}
+
+// 比较两个操作数的条件跳转
+inline bool is_compare_jmp_op(IROp op) {
+  return op >= IROp::BEQ && op <= IROp::BLE;
+}
+
+// 跳转的目标标签：JMP为a0，BEQZ和BNEZ为a1，比较两个操作数的跳转为a2
+inline int jmp_target(IRCodePtr code) {
+  if (code->op() == IROp::JMP) return code->a0().imm();
+  if (is_compare_jmp_op(code->op())) return code->a2().imm();
+  return code->a1().imm();
 }
 
 inline bool is_unary_op(IROp op) {
@@ -0,0 +1,24 @@
+#ifndef SCOMPILER_SRC_BASE_SOURCE_LOCATION_HPP_
+#define SCOMPILER_SRC_BASE_SOURCE_LOCATION_HPP_
+
+#include <cstdint>
+
+// token和AST节点只记录其在源文件中的字节偏移，行号和列号在需要时由LineTable计算
+using SourceOffset = uint32_t;
+inline constexpr SourceOffset kNoOffset = UINT32_MAX;
+
+struct SourceLocation {
+  int line;    // 从1开始
+  int column;  // 从1开始，以字节为单位
+};
+
+// AST节点记录源文件位置时继承该类，由parser设置
+class SourceNode {
+ public:
+  [[nodiscard]] SourceOffset offset() const { return offset_; }
+  void set_offset(SourceOffset offset) { offset_ = offset; }
+ private:
+  SourceOffset offset_{kNoOffset};
+};
+
+#endif //SCOMPILER_SRC_BASE_SOURCE_LOCATION_HPP_
@@ -0,0 +1,61 @@
+#include "symbol.hpp"
+
+#include "arena.hpp"
+
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+// 字符串按id分块保存，块的指针数组大小固定，驻留新的字符串不会移动已有的块，所以str()不需要加锁
+constexpr uint32_t kBlockBits = 12;
+constexpr uint32_t kBlockSize = 1u << kBlockBits;
+constexpr uint32_t kMaxBlocks = 1u << 12;  // 最多约1600万个符号
+
+class SymbolPool {
+ public:
+  Symbol intern(std::string_view str) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = id_map_.find(str);
+    if (iter != id_map_.end()) return Symbol::from_id(iter->second);
+    auto id = count_++;
+    assert(id < kBlockSize * kMaxBlocks);
+    auto &block = block_vec_[id >> kBlockBits];
+    if (!block) block = std::make_unique<std::string_view[]>(kBlockSize);
+    auto text = arena_.string(str);
+    block[id & (kBlockSize - 1)] = text;
+    id_map_.emplace(text, id);
+    return Symbol::from_id(id);
+  }
+  [[nodiscard]] std::string_view str(uint32_t id) const {
+    return block_vec_[id >> kBlockBits][id & (kBlockSize - 1)];
+  }
+  [[nodiscard]] std::size_t count() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return count_;
+  }
+ private:
+  std::mutex mutex_;
+  Arena arena_;  // 保存字符串的内容
+  std::unordered_map<std::string_view, uint32_t> id_map_;  // key指向arena_中的字符串
+  std::unique_ptr<std::string_view[]> block_vec_[kMaxBlocks];
+  uint32_t count_{0};
+};
+
+SymbolPool &pool() {
+  static SymbolPool pool;
+  return pool;
+}
+
+}
+
+Symbol Symbol::intern(std::string_view str) { return pool().intern(str); }
+
+std::size_t Symbol::count() { return pool().count(); }
+
+std::string_view Symbol::str() const {
+  assert(valid());
+  return pool().str(id_);
+}
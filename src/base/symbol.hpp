@@ -0,0 +1,47 @@
+#ifndef SCOMPILER_SRC_BASE_SYMBOL_HPP_
+#define SCOMPILER_SRC_BASE_SYMBOL_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string_view>
+
+// 驻留的字符串(标识符、字符串字面量、函数名和全局变量名)，整个编译过程共用一张表
+// 相同的字符串得到相同的32位id，token、AST、符号表和IR中都只保存和比较id，只在输出时通过str()取出字符串
+// 字符串一旦驻留就不会被释放，str()返回的string_view在整个进程中有效
+class Symbol {
+ public:
+  static constexpr uint32_t kNoId = UINT32_MAX;
+
+  Symbol() = default;  // 空的符号，不对应任何字符串
+  // 线程安全
+  static Symbol intern(std::string_view str);
+  // id必须来自之前驻留的符号，用于token中保存的值
+  static Symbol from_id(uint32_t id) { return Symbol(id); }
+  // 已经驻留的符号个数
+  static std::size_t count();
+
+  [[nodiscard]] uint32_t id() const { return id_; }
+  [[nodiscard]] bool valid() const { return id_ != kNoId; }
+  // 不加锁，调用方必须已经通过intern或者from_id得到这个符号
+  [[nodiscard]] std::string_view str() const;
+
+  bool operator==(Symbol other) const { return id_ == other.id_; }
+  bool operator!=(Symbol other) const { return id_ != other.id_; }
+  bool operator<(Symbol other) const { return id_ < other.id_; }  // 按驻留的顺序，与字符串的字典序无关
+ private:
+  explicit Symbol(uint32_t id) : id_(id) {}
+
+  uint32_t id_{kNoId};
+};
+
+inline std::ostream &operator<<(std::ostream &os, Symbol symbol) { return os << symbol.str(); }
+
+namespace std {
+template<>
+struct hash<Symbol> {
+  std::size_t operator()(Symbol symbol) const noexcept { return symbol.id(); }
+};
+}
+
+#endif //SCOMPILER_SRC_BASE_SYMBOL_HPP_
@@ -5,23 +5,24 @@
 #include "ast.hpp"
 #include "ir.hpp"
 
-#include <unordered_map>
-#include <unordered_set>
+#include <cstdint>
 #include <utility>
+#include <vector>
 
 struct FunctionEntry {
  public:
-  FunctionEntry(VariableType ret_type, std::string func_name, std::vector<VariableType> param_vec)
-      : ret_type_(std::move(ret_type)), func_name_(std::move(func_name)), param_type_vec_(std::move(param_vec)) {}
+  FunctionEntry(VariableType ret_type, Symbol func_name, std::vector<VariableType> param_vec)
+      : ret_type_(std::move(ret_type)), func_name_(func_name), param_type_vec_(std::move(param_vec)) {}
   explicit FunctionEntry(const FunctionPtr &function)
-      : ret_type_(function->ret_type().type()), func_name_(function->name()), param_type_vec_() {
+      : ret_type_(function->ret_type().type()), func_name_(function->name()), param_type_vec_(), function_(function) {
     for (auto &param : function->parameter_list()->variables()) {
       param_type_vec_.push_back(param->type());
     }
   }
   VariableType &ret_type() { return ret_type_; }
-  std::string &func_name() { return func_name_; }
+  Symbol &func_name() { return func_name_; }
   std::vector<VariableType> &param_type_vec() { return param_type_vec_; }
+  FunctionPtr &function() { return function_; }
 
   bool operator==(const FunctionEntry &other) const {
     if (func_name_ != other.func_name_) return false;
@@ -35,66 +36,95 @@ struct FunctionEntry {
   bool operator!=(const FunctionEntry &other) const { return !(*this == other); }
  private:
   VariableType ret_type_;
-  std::string func_name_;
+  Symbol func_name_;
   std::vector<VariableType> param_type_vec_;
+  FunctionPtr function_{nullptr};  // 对应的函数声明或定义
 };
 using FunctionEntryPtr = std::shared_ptr<FunctionEntry>;
 
-// 函数表
+// 函数表，第一次声明或定义的表项会一直保留
 class FunctionTable {
  public:
   FunctionTable() = default;
   ~FunctionTable() = default;
-  void define(const FunctionEntryPtr &function_entry) {
-    function_map_.emplace(function_entry->func_name(), function_entry);
-    define_set_.insert(function_entry->func_name());
+  void define(Symbol symbol, const FunctionEntryPtr &function_entry) {
+    auto &slot = slot_at(symbol);
+    if (!slot.entry) slot.entry = function_entry;
+    slot.defined = true;
   }
-  void declare(const FunctionEntryPtr &function_entry) {
-    function_map_.emplace(function_entry->func_name(), function_entry);
+  void declare(Symbol symbol, const FunctionEntryPtr &function_entry) {
+    auto &slot = slot_at(symbol);
+    if (!slot.entry) slot.entry = function_entry;
   }
-  bool is_defined(const std::string &func_name) {
-    return define_set_.count(func_name);
+  [[nodiscard]] bool is_defined(Symbol symbol) const {
+    return symbol.id() < slot_vec_.size() && slot_vec_[symbol.id()].defined;
   }
-  FunctionEntryPtr lookup(const std::string &func_name) {
-    if (function_map_.count(func_name)) {
-      return function_map_[func_name];
-    }
-    return nullptr;
+  [[nodiscard]] FunctionEntryPtr lookup(Symbol symbol) const {
+    return symbol.id() < slot_vec_.size() ? slot_vec_[symbol.id()].entry : nullptr;
   }
  private:
-  std::unordered_map<std::string, FunctionEntryPtr> function_map_;
-  std::unordered_set<std::string> define_set_;
+  struct Slot {
+    FunctionEntryPtr entry;
+    bool defined{false};
+  };
+  Slot &slot_at(Symbol symbol) {
+    if (symbol.id() >= slot_vec_.size()) slot_vec_.resize(symbol.id() + 1);
+    return slot_vec_[symbol.id()];
+  }
+  std::vector<Slot> slot_vec_;  // 以Symbol的id为下标
 };
-using FunctionTablePtr = std::shared_ptr<FunctionTable>;
 
-// 变量表
+// 所有作用域共用的一张变量表：每个名字有一个遮蔽栈，栈顶为最内层作用域中的变量
+// binding_vec_按加入的顺序保存所有绑定，同时作为撤销日志：离开作用域时弹出该作用域的绑定，恢复被遮蔽的变量
+// 进入和离开作用域不申请内存，查找的代价与嵌套深度无关
 class VariableTable {
-  using VariableTablePtr = std::shared_ptr<VariableTable>;
  public:
-  explicit VariableTable(VariableTablePtr father = nullptr) : father_(std::move(father)) {}
+  VariableTable() = default;
   ~VariableTable() = default;
-  void add(const VariablePtr &variable) {
-    variable_map_.emplace(variable->name(), variable);
-  }
-  std::pair<VariablePtr, bool> lookup(const std::string &name) {
-    if (variable_map_.count(name)) {
-      return {variable_map_[name], father_ == nullptr};
-    }
-    if (father_) {
-      return father_->lookup(name);
+  void enter() { ++depth_; }
+  void leave() {
+    while (!binding_vec_.empty() && binding_vec_.back().depth == depth_) {
+      auto &binding = binding_vec_.back();
+      top_vec_[binding.symbol.id()] = binding.shadowed;
+      binding_vec_.pop_back();
     }
-    return {nullptr, false};
-  }
-  bool can_use(const std::string &name) {
-    if (variable_map_.count(name)) return false;
-    return true;
-  }
-  VariableTablePtr father() const { return father_; }
+    --depth_;
+  }
+  void add(Symbol symbol, const VariablePtr &variable) {
+    auto id = symbol.id();
+    if (id >= top_vec_.size()) top_vec_.resize(id + 1, kNoBinding);
+    binding_vec_.push_back({variable, symbol, depth_, top_vec_[id]});
+    top_vec_[id] = static_cast<uint32_t>(binding_vec_.size() - 1);
+  }
+  // 返回最内层的同名变量，以及它是否为全局变量
+  [[nodiscard]] std::pair<VariablePtr, bool> lookup(Symbol symbol) const {
+    auto *binding = top(symbol);
+    if (!binding) return {nullptr, false};
+    return {binding->variable, binding->depth == 0};
+  }
+  // 深度不小于depth的作用域中没有这个名字的变量
+  [[nodiscard]] bool can_use(Symbol symbol, int depth) const {
+    auto *binding = top(symbol);
+    return !binding || binding->depth < depth;
+  }
+  [[nodiscard]] int depth() const { return depth_; }
  private:
-  std::unordered_map<std::string, VariablePtr> variable_map_;
-  VariableTablePtr father_;
+  static constexpr uint32_t kNoBinding = UINT32_MAX;
+  struct Binding {
+    VariablePtr variable;
+    Symbol symbol;
+    int depth;
+    uint32_t shadowed;  // 被遮蔽的外层绑定在binding_vec_中的下标
+  };
+  [[nodiscard]] const Binding *top(Symbol symbol) const {
+    auto id = symbol.id();
+    if (id >= top_vec_.size() || top_vec_[id] == kNoBinding) return nullptr;
+    return &binding_vec_[top_vec_[id]];
+  }
+  std::vector<uint32_t> top_vec_;  // 以Symbol的id为下标，遮蔽栈的栈顶在binding_vec_中的下标
+  std::vector<Binding> binding_vec_;
+  int depth_{0};
 };
-using VariableTablePtr = std::shared_ptr<VariableTable>;
 
 class SimpleAllocator {
  public:
@@ -110,116 +140,91 @@ class SimpleAllocator {
   int label_num_{0};
 };
 
-class LoopTable {
-  using LoopTablePtr = std::shared_ptr<LoopTable>;
- public:
-  LoopTable(LoopTablePtr father, int begin_label, int continue_label, int break_label)
-      : father_(std::move(father)),
-        begin_label_(begin_label),
-        continue_label_(continue_label),
-        break_label_(break_label) {}
-  ~LoopTable() = default;
-
-  [[nodiscard]] int begin_label() const { return begin_label_; }
-  [[nodiscard]] int continue_label() const { return continue_label_; }
-  [[nodiscard]] int break_label() const { return break_label_; }
-  [[nodiscard]] LoopTablePtr father() const { return father_; }
-
- private:
-  int begin_label_{-1};
-  int continue_label_{-1};
-  int break_label_{-1};
-  LoopTablePtr father_;
-};
-using LoopTablePtr = std::shared_ptr<LoopTable>;
-
 class SymbolTable {
  public:
-  SymbolTable() : function_table_(std::make_shared<FunctionTable>()),
-                  variable_table_(std::make_shared<VariableTable>()) {}
+  SymbolTable() = default;
   ~SymbolTable() = default;
 
   void enter() {
-    variable_table_ = std::make_shared<VariableTable>(variable_table_);
-    ++scope_depth_;
-    if (scope_depth_ == 1) allocator_.enter_function();
-  }
-  void leave() {
-    variable_table_ = variable_table_->father();
-    --scope_depth_;
+    variable_table_.enter();
+    if (variable_table_.depth() == 1) allocator_.enter_function();
   }
+  void leave() { variable_table_.leave(); }
   void enter_loop() {
     enter();
     int begin_label = alloc_label();
     int continue_lable = alloc_label();
     int break_label = alloc_label();
-    loop_table_ = std::make_shared<LoopTable>(loop_table_, begin_label, continue_lable, break_label);
+    loop_vec_.push_back({begin_label, continue_lable, break_label});
   }
   void leave_loop() {
     leave();
-    assert(loop_table_ != nullptr); // 其实没必要检查
-    loop_table_ = loop_table_->father();
+    assert(!loop_vec_.empty()); // 其实没必要检查
+    loop_vec_.pop_back();
   }
-  [[nodiscard]] bool in_loop() const { return loop_table_ != nullptr; }
-  int loop_begin_label() { return loop_table_->begin_label(); };  // 不检查loop_table_是否为空
-  int loop_continue_label() { return loop_table_->continue_label(); };
-  int loop_break_label() { return loop_table_->break_label(); };
+  [[nodiscard]] bool in_loop() const { return !loop_vec_.empty(); }
+  int loop_begin_label() { return loop_vec_.back().begin_label; };  // 不检查是否在循环中
+  int loop_continue_label() { return loop_vec_.back().continue_label; };
+  int loop_break_label() { return loop_vec_.back().break_label; };
   void add_variable(const VariablePtr &variable) {
-    variable_table_->add(variable);
+    variable->free();  // 增量编译时AST会被复用，需要清除上一次翻译时分配的IR变量
+    variable_table_.add(variable->name(), variable);
   }
   void add_function_definition(const FunctionEntryPtr &function) {
-    function_table_->define(function);
+    function_table_.define(function->func_name(), function);
   }
   void add_function_declaration(const FunctionEntryPtr &function) {
-    function_table_->declare(function);
+    function_table_.declare(function->func_name(), function);
   }
-  std::pair<VariablePtr, bool> lookup_variable(const std::string &name) {
-    return variable_table_->lookup(name);
+  std::pair<VariablePtr, bool> lookup_variable(Symbol name) {
+    return variable_table_.lookup(name);
   }
-  IRVar lookup_ir_var(const std::string &name) {
-    auto[variable, is_global] = lookup_variable(name); // 默认是可以查到的，因为checker已经确保这一点
+  // variable为checker绑定的变量，不需要再按名字查找
+  IRVar ir_var(const VariablePtr &variable) {
+    if (variable->is_global()) {  // 全局变量用变量名表示
+      return IRVar::global(variable->name());
+    }
     if (variable->allocated()) {  // 已经分配了IR变量
       return variable->ir_var();
     }
     IRVar new_ir_var;
-    if (is_global) {
-      new_ir_var = IRVar(name);
+    if (variable->is_param()) {
+      new_ir_var = IRVar::param(variable->param_num());
     } else {
-      if (variable->is_param()) {
-        new_ir_var = IRVar(-variable->param_num());
-      } else {
-        new_ir_var = IRVar(alloc_var());
-      }
+      new_ir_var = IRVar::local(alloc_var());
     }
     variable->alloc(new_ir_var);
     return new_ir_var;
   }
-  FunctionEntryPtr lookup_function(const std::string &name) {
-    return function_table_->lookup(name);
+  FunctionEntryPtr lookup_function(Symbol name) {
+    return function_table_.lookup(name);
   }
-  bool can_use_var_name(const std::string &name) {
-    if (function_table_->lookup(name)) return false;  // 变量名不能和函数名重复
-    if (!variable_table_->can_use(name)) return false;
-    if (in_function_top_level()) {
-      if (!variable_table_->father()->can_use(name)) return false;
-    }
-    return true;
+  bool can_use_var_name(Symbol name) {
+    if (function_table_.lookup(name)) return false;  // 变量名不能和函数名重复
+    // 函数体最外层的变量也不能和参数重名
+    return variable_table_.can_use(name, in_function_top_level() ? 1 : variable_table_.depth());
   }
-  bool can_use_function_name(const std::string &name) {
-    return variable_table_->can_use(name);
+  bool can_use_function_name(Symbol name) {
+    return variable_table_.can_use(name, variable_table_.depth());
   }
-  bool function_is_defined(const std::string &name) {
-    return function_table_->is_defined(name);
+  bool function_is_defined(Symbol name) {
+    return function_table_.is_defined(name);
   }
-  [[nodiscard]] bool in_function_top_level() const { return scope_depth_ == 2; }
+  [[nodiscard]] bool in_global_scope() const { return variable_table_.depth() == 0; }
+  [[nodiscard]] bool in_function_top_level() const { return variable_table_.depth() == 2; }
   int alloc_var() { return allocator_.alloc_var(); };
   int alloc_label() { return allocator_.alloc_label(); }
  private:
-  FunctionTablePtr function_table_;
-  VariableTablePtr variable_table_;
-  LoopTablePtr loop_table_;
+  struct LoopLabels {
+    int begin_label;
+    int continue_label;
+    int break_label;
+  };
+
+  FunctionTable function_table_;
+  VariableTable variable_table_;
+  std::vector<LoopLabels> loop_vec_;  // 栈顶为最内层的循环
   SimpleAllocator allocator_;
-  int scope_depth_{0};
 };
 
 #endif //SCOMPILER_SRC_BASE_SYMBOL_TABLE_HPP_
@@ -1,25 +1,105 @@
 #include "token.hpp"
 
-Token get_token_by_identifier(const std::string &id) {
-  if (id == "return") {
-    return Token(TokenType::Return, "return");
-  } else if (id == "int") {
-    return Token(TokenType::Int, "int");
-  } else if (id == "if") {
-    return Token(TokenType::If, "if");
-  } else if (id == "else") {
-    return Token(TokenType::Else, "else");
-  } else if (id == "for") {
-    return Token(TokenType::For, "for");
-  } else if (id == "do") {
-    return Token(TokenType::Do, "do");
-  } else if (id == "while") {
-    return Token(TokenType::While, "while");
-  } else if (id == "break") {
-    return Token(TokenType::Break, "break");
-  } else if (id == "continue") {
-    return Token(TokenType::Continue, "continue");
+#include <array>
+
+namespace {
+
+struct Keyword {
+  std::string_view text;
+  TokenType type{TokenType::Identifier};
+};
+
+constexpr Keyword kKeywords[] = {
+    {"int", TokenType::Int},
+    {"return", TokenType::Return},
+    {"if", TokenType::If},
+    {"else", TokenType::Else},
+    {"for", TokenType::For},
+    {"do", TokenType::Do},
+    {"while", TokenType::While},
+    {"break", TokenType::Break},
+    {"continue", TokenType::Continue},
+};
+
+constexpr std::size_t kKeywordMinLength = 2;
+constexpr std::size_t kKeywordMaxLength = 8;
+constexpr std::size_t kKeywordTableSize = 16;
+
+// 关键字的完美哈希：长度加上最后一个字符，对于上面的9个关键字两两不同
+constexpr std::size_t keyword_hash(std::string_view id) {
+  return (id.length() + static_cast<unsigned char>(id.back())) % kKeywordTableSize;
+}
+
+constexpr std::array<Keyword, kKeywordTableSize> kKeywordTable = [] {
+  std::array<Keyword, kKeywordTableSize> table{};
+  for (const auto &keyword : kKeywords) {
+    table[keyword_hash(keyword.text)] = keyword;
+  }
+  return table;
+}();
+
+constexpr bool is_perfect_hash() {
+  std::size_t count = 0;
+  for (const auto &keyword : kKeywordTable) {
+    if (!keyword.text.empty()) ++count;
+  }
+  return count == std::size(kKeywords);
+}
+static_assert(is_perfect_hash(), "keyword hash has collisions");
+
+}
+
+// 先按长度排除，再查表比较一次字符串
+TokenType get_type_by_identifier(std::string_view id) {
+  if (id.length() < kKeywordMinLength || id.length() > kKeywordMaxLength) {
+    return TokenType::Identifier;
   }
-  return Token(TokenType::Identifier, id);
+  const auto &keyword = kKeywordTable[keyword_hash(id)];
+  return keyword.text == id ? keyword.type : TokenType::Identifier;
 }
 
+std::string_view token_text(TokenType type) {
+  switch (type) {
+    case TokenType::Int: return "int";
+    case TokenType::Return: return "return";
+    case TokenType::If: return "if";
+    case TokenType::Else: return "else";
+    case TokenType::For: return "for";
+    case TokenType::Do: return "do";
+    case TokenType::While: return "while";
+    case TokenType::Break: return "break";
+    case TokenType::Continue: return "continue";
+    case TokenType::Lparen: return "(";
+    case TokenType::Rparen: return ")";
+    case TokenType::LSbrace: return "[";
+    case TokenType::RSbrace: return "]";
+    case TokenType::LCbrace: return "{";
+    case TokenType::RCbrace: return "}";
+    case TokenType::Semicolon: return ";";
+    case TokenType::Comma: return ",";
+    case TokenType::Not: return "~";
+    case TokenType::Lnot: return "!";
+    case TokenType::Sub: return "-";
+    case TokenType::Add: return "+";
+    case TokenType::Times: return "*";
+    case TokenType::Divide: return "/";
+    case TokenType::Mod: return "%";
+    case TokenType::Or: return "|";
+    case TokenType::Lor: return "||";
+    case TokenType::And: return "&";
+    case TokenType::Land: return "&&";
+    case TokenType::Assign: return "=";
+    case TokenType::Equal: return "==";
+    case TokenType::Nequal: return "!=";
+    case TokenType::Less: return "<";
+    case TokenType::Greater: return ">";
+    case TokenType::Le: return "<=";
+    case TokenType::Ge: return ">=";
+    case TokenType::Question: return "?";
+    case TokenType::Colon: return ":";
+    case TokenType::Identifier:
+    case TokenType::Number:
+    case TokenType::String: break;
+  }
+  return "";
+}
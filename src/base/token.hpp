@@ -1,13 +1,10 @@
 #ifndef SCOMPILER_SRC_BASE_TOKEN_HPP_
 #define SCOMPILER_SRC_BASE_TOKEN_HPP_
 
-#include <string>
-#include <utility>
-#include <variant>
-#include <iostream>
-#include <cassert>
+#include <cstdint>
+#include <string_view>
 
-enum class TokenType {
+enum class TokenType : uint8_t {
   /* Keywords */
   Int,
   Return,
@@ -61,12 +58,12 @@ enum class TokenType {
   String,
 };
 
-// Do not support lineno
+// 紧凑的token表示：类型 + 32位的值，可以直接按值传递
+// token在源文件中的偏移保存在TokenStream中，需要时由LineTable换算为行号和列号
+// Number的值为字面量本身，Identifier和String的值为驻留后的Symbol的id，其他token不使用该值
 class Token {
  public:
-  using value_type = std::variant<int, std::string>;
-
-  Token(TokenType type, value_type value) : type_(type), value_(std::move(value)) {}
+  explicit Token(TokenType type, uint32_t value = 0) : type_(type), value_(value) {}
   ~Token() = default;
 
   [[nodiscard]] TokenType type() const { return type_; }
@@ -84,17 +81,20 @@ class Token {
   [[nodiscard]] bool is_multiplicative_op() const { return type_ >= TokenType::Times && type_ <= TokenType::Mod; };
   [[nodiscard]] bool is_unary_op() const { return type_ >= TokenType::Not && type_ <= TokenType::Sub; }
 
-  [[nodiscard]] value_type value() { return value_; }
-  [[nodiscard]] int get_number() const { return std::get<int>(value_); }
-  [[nodiscard]] std::string get_string() const { return std::get<std::string>(value_); }
+  [[nodiscard]] uint32_t value() const { return value_; }
+  [[nodiscard]] int get_number() const { return static_cast<int>(value_); }
+  [[nodiscard]] uint32_t get_string_id() const { return value_; }
 
   [[nodiscard]] bool is(TokenType t) const { return t == type_; }
 
  private:
   TokenType type_;
-  value_type value_;
+  uint32_t value_;
 };
 
-Token get_token_by_identifier(const std::string &id);
+// 关键字返回对应的TokenType，否则返回TokenType::Identifier
+TokenType get_type_by_identifier(std::string_view id);
+// 关键字和标点符号的字面值
+std::string_view token_text(TokenType type);
 
 #endif //SCOMPILER_SRC_BASE_TOKEN_HPP_
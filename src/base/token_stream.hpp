@@ -2,21 +2,107 @@
 #define SCOMPILER_SRC_BASE_TOKEN_STREAM_HPP_
 
 #include "token.hpp"
+#include "symbol.hpp"
+#include "source_location.hpp"
+#include "compile_error.hpp"
 
+#include <cassert>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
+// token的类型和值分开存放(structure of arrays)，标识符和字符串的值为驻留后的Symbol的id
+// 每个token另外记录其在源文件中的偏移，只在报错和生成调试信息时使用
 class TokenStream {
  public:
-  explicit TokenStream(std::vector<Token> token_vec) : cur_index_(0), token_vec_(std::move(token_vec)) {}
+  TokenStream() = default;
   ~TokenStream() = default;
+  // token很多，不允许意外的拷贝
+  TokenStream(const TokenStream &) = delete;
+  TokenStream &operator=(const TokenStream &) = delete;
+  TokenStream(TokenStream &&) = default;
+  TokenStream &operator=(TokenStream &&) = default;
 
-  using iterator = std::vector<Token>::iterator;
-  iterator begin() { return token_vec_.begin(); }
-  iterator end() { return token_vec_.end(); }
+  /* 以下接口供lexer使用 */
+  void push(TokenType type, SourceOffset offset, uint32_t value = 0) {
+    type_vec_.push_back(type);
+    value_vec_.push_back(value);
+    offset_vec_.push_back(offset);
+  }
+  void push_number(int number, SourceOffset offset) { push(TokenType::Number, offset, static_cast<uint32_t>(number)); }
+  void push_identifier(std::string_view id, SourceOffset offset) { push(TokenType::Identifier, offset, intern(id)); }
+  void push_string(std::string_view str, SourceOffset offset) { push(TokenType::String, offset, intern(str)); }
+  void reserve(std::size_t n) {
+    type_vec_.reserve(n);
+    value_vec_.reserve(n);
+    offset_vec_.reserve(n);
+  }
+  // 将other中的token依次追加到末尾
+  void append(const TokenStream &other) { replace(size(), size(), other, 0); }
+  // 用other中的token替换[begin, end)中的token，并将之后的token的偏移加上shift，用于增量分析
+  void replace(std::size_t begin, std::size_t end, const TokenStream &other, int64_t shift) {
+    type_vec_.erase(type_vec_.begin() + begin, type_vec_.begin() + end);
+    value_vec_.erase(value_vec_.begin() + begin, value_vec_.begin() + end);
+    offset_vec_.erase(offset_vec_.begin() + begin, offset_vec_.begin() + end);
+    type_vec_.insert(type_vec_.begin() + begin, other.type_vec_.begin(), other.type_vec_.end());
+    value_vec_.insert(value_vec_.begin() + begin, other.value_vec_.begin(), other.value_vec_.end());
+    offset_vec_.insert(offset_vec_.begin() + begin, other.offset_vec_.begin(), other.offset_vec_.end());
+    if (shift != 0) {
+      for (auto i = begin + other.size(); i < offset_vec_.size(); ++i) {
+        offset_vec_[i] = static_cast<SourceOffset>(offset_vec_[i] + shift);
+      }
+    }
+  }
+  void pop_back() {
+    type_vec_.pop_back();
+    value_vec_.pop_back();
+    offset_vec_.pop_back();
+  }
+
+  [[nodiscard]] std::size_t size() const { return type_vec_.size(); }
+  [[nodiscard]] Token operator[](std::size_t index) const { return Token(type_vec_[index], value_vec_[index]); }
+  [[nodiscard]] TokenType type(std::size_t index) const { return type_vec_[index]; }
+  [[nodiscard]] SourceOffset offset(std::size_t index) const { return offset_vec_[index]; }
+  // Identifier和String返回其内容，其他token返回字面值(Number除外)
+  [[nodiscard]] std::string_view text(Token token) const {
+    if (token.is_identifier() || token.is_string()) return symbol(token).str();
+    return token_text(token.type());
+  }
+  [[nodiscard]] static Symbol symbol(Token token) { return Symbol::from_id(token.get_string_id()); }
+
+ private:
+  // 先在本TokenStream见过的字符串中查找，避免并行分析的各个线程频繁地对全局的符号表加锁
+  uint32_t intern(std::string_view str) {
+    auto it = symbol_cache_.find(str);
+    if (it != symbol_cache_.end()) return it->second;
+    auto symbol = Symbol::intern(str);
+    symbol_cache_.emplace(symbol.str(), symbol.id());
+    return symbol.id();
+  }
+
+  std::vector<TokenType> type_vec_;
+  std::vector<uint32_t> value_vec_;
+  std::vector<SourceOffset> offset_vec_;
+  std::unordered_map<std::string_view, uint32_t> symbol_cache_;  // key指向驻留的字符串
+};
+
+// TokenStream上的读取位置，供parser使用，只能读取[begin, end)中的token
+// 只读地访问TokenStream，所以多个TokenCursor可以在不同的线程中同时使用
+class TokenCursor {
+ public:
+  explicit TokenCursor(const TokenStream &token_stream) : TokenCursor(token_stream, 0, token_stream.size()) {}
+  TokenCursor(const TokenStream &token_stream, std::size_t begin, std::size_t end)
+      : token_stream_(token_stream), cur_index_(begin), end_(end) {}
+  ~TokenCursor() = default;
 
   void advance(int dis = 1) { cur_index_ += dis; }
 
-  [[nodiscard]] bool is(TokenType type) const { return cur_token().is(type); }
+  [[nodiscard]] TokenType cur_type() const {
+    if (eof()) error("unexpected end of file");
+    return token_stream_.type(cur_index_);
+  }
+  [[nodiscard]] bool is(TokenType type) const { return cur_type() == type; }
   [[nodiscard]] bool is_type() const { return cur_token().is_type(); }
   [[nodiscard]] bool is_equality_op() const { return cur_token().is_equality_op(); }
   [[nodiscard]] bool is_relational_op() const { return cur_token().is_relational_op(); }
@@ -25,47 +111,71 @@ class TokenStream {
   [[nodiscard]] bool is_unary_op() const { return cur_token().is_unary_op(); }
 
   void consume(TokenType type) {
-    assert(is(type));
+    if (eof() || cur_type() != type) error("expected '" + std::string(token_text(type)) + "'");
     advance();
   }
-  std::string consume_identifier() {
-    assert(is(TokenType::Identifier));
-    auto id = token_vec_[cur_index_].get_string();
+  Symbol consume_identifier() {
+    if (eof() || cur_type() != TokenType::Identifier) error("expected identifier");
+    auto id = TokenStream::symbol(token_stream_[cur_index_]);
     advance();
     return id;
   }
   int consume_number() {
-    assert(is(TokenType::Number));
-    auto number = token_vec_[cur_index_].get_number();
+    if (eof() || cur_type() != TokenType::Number) error("expected number");
+    auto number = token_stream_[cur_index_].get_number();
     advance();
     return number;
   }
 
-  bool look_ahead(int dis, TokenType type) {
-    assert(cur_index_ + dis < token_vec_.size());
-    return token_vec_[cur_index_ + dis].is(type);
+  // 跳过从当前的'{'开始到与之匹配的'}'为止的所有token
+  void skip_block() {
+    if (!is(TokenType::LCbrace)) error("expected '{'");
+    int depth = 0;
+    do {
+      auto type = cur_type();
+      if (type == TokenType::LCbrace) {
+        ++depth;
+      } else if (type == TokenType::RCbrace) {
+        --depth;
+      }
+      advance();
+    } while (depth > 0 && !eof());
+    if (depth > 0) error("expected '}'");
+  }
+
+  // 超出范围时返回false
+  [[nodiscard]] bool look_ahead(int dis, TokenType type) const {
+    return cur_index_ + dis < end_ && token_stream_.type(cur_index_ + dis) == type;
   }
 
-  bool eof() { return cur_index_ == token_vec_.size(); }
+  [[nodiscard]] std::size_t index() const { return cur_index_; }
+  [[nodiscard]] bool eof() const { return cur_index_ == end_; }
+  // 当前token的偏移，到达末尾时为kNoOffset
+  [[nodiscard]] SourceOffset cur_offset() const { return eof() ? kNoOffset : token_stream_.offset(cur_index_); }
+
+  // 在当前token处报告语法错误，到达末尾时报告在最后一个token处
+  [[noreturn]] void error(const std::string &msg) const {
+    auto index = eof() && cur_index_ > 0 ? cur_index_ - 1 : cur_index_;
+    throw parse_error(msg, index < token_stream_.size() ? token_stream_.offset(index) : kNoOffset);
+  }
 
   class Status {
    public:
-    explicit Status(int index) : index_(index) {}
-    friend class TokenStream;
+    explicit Status(std::size_t index) : index_(index) {}
+    friend class TokenCursor;
    private:
-    int index_;
+    std::size_t index_;
   };
 
   [[nodiscard]] Status store() const { return Status(cur_index_); }
   void restore(Status stored_status) { cur_index_ = stored_status.index_; }
 
  private:
-  [[nodiscard]] Token cur_token() const {
-    assert(cur_index_ < token_vec_.size());
-    return token_vec_[cur_index_];
-  }
-  int cur_index_;
-  std::vector<Token> token_vec_;
+  [[nodiscard]] Token cur_token() const { return Token(cur_type()); }
+
+  const TokenStream &token_stream_;
+  std::size_t cur_index_;
+  std::size_t end_;
 };
 
 #endif //SCOMPILER_SRC_BASE_TOKEN_STREAM_HPP_
@@ -1,57 +1,87 @@
 #ifndef SCOMPILER_SRC_BASE_VARIABLE_HPP_
 #define SCOMPILER_SRC_BASE_VARIABLE_HPP_
 
+#include "arena.hpp"
 #include "support_type.hpp"
+#include "source_location.hpp"
+#include "symbol.hpp"
 
 #include <cassert>
-#include <string>
-#include <memory>
+#include <cstdint>
+#include <functional>
 #include <utility>
-#include <vector>
-#include <variant>
 
+// 32位的IR变量：高2位为种类，低30位为编号，全局变量的编号为变量名的Symbol id
+// 各种类的取值范围互不相交，所以IRVar可以直接按值复制、比较和哈希
 class IRVar {
  public:
-  using value_type = std::variant<int, std::string>;
-  IRVar() = default;
-  explicit IRVar(value_type value) : value_(std::move(value)) {}
+  enum class Kind : uint32_t {
+    Local,   // 局部变量和临时变量
+    Param,   // 函数参数，编号从1开始
+    Global,  // 全局变量
+    Reg,     // 寄存器分配后的物理寄存器
+  };
+
+  static constexpr uint32_t kMaxNum = (1u << 30) - 1;  // 编号的最大值
+
+  IRVar() = default;  // 0号局部变量
   ~IRVar() = default;
-  [[nodiscard]] bool is_global() const { return std::holds_alternative<std::string>(value_); }
-  int &num() { return std::get<int>(value_); }  // 局部变量用数字表示
-  [[nodiscard]] int num() const { return std::get<int>(value_); }  // 局部变量用数字表示
-  std::string &name() { return std::get<std::string>(value_); } // 全局变量用变量名表示
-  [[nodiscard]] const std::string &name() const { return std::get<std::string>(value_); } // 全局变量用变量名表示
-  [[nodiscard]] bool is_param() const { return !is_global() && num() < 0; } // 负数代表函数参数
-
-  bool operator==(const IRVar &other) const {
-    if (is_global()) {
-      if (other.is_global()) return name() == other.name();
-    } else {
-      if (!other.is_global()) return num() == other.num();
-    }
-    return false;
+  static IRVar local(int num) { return IRVar(Kind::Local, static_cast<uint32_t>(num)); }
+  static IRVar param(int num) { return IRVar(Kind::Param, static_cast<uint32_t>(num)); }
+  static IRVar global(Symbol name) { return IRVar(Kind::Global, name.id()); }
+  static IRVar reg(int num) { return IRVar(Kind::Reg, static_cast<uint32_t>(num)); }
+
+  [[nodiscard]] Kind kind() const { return static_cast<Kind>(id_ >> kKindShift); }
+  [[nodiscard]] bool is_global() const { return kind() == Kind::Global; }
+  [[nodiscard]] bool is_param() const { return kind() == Kind::Param; }
+  [[nodiscard]] bool is_reg() const { return kind() == Kind::Reg; }
+  // 局部变量和寄存器为其编号，函数参数为编号的相反数(负数代表函数参数)
+  [[nodiscard]] int num() const {
+    assert(!is_global());
+    auto num = static_cast<int>(id_ & kNumMask);
+    return is_param() ? -num : num;
   }
-  bool operator<(const IRVar &other) const {
-    if (is_global()) {
-      if (other.is_global()) return name() < other.name();
-      return true;
-    } else {
-      if (!other.is_global()) return num() < other.num();
-      return false;
-    }
+  [[nodiscard]] Symbol name() const {  // 全局变量用变量名表示
+    assert(is_global());
+    return Symbol::from_id(id_ & kNumMask);
+  }
+  [[nodiscard]] uint32_t id() const { return id_; }
+  // 局部变量和参数在函数内的稠密下标(局部变量为偶数，参数为奇数)，用作位向量的下标
+  [[nodiscard]] uint32_t index() const {
+    assert(kind() == Kind::Local || kind() == Kind::Param);
+    auto num = id_ & kNumMask;
+    return is_param() ? num * 2 - 1 : num * 2;
   }
+
+  bool operator==(IRVar other) const { return id_ == other.id_; }
+  bool operator!=(IRVar other) const { return id_ != other.id_; }
+  bool operator<(IRVar other) const { return id_ < other.id_; }
  private:
-  value_type value_;
+  static constexpr uint32_t kKindShift = 30;
+  static constexpr uint32_t kNumMask = kMaxNum;
+
+  IRVar(Kind kind, uint32_t num) : id_(static_cast<uint32_t>(kind) << kKindShift | num) {
+    assert(num <= kNumMask);
+  }
+
+  uint32_t id_{0};
+};
+
+namespace std {
+template<>
+struct hash<IRVar> {
+  std::size_t operator()(IRVar var) const noexcept { return var.id(); }
 };
+}
 
 class VariableType {
  public:
   explicit VariableType(SupportType type) : type_(type) {}
-  VariableType(SupportType type, std::vector<int> dim_vec) : type_(type), dimension_vec_(std::move(dim_vec)) {}
+  VariableType(SupportType type, ArenaVector<int> dim_vec) : type_(type), dimension_vec_(std::move(dim_vec)) {}
 
   [[nodiscard]] bool is_array() const { return !dimension_vec_.empty(); }
   SupportType &type() { return type_; }
-  std::vector<int> &dimension_vec() { return dimension_vec_; };
+  ArenaVector<int> &dimension_vec() { return dimension_vec_; };
 
   bool operator==(const VariableType &other) const {
     if (type_ != other.type_) return false;
@@ -71,36 +101,41 @@ class VariableType {
 
  private:
   SupportType type_;
-  std::vector<int> dimension_vec_;
+  ArenaVector<int> dimension_vec_;
 };
 
-class Variable {
+// 与AST节点一样分配在Arena中
+class Variable : public SourceNode {  // offset为变量名的位置
  public:
-  Variable(SupportType type, std::string name)
-      : type_(type), name_(std::move(name)) {}
-  Variable(SupportType type, std::vector<int> dimension_vec, std::string name)
-      : type_(type, std::move(dimension_vec)), name_(std::move(name)) {
+  Variable(SupportType type, Symbol name)
+      : type_(type), name_(name) {}
+  Variable(SupportType type, ArenaVector<int> dimension_vec, Symbol name)
+      : type_(type, std::move(dimension_vec)), name_(name) {
   }
   ~Variable() = default;
 
   VariableType &type() { return type_; }
-  std::string &name() { return name_; }
+  Symbol &name() { return name_; }
   [[nodiscard]] bool allocated() const { return allocated_; }
   IRVar &ir_var() { return ir_var_; }
   void alloc(const IRVar &ir_var) {
     allocated_ = true;
     ir_var_ = ir_var;
   }
+  void free() { allocated_ = false; }
   void set_param_num(int num) { param_num_ = num; }
   [[nodiscard]] int param_num() const { return param_num_; }
   [[nodiscard]] bool is_param() const { return param_num_ != 0; }
+  void set_global(bool global) { global_ = global; }
+  [[nodiscard]] bool is_global() const { return global_; }
  private:
   VariableType type_;
-  std::string name_;
+  Symbol name_;
   int param_num_{0};  // 0表示不是参数，>=1表示参数
+  bool global_{false};  // 由checker设置
   bool allocated_{false}; // 是否分配了IR变量
-  IRVar ir_var_;  // 被分配的IR变量
+  IRVar ir_var_;  // 被分配的IR变量，全局变量直接用变量名表示，不在这里保存
 };
-using VariablePtr = std::shared_ptr<Variable>;
+using VariablePtr = Variable *;
 
 #endif //SCOMPILER_SRC_BASE_VARIABLE_HPP_
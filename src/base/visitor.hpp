@@ -3,45 +3,42 @@
 
 #include "ast.hpp"
 
+#include <variant>
+
+// 静态分派的visitor(CRTP)：Derived为具体的pass，为每种节点提供visit(XxxPtr &)，不使用虚函数
+// 需要根据节点的实际类型分派时调用visit_variant或visit_expression，由编译器生成跳转表
+// Derived的visit是private时，需要将ASTVisitor<Derived>声明为friend
+template<typename Derived>
 class ASTVisitor {
- public:
-  virtual void visit(ProgramPtr &program) = 0;
-  virtual void visit(FunctionPtr &function) = 0;
-  virtual void visit(BaseType &type) = 0;
-  virtual void visit(ParameterListPtr &parameter_list) = 0;
-  virtual void visit(CompoundStatementPtr &compound_statement) = 0;
-  virtual void visit(BlockItemPtr &block_item) = 0;
-  virtual void visit(StatementPtr &statement) = 0;
-  virtual void visit(DeclarationPtr &declaration) = 0;
-  virtual void visit(ExpressionListPtr &expression_list) = 0;
-  virtual void visit(ExpressionPtr &expression) = 0;
-  virtual void visit(AssignmentPtr &assignment) = 0;
-  virtual void visit(ConditionalPtr &conditional) = 0;
-  virtual void visit(LogicalOrPtr &logical_or) = 0;
-  virtual void visit(LogicalAndPtr &logical_and) = 0;
-  virtual void visit(EqualityPtr &equality) = 0;
-  virtual void visit(RelationalPtr &relational) = 0;
-  virtual void visit(AdditivePtr &additive) = 0;
-  virtual void visit(MultiplicativePtr &multiplicative) = 0;
-  virtual void visit(UnaryPtr &unary) = 0;
-  virtual void visit(PostfixPtr &postfix) = 0;
-  virtual void visit(PrimaryPtr &primary) = 0;
-};
+ protected:
+  // 对variant中实际保存的节点调用Derived::visit，用于Program、BlockItem和Statement
+  template<typename... Ts>
+  void visit_variant(std::variant<Ts...> &value) {
+    std::visit([this](auto &node) { derived().visit(node); }, value);
+  }
+
+  // 根据表达式的kind()调用Derived中对应的visit
+  void visit_expression(ExpressionPtr &expression) {
+    switch (expression->kind()) {
+      case Expression::Kind::Literal: visit_as<LiteralPtr>(expression); break;
+      case Expression::Kind::Ref: visit_as<RefPtr>(expression); break;
+      case Expression::Kind::Call: visit_as<CallPtr>(expression); break;
+      case Expression::Kind::Index: visit_as<IndexPtr>(expression); break;
+      case Expression::Kind::Unary: visit_as<UnaryExprPtr>(expression); break;
+      case Expression::Kind::Binary: visit_as<BinaryExprPtr>(expression); break;
+      case Expression::Kind::Conditional: visit_as<ConditionalExprPtr>(expression); break;
+      case Expression::Kind::Assign: visit_as<AssignExprPtr>(expression); break;
+    }
+  }
+
+ private:
+  Derived &derived() { return static_cast<Derived &>(*this); }
 
-class DetailedASTVisitor : public ASTVisitor {
- public:
-  virtual void visit(ReturnStatementPtr &return_statement) = 0;
-  virtual void visit(ExpStatementPtr &exp_statement) = 0;
-  virtual void visit(IfStatementPtr &if_statement) = 0;
-  virtual void visit(ForExpStatementPtr &for_exp_statement) = 0;
-  virtual void visit(ForDecStatementPtr &for_dec_statement) = 0;
-  virtual void visit(WhileStatementPtr &while_statement) = 0;
-  virtual void visit(DoStatementPtr &do_statement) = 0;
-  virtual void visit(BreakStatementPtr &break_statement) = 0;
-  virtual void visit(ContinueStatementPtr &continue_statement) = 0;
-  virtual void visit(AssignExpPtr &assign_exp) = 0;
-  virtual void visit(FuncCallPtr &func_call) = 0;
-  virtual void visit(ArrayPtr &array) = 0;
+  template<typename T>
+  void visit_as(ExpressionPtr expression) {
+    auto node = static_cast<T>(expression);
+    derived().visit(node);
+  }
 };
 
 #endif //SCOMPILER_SRC_BASE_VISITOR_HPP_
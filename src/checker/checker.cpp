@@ -8,36 +8,32 @@ void Checker::check(ProgramPtr &program) {
 
 void Checker::visit(ProgramPtr &program) {
   for (auto &item : program->func_decl_vec()) {
-    if (std::holds_alternative<FunctionPtr>(item)) {
-      visit(std::get<FunctionPtr>(item));
-    } else if (std::holds_alternative<DeclarationPtr>(item)) {
-      visit(std::get<DeclarationPtr>(item));
-    } else { assert(false); }
+    visit_variant(item);
   }
 }
 
 void Checker::visit(FunctionPtr &function) {
   symbol_table_.enter();
   if (!symbol_table_.can_use_function_name(function->name())) {
-    throw check_error("already has a variable with name: " + function->name());
+    throw check_error("already has a variable with name: " + std::string(function->name().str()), function->offset());
   }
   auto new_function_entry = std::make_shared<FunctionEntry>(function);
   if (function->compound_statement()) { // 函数定义
     if (symbol_table_.function_is_defined(function->name())) {
-      throw check_error("multiple definition for function: " + function->name());
+      throw check_error("multiple definition for function: " + std::string(function->name().str()), function->offset());
     }
     auto old_function_entry = symbol_table_.lookup_function(function->name());
     if (old_function_entry && *new_function_entry != *old_function_entry) {
-      throw check_error("unmatched function definition: " + function->name());
+      throw check_error("unmatched function definition: " + std::string(function->name().str()), function->offset());
     }
     symbol_table_.add_function_definition(new_function_entry);
     visit(function->parameter_list());
     visit(function->compound_statement());
-  } else {  // 函数声明
+  } else {  // 函数声明，或者函数体没有被分析的函数定义(见LazyParser)
     auto old_function_entry = symbol_table_.lookup_function(function->name());
     if (old_function_entry) {
       if (*new_function_entry != *old_function_entry) {
-        throw check_error("unmatched function definition: " + function->name());
+        throw check_error("unmatched function definition: " + std::string(function->name().str()), function->offset());
       }
     } else {
       symbol_table_.add_function_declaration(new_function_entry);
@@ -52,7 +48,7 @@ void Checker::visit(ParameterListPtr &parameter_list) {
   /* 将函数参数添加到符号表中 */
   for (auto &var : parameter_list->variables()) {
     if (!symbol_table_.can_use_var_name(var->name())) {
-      throw check_error(var->name() + " already used");
+      throw check_error(std::string(var->name().str()) + " already used", var->offset());
     }
     symbol_table_.add_variable(var);
   }
@@ -66,41 +62,22 @@ void Checker::visit(CompoundStatementPtr &compound_statement) {
   symbol_table_.leave();
 }
 void Checker::visit(BlockItemPtr &block_item) {
-  if (std::holds_alternative<StatementPtr>(block_item->value())) {
-    visit(std::get<StatementPtr>(block_item->value()));
-  } else if (std::holds_alternative<DeclarationPtr>(block_item->value())) {
-    visit(std::get<DeclarationPtr>(block_item->value()));
-  } else { assert(false); }
+  visit_variant(block_item->value());
 }
 void Checker::visit(StatementPtr &statement) {
-  if (std::holds_alternative<ReturnStatementPtr>(statement->value())) {
-    visit(std::get<ReturnStatementPtr>(statement->value()));
-  } else if (std::holds_alternative<ExpStatementPtr>(statement->value())) {
-    visit(std::get<ExpStatementPtr>(statement->value()));
-  } else if (std::holds_alternative<IfStatementPtr>(statement->value())) {
-    visit(std::get<IfStatementPtr>(statement->value()));
-  } else if (std::holds_alternative<CompoundStatementPtr>(statement->value())) {
-    visit(std::get<CompoundStatementPtr>(statement->value()));
-  } else if (std::holds_alternative<ForExpStatementPtr>(statement->value())) {
-    visit(std::get<ForExpStatementPtr>(statement->value()));
-  } else if (std::holds_alternative<ForDecStatementPtr>(statement->value())) {
-    visit(std::get<ForDecStatementPtr>(statement->value()));
-  } else if (std::holds_alternative<WhileStatementPtr>(statement->value())) {
-    visit(std::get<WhileStatementPtr>(statement->value()));
-  } else if (std::holds_alternative<DoStatementPtr>(statement->value())) {
-    visit(std::get<DoStatementPtr>(statement->value()));
-  } else if (std::holds_alternative<BreakStatementPtr>(statement->value())) {
-    visit(std::get<BreakStatementPtr>(statement->value()));
-  } else if (std::holds_alternative<ContinueStatementPtr>(statement->value())) {
-    visit(std::get<ContinueStatementPtr>(statement->value()));
-  } else { assert(false); }
+  visit_variant(statement->value());
 }
 void Checker::visit(DeclarationPtr &declaration) {
   if (!symbol_table_.can_use_var_name(declaration->var()->name())) {
-    throw check_error(declaration->var()->name() + " already used");
+    throw check_error(std::string(declaration->var()->name().str()) + " already used", declaration->var()->offset());
   }
   symbol_table_.add_variable(declaration->var());
+  declaration->var()->set_global(symbol_table_.in_global_scope());
   if (declaration->init_exp()) {
+    // 全局变量的初始值保存在数据段中，只能是常量
+    if (declaration->var()->is_global() && !constant_value(declaration->init_exp())) {
+      throw check_error("initializer of global variable is not a constant", declaration->init_exp()->offset());
+    }
     visit(declaration->init_exp());
   }
 }
@@ -109,87 +86,6 @@ void Checker::visit(ExpressionListPtr &expression_list) {
     visit(exp);
   }
 }
-void Checker::visit(ExpressionPtr &expression) {
-  visit(expression->assignment());
-}
-void Checker::visit(AssignmentPtr &assignment) {
-  if (std::holds_alternative<ConditionalPtr>(assignment->value())) {
-    visit(std::get<ConditionalPtr>(assignment->value()));
-  } else if (std::holds_alternative<AssignExpPtr>(assignment->value())) {
-    visit(std::get<AssignExpPtr>(assignment->value()));
-  } else { assert(false); }
-}
-void Checker::visit(ConditionalPtr &conditional) {
-  visit(conditional->cond());
-  if (conditional->cond_true()) {
-    visit(conditional->cond_true());
-    visit(conditional->cond_false());
-  }
-}
-void Checker::visit(LogicalOrPtr &logical_or) {
-  if (logical_or->left()) {
-    visit(logical_or->left());
-  }
-  visit(logical_or->right());
-}
-void Checker::visit(LogicalAndPtr &logical_and) {
-  if (logical_and->left()) {
-    visit(logical_and->left());
-  }
-  visit(logical_and->right());
-}
-void Checker::visit(EqualityPtr &equality) {
-  if (equality->left()) {
-    visit(equality->left());
-  }
-  visit(equality->right());
-}
-void Checker::visit(RelationalPtr &relational) {
-  if (relational->left()) {
-    visit(relational->left());
-  }
-  visit(relational->right());
-}
-void Checker::visit(AdditivePtr &additive) {
-  if (additive->left()) {
-    visit(additive->left());
-  }
-  visit(additive->right());
-}
-void Checker::visit(MultiplicativePtr &multiplicative) {
-  if (multiplicative->left()) {
-    visit(multiplicative->left());
-  }
-  visit(multiplicative->right());
-}
-void Checker::visit(UnaryPtr &unary) {
-  if (std::holds_alternative<PostfixPtr>(unary->value())) {
-    visit(std::get<PostfixPtr>(unary->value()));
-  } else if (std::holds_alternative<UnaryPtr>(unary->value())) {
-    visit(std::get<UnaryPtr>(unary->value()));
-  } else { assert(false); }
-}
-void Checker::visit(PostfixPtr &postfix) {
-  if (std::holds_alternative<PrimaryPtr>(postfix->value())) {
-    visit(std::get<PrimaryPtr>(postfix->value()));
-  } else if (std::holds_alternative<FuncCallPtr>(postfix->value())) {
-    visit(std::get<FuncCallPtr>(postfix->value()));
-  } else if (std::holds_alternative<ArrayPtr>(postfix->value())) {
-    visit(std::get<ArrayPtr>(postfix->value()));
-  } else { assert(false); }
-}
-void Checker::visit(PrimaryPtr &primary) {
-  if (std::holds_alternative<ExpressionPtr>(primary->value())) {
-    visit(std::get<ExpressionPtr>(primary->value()));
-  } else if (std::holds_alternative<int>(primary->value())) {
-  } else if (std::holds_alternative<std::string>(primary->value())) {
-    auto name = std::get<std::string>(primary->value());
-    auto [result, is_global] = symbol_table_.lookup_variable(name);
-    if (!result) {
-      throw check_error("use unknown variable: " + name);
-    }
-  } else { assert(false); }
-}
 void Checker::visit(ReturnStatementPtr &return_statement) {
   visit(return_statement->exp());
 }
@@ -247,59 +143,74 @@ void Checker::visit(DoStatementPtr &do_statement) {
 }
 void Checker::visit(BreakStatementPtr &break_statement) {
   if (!symbol_table_.in_loop()) {
-    throw check_error("use break out of loop");
+    throw check_error("use break out of loop", break_statement->offset());
   }
 }
 void Checker::visit(ContinueStatementPtr &continue_statement) {
   if (!symbol_table_.in_loop()) {
-    throw check_error("use continue out of loop");
+    throw check_error("use continue out of loop", continue_statement->offset());
   }
 }
-void Checker::visit(AssignExpPtr &assign_exp) {
-  visit(assign_exp->right());
-  visit(assign_exp->left());
-  // 赋值表达式的左边必须是一个变量，或者数组的某个值
-  auto unary = assign_exp->left();
-  assert(std::holds_alternative<PostfixPtr>(unary->value()));
-  auto postfix = std::get<PostfixPtr>(unary->value());
-  assert(!std::holds_alternative<FuncCallPtr>(postfix->value())); // 暂时不支持函数作为左值(因为不支持指针)
-  if (std::holds_alternative<PrimaryPtr>(postfix->value())) {
-    auto primary = std::get<PrimaryPtr>(postfix->value());
-    assert(!std::holds_alternative<int>(primary->value())); // 数字不能作为左值
+void Checker::visit(ExpressionPtr &expression) {
+  visit_expression(expression);
+}
+void Checker::visit(LiteralPtr &) {}
+void Checker::visit(RefPtr &ref) {
+  auto [result, is_global] = symbol_table_.lookup_variable(ref->name());
+  if (!result) {
+    throw check_error("use unknown variable: " + std::string(ref->name().str()), ref->offset());
   }
-  // 暂时不对'(' expression ')'的情况进行更多检查
+  ref->variable() = result;
 }
-void Checker::visit(FuncCallPtr &func_call) {
-  auto result = symbol_table_.lookup_function(func_call->func_name());
+void Checker::visit(CallPtr &call) {
+  auto result = symbol_table_.lookup_function(call->func_name());
   if (!result) {
-    throw check_error("use unknown function: " + func_call->func_name());
+    throw check_error("use unknown function: " + std::string(call->func_name().str()), call->offset());
   }
   // 只检查参数个数，不检查类型
-  if (result->param_type_vec().size() != func_call->expression_list()->expression_vec().size()) {
-    throw check_error("function param num didn't match: " + func_call->func_name());
+  if (result->param_type_vec().size() != call->expression_list()->expression_vec().size()) {
+    throw check_error("function param num didn't match: " + std::string(call->func_name().str()), call->offset());
   }
-  visit(func_call->expression_list());
+  call->function() = result->function();
+  visit(call->expression_list());
 }
-void Checker::visit(ArrayPtr &array) {
-  if (std::holds_alternative<PrimaryPtr>(array->name())) {
-    // 只检查变量是否为数组类型，暂时不检查维度
-    auto primary = std::get<PrimaryPtr>(array->name());
-    if (std::holds_alternative<std::string>(primary->value())) {
-      auto name = std::get<std::string>(primary->value());
-      auto [result, is_global] = symbol_table_.lookup_variable(name);
-      if (!result) {  // 其实已经检查过了
-        throw check_error("use unknown variable: " + name);
-      }
-      if (!result->type().is_array()) {
-        throw check_error("variable " + name + " is not array");
-      }
-      for (auto &exp : array->expression_vec()) {
-        visit(exp);
-      }
-    }
-  } else if (std::holds_alternative<FuncCallPtr>(array->name())) {
-    assert(false);  // 暂不支持该语法
-  } else {
-    assert(false);
+void Checker::visit(IndexPtr &index) {
+  if (index->base()->kind() != Expression::Kind::Ref) {  // 暂不支持对函数的返回值使用下标
+    throw check_error("subscripted value is not an array variable", index->offset());
+  }
+  // 只检查变量是否为数组类型，暂时不检查维度
+  auto ref = static_cast<RefPtr>(index->base());
+  auto [result, is_global] = symbol_table_.lookup_variable(ref->name());
+  if (!result) {
+    throw check_error("use unknown variable: " + std::string(ref->name().str()), ref->offset());
+  }
+  if (!result->type().is_array()) {
+    throw check_error("variable " + std::string(ref->name().str()) + " is not array", ref->offset());
+  }
+  ref->variable() = result;
+  for (auto &exp : index->index_vec()) {
+    visit(exp);
+  }
+}
+void Checker::visit(UnaryExprPtr &unary_expr) {
+  visit(unary_expr->operand());
+}
+void Checker::visit(BinaryExprPtr &binary_expr) {
+  visit(binary_expr->left());
+  visit(binary_expr->right());
+}
+void Checker::visit(ConditionalExprPtr &conditional_expr) {
+  visit(conditional_expr->cond());
+  visit(conditional_expr->cond_true());
+  visit(conditional_expr->cond_false());
+}
+void Checker::visit(AssignExprPtr &assign_expr) {
+  visit(assign_expr->right());
+  visit(assign_expr->left());
+  // 赋值表达式的左边必须是一个变量，或者数组的某个值
+  // 数字、函数调用(因为不支持指针)和单目运算的结果都不能作为左值
+  auto kind = assign_expr->left()->kind();
+  if (kind != Expression::Kind::Ref && kind != Expression::Kind::Index) {
+    throw check_error("left side of assignment is not a variable", assign_expr->offset());
   }
 }
@@ -4,46 +4,41 @@
 #include "visitor.hpp"
 #include "symbol_table.hpp"
 
-class Checker : DetailedASTVisitor {
+class Checker : ASTVisitor<Checker> {
+  friend class ASTVisitor<Checker>;
  public:
   Checker() = default;
   ~Checker() = default;
 
   void check(ProgramPtr &program);
  private:
-  void visit(ProgramPtr &program) override;
-  void visit(FunctionPtr &function) override;
-  void visit(BaseType &type) override;
-  void visit(ParameterListPtr &parameter_list) override;
-  void visit(CompoundStatementPtr &compound_statement) override;
-  void visit(BlockItemPtr &block_item) override;
-  void visit(StatementPtr &statement) override;
-  void visit(DeclarationPtr &declaration) override;
-  void visit(ExpressionListPtr &expression_list) override;
-  void visit(ExpressionPtr &expression) override;
-  void visit(AssignmentPtr &assignment) override;
-  void visit(ConditionalPtr &conditional) override;
-  void visit(LogicalOrPtr &logical_or) override;
-  void visit(LogicalAndPtr &logical_and) override;
-  void visit(EqualityPtr &equality) override;
-  void visit(RelationalPtr &relational) override;
-  void visit(AdditivePtr &additive) override;
-  void visit(MultiplicativePtr &multiplicative) override;
-  void visit(UnaryPtr &unary) override;
-  void visit(PostfixPtr &postfix) override;
-  void visit(PrimaryPtr &primary) override;
-  void visit(ReturnStatementPtr &return_statement) override;
-  void visit(ExpStatementPtr &exp_statement) override;
-  void visit(IfStatementPtr &if_statement) override;
-  void visit(ForExpStatementPtr &for_exp_statement) override;
-  void visit(ForDecStatementPtr &for_dec_statement) override;
-  void visit(WhileStatementPtr &while_statement) override;
-  void visit(DoStatementPtr &do_statement) override;
-  void visit(BreakStatementPtr &break_statement) override;
-  void visit(ContinueStatementPtr &continue_statement) override;
-  void visit(AssignExpPtr &assign_exp) override;
-  void visit(FuncCallPtr &func_call) override;
-  void visit(ArrayPtr &array) override;
+  void visit(ProgramPtr &program);
+  void visit(FunctionPtr &function);
+  void visit(BaseType &type);
+  void visit(ParameterListPtr &parameter_list);
+  void visit(CompoundStatementPtr &compound_statement);
+  void visit(BlockItemPtr &block_item);
+  void visit(StatementPtr &statement);
+  void visit(DeclarationPtr &declaration);
+  void visit(ExpressionListPtr &expression_list);
+  void visit(ExpressionPtr &expression);
+  void visit(ReturnStatementPtr &return_statement);
+  void visit(ExpStatementPtr &exp_statement);
+  void visit(IfStatementPtr &if_statement);
+  void visit(ForExpStatementPtr &for_exp_statement);
+  void visit(ForDecStatementPtr &for_dec_statement);
+  void visit(WhileStatementPtr &while_statement);
+  void visit(DoStatementPtr &do_statement);
+  void visit(BreakStatementPtr &break_statement);
+  void visit(ContinueStatementPtr &continue_statement);
+  void visit(LiteralPtr &literal);
+  void visit(RefPtr &ref);
+  void visit(CallPtr &call);
+  void visit(IndexPtr &index);
+  void visit(UnaryExprPtr &unary_expr);
+  void visit(BinaryExprPtr &binary_expr);
+  void visit(ConditionalExprPtr &conditional_expr);
+  void visit(AssignExprPtr &assign_expr);
 
   SymbolTable symbol_table_;
 };
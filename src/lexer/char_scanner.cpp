@@ -0,0 +1,249 @@
+#include "char_scanner.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define SCOMPILER_X86_SIMD
+#include <immintrin.h>
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define SCOMPILER_SWAR
+#endif
+
+namespace {
+
+using SpanFunc = int (*)(const char *, int, int);
+
+// 每种字符类别提供标量、SSE2、AVX2三种判断方式
+// 向量版本中，若某个字节属于该类别，则结果中对应字节为0xFF
+#ifdef SCOMPILER_X86_SIMD
+// 判断每个字节是否在[lo, hi]范围内，利用有符号比较实现无符号的范围判断
+inline __m128i in_range(__m128i v, char lo, char hi) {
+  __m128i shifted = _mm_add_epi8(v, _mm_set1_epi8(static_cast<char>(128 - lo)));
+  return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(-128 + (hi - lo + 1))));
+}
+__attribute__((target("avx2"))) inline __m256i in_range(__m256i v, char lo, char hi) {
+  __m256i shifted = _mm256_add_epi8(v, _mm256_set1_epi8(static_cast<char>(128 - lo)));
+  return _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(-128 + (hi - lo + 1))), shifted);
+}
+#endif
+
+struct SpaceClass {
+  static bool scalar(char c) { return char_class::is_space(c); }
+#ifdef SCOMPILER_X86_SIMD
+  static __m128i sse2(__m128i v) {
+    return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), in_range(v, '\t', '\r'));
+  }
+  __attribute__((target("avx2"))) static __m256i avx2(__m256i v) {
+    return _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), in_range(v, '\t', '\r'));
+  }
+#endif
+};
+
+struct IdentifierClass {
+  static bool scalar(char c) { return char_class::is_identifier_body(c); }
+#ifdef SCOMPILER_X86_SIMD
+  static __m128i sse2(__m128i v) {
+    __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));  // 大写字母转换为小写字母
+    __m128i alpha = in_range(lower, 'a', 'z');
+    __m128i digit = in_range(v, '0', '9');
+    __m128i underscore = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+    return _mm_or_si128(_mm_or_si128(alpha, digit), underscore);
+  }
+  __attribute__((target("avx2"))) static __m256i avx2(__m256i v) {
+    __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    __m256i alpha = in_range(lower, 'a', 'z');
+    __m256i digit = in_range(v, '0', '9');
+    __m256i underscore = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'));
+    return _mm256_or_si256(_mm256_or_si256(alpha, digit), underscore);
+  }
+#endif
+};
+
+struct DigitClass {
+  static bool scalar(char c) { return char_class::is_digit(c); }
+#ifdef SCOMPILER_X86_SIMD
+  static __m128i sse2(__m128i v) { return in_range(v, '0', '9'); }
+  __attribute__((target("avx2"))) static __m256i avx2(__m256i v) { return in_range(v, '0', '9'); }
+#endif
+};
+
+struct XdigitClass {
+  static bool scalar(char c) { return char_class::is_xdigit(c); }
+#ifdef SCOMPILER_X86_SIMD
+  static __m128i sse2(__m128i v) {
+    __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    return _mm_or_si128(in_range(v, '0', '9'), in_range(lower, 'a', 'f'));
+  }
+  __attribute__((target("avx2"))) static __m256i avx2(__m256i v) {
+    __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    return _mm256_or_si256(in_range(v, '0', '9'), in_range(lower, 'a', 'f'));
+  }
+#endif
+};
+
+template<typename Class>
+int span_scalar(const char *p, int index, int len) {
+  while (index < len && Class::scalar(p[index])) ++index;
+  return index;
+}
+
+#ifdef SCOMPILER_X86_SIMD
+template<typename Class>
+int span_sse2(const char *p, int index, int len) {
+  while (index + 16 <= len) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + index));
+    auto mask = ~static_cast<unsigned>(_mm_movemask_epi8(Class::sse2(v))) & 0xFFFFu;
+    if (mask) return index + __builtin_ctz(mask);
+    index += 16;
+  }
+  return span_scalar<Class>(p, index, len);
+}
+
+template<typename Class>
+__attribute__((target("avx2"))) int span_avx2(const char *p, int index, int len) {
+  while (index + 32 <= len) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + index));
+    auto mask = ~static_cast<unsigned>(_mm256_movemask_epi8(Class::avx2(v)));
+    if (mask) return index + __builtin_ctz(mask);
+    index += 32;
+  }
+  return span_sse2<Class>(p, index, len);
+}
+#endif
+
+struct ScanFuncs {
+  const char *isa;
+  SpanFunc space;
+  SpanFunc identifier;
+  SpanFunc digit;
+  SpanFunc xdigit;
+};
+
+template<template<typename> class Span>
+ScanFuncs make_scan_funcs(const char *isa) {
+  return {isa, &Span<SpaceClass>::run, &Span<IdentifierClass>::run, &Span<DigitClass>::run, &Span<XdigitClass>::run};
+}
+
+template<typename Class>
+struct ScalarSpan { static int run(const char *p, int index, int len) { return span_scalar<Class>(p, index, len); } };
+#ifdef SCOMPILER_X86_SIMD
+template<typename Class>
+struct SSE2Span { static int run(const char *p, int index, int len) { return span_sse2<Class>(p, index, len); } };
+template<typename Class>
+struct AVX2Span { static int run(const char *p, int index, int len) { return span_avx2<Class>(p, index, len); } };
+#endif
+
+const ScanFuncs &scan_funcs() {
+  static const ScanFuncs funcs = [] {
+#ifdef SCOMPILER_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return make_scan_funcs<AVX2Span>("avx2");
+    return make_scan_funcs<SSE2Span>("sse2");  // x86-64一定支持SSE2
+#else
+    return make_scan_funcs<ScalarSpan>("scalar");
+#endif
+  }();
+  return funcs;
+}
+
+// 大多数空白和数字序列都很短，先用标量判断第一个字符，避免一次间接调用
+template<typename Class>
+int span(std::string_view code, int index, SpanFunc func) {
+  int len = static_cast<int>(code.length());
+  if (index >= len || !Class::scalar(code[index])) return index;
+  return func(code.data(), index + 1, len);
+}
+
+#ifdef SCOMPILER_SWAR
+// 将最多8个数字字符读入uint64_t，第一个字符位于最高的有效字节之前，不足8个时在前面补0
+uint64_t load_digits(const char *first, int n) {
+  uint64_t chunk = 0;
+  std::memcpy(reinterpret_cast<char *>(&chunk) + (8 - n), first, n);
+  return chunk;
+}
+
+// SWAR: 一次将8个十进制数字字符转换为数值
+uint32_t dec8(uint64_t chunk) {
+  chunk = ((chunk & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+  chunk = ((chunk & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+  chunk = ((chunk & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32;
+  return static_cast<uint32_t>(chunk);
+}
+
+// SWAR: 一次将8个十六进制数字字符转换为数值
+uint32_t hex8(uint64_t chunk) {
+  // 字母的第6位为1, 'a'/'A'的低4位为1, 加9后得到10
+  uint64_t nibbles = (chunk & 0x0F0F0F0F0F0F0F0FULL) + ((chunk >> 6) & 0x0101010101010101ULL) * 9;
+  nibbles = ((nibbles << 4) | (nibbles >> 8)) & 0x00FF00FF00FF00FFULL;
+  nibbles = ((nibbles << 8) | (nibbles >> 16)) & 0x0000FFFF0000FFFFULL;
+  nibbles = ((nibbles << 16) | (nibbles >> 32)) & 0x00000000FFFFFFFFULL;
+  return static_cast<uint32_t>(nibbles);
+}
+
+constexpr uint32_t kPow10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+#endif
+
+}
+
+int skip_spaces(std::string_view code, int index) {
+  return span<SpaceClass>(code, index, scan_funcs().space);
+}
+
+int find_identifier_end(std::string_view code, int index) {
+  return span<IdentifierClass>(code, index, scan_funcs().identifier);
+}
+
+int find_digit_end(std::string_view code, int index) {
+  return span<DigitClass>(code, index, scan_funcs().digit);
+}
+
+int find_xdigit_end(std::string_view code, int index) {
+  return span<XdigitClass>(code, index, scan_funcs().xdigit);
+}
+
+int find_line_end(std::string_view code, int index) {
+  // memchr在常见的libc实现中已经做了向量化
+  const void *pos = std::memchr(code.data() + index, '\n', code.length() - index);
+  if (!pos) return static_cast<int>(code.length());
+  return static_cast<int>(static_cast<const char *>(pos) - code.data());
+}
+
+uint32_t parse_dec_digits(const char *first, const char *last) {
+  uint32_t value = 0;
+#ifdef SCOMPILER_SWAR
+  while (first != last) {
+    int n = last - first < 8 ? static_cast<int>(last - first) : 8;
+    value = value * kPow10[n] + dec8(load_digits(first, n));
+    first += n;
+  }
+#else
+  for (; first != last; ++first) {
+    value = value * 10 + (*first - '0');
+  }
+#endif
+  return value;
+}
+
+uint32_t parse_hex_digits(const char *first, const char *last) {
+  uint64_t value = 0;
+#ifdef SCOMPILER_SWAR
+  while (first != last) {
+    int n = last - first < 8 ? static_cast<int>(last - first) : 8;
+    value = (value << (4 * n)) | hex8(load_digits(first, n));
+    first += n;
+  }
+#else
+  for (; first != last; ++first) {
+    char c = *first;
+    int digit = c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+    value = (value << 4) | digit;
+  }
+#endif
+  return static_cast<uint32_t>(value);
+}
+
+const char *char_scanner_isa() {
+  return scan_funcs().isa;
+}
@@ -0,0 +1,52 @@
+#ifndef SCOMPILER_SRC_LEXER_CHAR_SCANNER_HPP_
+#define SCOMPILER_SRC_LEXER_CHAR_SCANNER_HPP_
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+// HandwrittenLexer使用的字符扫描函数
+// 字符分类使用查表实现，与locale无关；较长的字符序列在x86上使用SSE2/AVX2一次判断16/32个字符(运行时选择)
+
+namespace char_class {
+
+inline constexpr uint8_t kSpace = 1;      // ' ' '\t' '\n' '\v' '\f' '\r'
+inline constexpr uint8_t kDigit = 2;      // 0-9
+inline constexpr uint8_t kAlpha = 4;      // a-z A-Z _
+inline constexpr uint8_t kXdigit = 8;     // 0-9 a-f A-F
+
+inline constexpr std::array<uint8_t, 256> kTable = [] {
+  std::array<uint8_t, 256> table{};
+  for (int c = 0; c < 256; ++c) {
+    if (c == ' ' || (c >= '\t' && c <= '\r')) table[c] |= kSpace;
+    if (c >= '0' && c <= '9') table[c] |= kDigit | kXdigit;
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_') table[c] |= kAlpha;
+    if ((c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')) table[c] |= kXdigit;
+  }
+  return table;
+}();
+
+inline bool is_space(char c) { return kTable[static_cast<uint8_t>(c)] & kSpace; }
+inline bool is_digit(char c) { return kTable[static_cast<uint8_t>(c)] & kDigit; }
+inline bool is_xdigit(char c) { return kTable[static_cast<uint8_t>(c)] & kXdigit; }
+inline bool is_identifier_head(char c) { return kTable[static_cast<uint8_t>(c)] & kAlpha; }
+inline bool is_identifier_body(char c) { return kTable[static_cast<uint8_t>(c)] & (kAlpha | kDigit); }
+
+}
+
+// 以下函数返回从index开始第一个不满足条件的字符的下标(不存在则返回code.length())
+int skip_spaces(std::string_view code, int index);
+int find_identifier_end(std::string_view code, int index);
+int find_digit_end(std::string_view code, int index);
+int find_xdigit_end(std::string_view code, int index);
+// 返回index开始的第一个'\n'的下标
+int find_line_end(std::string_view code, int index);
+
+// 将[first, last)中的十进制/十六进制数字转换为数值，溢出时按照2^32取模(与逐位累加的结果一致)
+uint32_t parse_dec_digits(const char *first, const char *last);
+uint32_t parse_hex_digits(const char *first, const char *last);
+
+// 当前使用的扫描实现: "avx2", "sse2"或"scalar"
+const char *char_scanner_isa();
+
+#endif //SCOMPILER_SRC_LEXER_CHAR_SCANNER_HPP_
@@ -1,75 +1,46 @@
 #include "handwritten_lexer.hpp"
 
+#include "char_scanner.hpp"
 #include "compile_error.hpp"
-#include <cassert>
-#include <fstream>
+#include "source_buffer.hpp"
+
+#include <algorithm>
 
 // only support '//'
-bool skip_comment(const std::string &code, int &index) {
-  int len = code.length();
-  while (code[index] != '\n') {
-    ++index;
-    if (index == len) return false;
-  }
-  return true;
+bool skip_comment(std::string_view code, int &index) {
+  index = find_line_end(code, index);
+  return index != static_cast<int>(code.length());
 }
 
-bool skip_space(const std::string &code, int &index) {
-  int len = code.length();
-  while (index < len && isspace(code[index])) {
-    ++index;
-  }
-  if (index == len) return false;
-  return true;
+bool skip_space(std::string_view code, int &index) {
+  index = skip_spaces(code, index);
+  return index != static_cast<int>(code.length());
 }
 
-Token parse_string(const std::string &code, int &index) {
-  int len = code.length();
-  int i = index + 1;
-  while (i < len && code[i] != '"') {
-    ++i;
+void parse_identifier(std::string_view code, int &index, TokenStream &token_stream) {
+  int i = find_identifier_end(code, index + 1);
+  auto id = code.substr(index, i - index);
+  auto type = get_type_by_identifier(id);
+  if (type == TokenType::Identifier) {
+    token_stream.push_identifier(id, index);
+  } else {
+    token_stream.push(type, index);
   }
-  if (i == len) {
-    throw lex_error("parse string error");
-  }
-  std::string s = code.substr(index, i - index + 1);
-  index = i;
-  return Token(TokenType::String, s);
-}
-
-Token parse_identifier(const std::string &code, int &index) {
-  int len = code.length();
-  int i = index + 1;
-  while (i < len && (isalnum(code[i]) || code[i] == '_')) {
-    ++i;
-  }
-  std::string id = code.substr(index, i - index);
   index = i - 1;
-  return get_token_by_identifier(id);
 }
 
-Token parse_hex(const std::string &code, int &index) {
-  auto to_num = [](char c) {
-    if (c >= '0' && c <= '9') return c - '0';
-    if (c >= 'a' && c <= 'f') return 10 + c - 'a';
-    if (c >= 'A' && c <= 'F') return 10 + c - 'A';
-    assert(false);
-  };
-  int len = code.length();
+void parse_hex(std::string_view code, int &index, TokenStream &token_stream) {
   int i = index + 2;
-  if (i == len) {
-    throw lex_error("invalid hex number");
-  }
-  int value = 0;
-  while (i < len && isxdigit(code[i])) {
-    value = value * 16 + to_num(code[i]);
-    ++i;
+  int end = find_xdigit_end(code, i);
+  if (end == i) {  // 0x之后至少要有一个十六进制数字
+    throw lex_error("invalid hex number", index);
   }
-  index = i - 1;
-  return Token(TokenType::Number, value);
+  auto value = parse_hex_digits(code.data() + i, code.data() + end);
+  token_stream.push_number(static_cast<int>(value), index);
+  index = end - 1;
 }
 
-Token parse_oct(const std::string &code, int &index) {
+void parse_oct(std::string_view code, int &index, TokenStream &token_stream) {
   auto is_oct_num = [] (char c) {
     return c >= '0' && c <= '7';
   };
@@ -80,163 +51,158 @@ Token parse_oct(const std::string &code, int &index) {
     value = value * 8 + (code[i] - '0');
     ++i;
   }
+  token_stream.push_number(value, index);
   index = i - 1;
-  return Token(TokenType::Number, value);
 }
 
-Token parse_dec(const std::string &code, int &index) {
-  int len = code.length();
-  int i = index;
-  int value = 0;
-  while (i < len && isdigit(code[i])) {
-    value = value * 10 + (code[i] - '0');
-    ++i;
-  }
-  index = i - 1;
-  return Token(TokenType::Number, value);
+void parse_dec(std::string_view code, int &index, TokenStream &token_stream) {
+  int end = find_digit_end(code, index);
+  auto value = parse_dec_digits(code.data() + index, code.data() + end);
+  token_stream.push_number(static_cast<int>(value), index);
+  index = end - 1;
 }
 
-Token parse_number(const std::string &code, int &index) {
+void parse_number(std::string_view code, int &index, TokenStream &token_stream) {
   int len = code.length();
   if (code[index] == '0') {
     if ((index + 1 < len) && (code[index + 1] == 'x' || code[index + 1] == 'X')) {
-      return parse_hex(code, index);
+      return parse_hex(code, index, token_stream);
     }
     if (index + 1 < len) {
-      return parse_oct(code, index);
+      return parse_oct(code, index, token_stream);
     }
   }
-  return parse_dec(code, index);
+  return parse_dec(code, index, token_stream);
 }
 
 // no lineno
-std::vector<Token> HandwrittenLexer::lex(const std::string &code) {
-  std::vector<Token> token_vec;
-  int index = 0, length = code.length();
-  while (index < length) {
-    if (!skip_space(code, index)) break;
+TokenStream HandwrittenLexer::lex(std::string_view code) {
+  TokenStream token_stream;
+  lex_range(code, 0, code.length(), token_stream);
+  return token_stream;
+}
+
+int HandwrittenLexer::lex_range(std::string_view code, int begin, int end, TokenStream &token_stream) {
+  int index = begin, length = code.length();
+  while (index < end) {
+    if (!skip_space(code, index) || index >= end) return end;
+    int begin = index;
     switch (code[index]) {
       case '(':
-        token_vec.emplace_back(TokenType::Lparen, "(");
+        token_stream.push(TokenType::Lparen, begin);
         break;
       case ')':
-        token_vec.emplace_back(TokenType::Rparen, ")");
+        token_stream.push(TokenType::Rparen, begin);
         break;
       case '[':
-        token_vec.emplace_back(TokenType::LSbrace, "[");
+        token_stream.push(TokenType::LSbrace, begin);
         break;
       case ']':
-        token_vec.emplace_back(TokenType::RSbrace, "]");
+        token_stream.push(TokenType::RSbrace, begin);
         break;
       case '{':
-        token_vec.emplace_back(TokenType::LCbrace, "{");
+        token_stream.push(TokenType::LCbrace, begin);
         break;
       case '}':
-        token_vec.emplace_back(TokenType::RCbrace, "}");
+        token_stream.push(TokenType::RCbrace, begin);
         break;
       case ';':
-        token_vec.emplace_back(TokenType::Semicolon, ";");
+        token_stream.push(TokenType::Semicolon, begin);
         break;
       case ',':
-        token_vec.emplace_back(TokenType::Comma, ",");
+        token_stream.push(TokenType::Comma, begin);
         break;
       case '-':
-        token_vec.emplace_back(TokenType::Sub, "-");
+        token_stream.push(TokenType::Sub, begin);
         break;
       case '+':
-        token_vec.emplace_back(TokenType::Add, "+");
+        token_stream.push(TokenType::Add, begin);
         break;
       case '*':
-        token_vec.emplace_back(TokenType::Times, "*");
+        token_stream.push(TokenType::Times, begin);
         break;
       case '/':
         if ((index + 1 < length) && code[index + 1] == '/') {
           if (!skip_comment(code, index)) break;
         } else {
-          token_vec.emplace_back(TokenType::Divide, "/");
+          token_stream.push(TokenType::Divide, begin);
         }
         break;
       case '%':
-        token_vec.emplace_back(TokenType::Mod, "%");
+        token_stream.push(TokenType::Mod, begin);
         break;
       case '~':
-        token_vec.emplace_back(TokenType::Not, "~");
+        token_stream.push(TokenType::Not, begin);
         break;
       case '!':
         if ((index + 1 < length) && code[index + 1] == '=') {
           ++index;
-          token_vec.emplace_back(TokenType::Nequal, "!=");
+          token_stream.push(TokenType::Nequal, begin);
         } else {
-          token_vec.emplace_back(TokenType::Lnot, "!");
+          token_stream.push(TokenType::Lnot, begin);
         }
         break;
       case '|':
         if ((index + 1 < length) && code[index + 1] == '|') {
           ++index;
-          token_vec.emplace_back(TokenType::Lor, "||");
+          token_stream.push(TokenType::Lor, begin);
         } else {
-          token_vec.emplace_back(TokenType::Or, "|");
+          token_stream.push(TokenType::Or, begin);
         }
         break;
       case '&':
         if ((index + 1 < length) && code[index + 1] == '&') {
           ++index;
-          token_vec.emplace_back(TokenType::Land, "&&");
+          token_stream.push(TokenType::Land, begin);
         } else {
-          token_vec.emplace_back(TokenType::And, "&");
+          token_stream.push(TokenType::And, begin);
         }
         break;
       case '=':
         if ((index + 1 < length) && code[index + 1] == '=') {
           ++index;
-          token_vec.emplace_back(TokenType::Equal, "==");
+          token_stream.push(TokenType::Equal, begin);
         } else {
-          token_vec.emplace_back(TokenType::Assign, "=");
+          token_stream.push(TokenType::Assign, begin);
         }
         break;
       case '<':
         if ((index + 1 < length) && code[index + 1] == '=') {
           ++index;
-          token_vec.emplace_back(TokenType::Le, "<=");
+          token_stream.push(TokenType::Le, begin);
         } else {
-          token_vec.emplace_back(TokenType::Less, "<");
+          token_stream.push(TokenType::Less, begin);
         }
         break;
       case '>':
         if ((index + 1 < length) && code[index + 1] == '=') {
           ++index;
-          token_vec.emplace_back(TokenType::Ge, ">=");
+          token_stream.push(TokenType::Ge, begin);
         } else {
-          token_vec.emplace_back(TokenType::Greater, ">");
+          token_stream.push(TokenType::Greater, begin);
         }
         break;
       case '?':
-        token_vec.emplace_back(TokenType::Question, "?");
+        token_stream.push(TokenType::Question, begin);
         break;
       case ':':
-        token_vec.emplace_back(TokenType::Colon, ":");
-        break;
-      case '"': {
-        token_vec.push_back(parse_string(code, index));
+        token_stream.push(TokenType::Colon, begin);
         break;
-      }
       default:
-        if (isalpha(code[index]) || code[index] == '_') {
-          token_vec.push_back(parse_identifier(code, index));
-        } else if (isdigit(code[index])) {
-          token_vec.push_back(parse_number(code, index));
+        if (char_class::is_identifier_head(code[index])) {
+          parse_identifier(code, index, token_stream);
+        } else if (char_class::is_digit(code[index])) {
+          parse_number(code, index, token_stream);
         } else {
-          std::string msg = std::string("unknown charactor: ") + code[index];
-          throw lex_error(msg);
+          std::string msg = std::string("unknown character: ") + code[index];
+          throw lex_error(msg, index);
         }
     }
     ++index;
   }
-  return token_vec;
+  return std::min(index, length);
 }
-std::vector<Token> HandwrittenLexer::lex_file(const fs::path &file) {
-  std::ifstream ifs(file);
-  std::stringstream ss;
-  ss << ifs.rdbuf();
-  return lex(ss.str());
+TokenStream HandwrittenLexer::lex_file(const fs::path &file) {
+  SourceBuffer source(file);
+  return lex(source.view());
 }
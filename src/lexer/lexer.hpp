@@ -2,19 +2,62 @@
 #define SCOMPILER_LEXER_LEXER_HPP_
 
 #include "handwritten_lexer.hpp"
+#include "parallel_lexer.hpp"
 #include "spirit_lexer.hpp"
+#include "table_lexer.hpp"
 #include "token_stream.hpp"
+#include "compile_error.hpp"
+#include "source_buffer.hpp"
 
-using Lexer = SpiritLexer;
+// 默认的实现，可以通过--lexer选项在运行时选择其他实现
+using Lexer = HandwrittenLexer;
 
-inline TokenStream lex(const std::string &code) {
+inline TokenStream lex(std::string_view code) {
   Lexer lexer;
-  return TokenStream(lexer.lex(code));
+  return lexer.lex(code);
 }
 
 inline TokenStream lex_file(const fs::path& file) {
   Lexer lexer;
-  return TokenStream(lexer.lex_file(file));
+  return lexer.lex_file(file);
+}
+
+template<typename Lexer>
+TokenStream lex_with(std::string_view code, int jobs) {
+  if (jobs > 1) {
+    return ParallelLexer<Lexer>(jobs).lex(code);
+  }
+  return Lexer().lex(code);
+}
+
+// lexer_name: "spirit", "handwritten"或"table"; jobs > 1时并行地进行词法分析
+inline TokenStream lex(std::string_view code, const std::string &lexer_name, int jobs = 1) {
+  if (lexer_name == "handwritten") {
+    return lex_with<HandwrittenLexer>(code, jobs);
+  } else if (lexer_name == "table") {
+    return lex_with<TableLexer>(code, jobs);
+  } else if (lexer_name == "spirit") {
+    return lex_with<SpiritLexer>(code, jobs);
+  }
+  throw lex_error("unknown lexer: " + lexer_name);
+}
+
+// 只分析code中在[begin, end)内开始的token，结果追加到token_stream中，供增量分析使用
+inline int lex_range(std::string_view code, int begin, int end, TokenStream &token_stream,
+                     const std::string &lexer_name) {
+  if (lexer_name == "handwritten") {
+    return HandwrittenLexer().lex_range(code, begin, end, token_stream);
+  } else if (lexer_name == "table") {
+    return TableLexer().lex_range(code, begin, end, token_stream);
+  } else if (lexer_name == "spirit") {
+    return SpiritLexer().lex_range(code, begin, end, token_stream);
+  }
+  throw lex_error("unknown lexer: " + lexer_name);
+}
+
+inline TokenStream lex_file(const fs::path& file, const std::string &lexer_name, int jobs = 1) {
+  SourceBuffer source(file);
+  return lex(source.view(), lexer_name, jobs);
 }
 
 #endif //SCOMPILER_LEXER_LEXER_HPP_
@@ -0,0 +1,104 @@
+#include "parallel_lexer.hpp"
+
+#include "char_scanner.hpp"
+#include "handwritten_lexer.hpp"
+#include "source_buffer.hpp"
+#include "spirit_lexer.hpp"
+#include "table_lexer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 每段至少包含的字节数，避免小文件被切得过碎
+constexpr std::size_t kMinChunkSize = 64 * 1024;
+// 段数取线程数的若干倍，使各线程的负载更均衡
+constexpr int kChunksPerJob = 4;
+
+// 返回各段的分界点，第一个为0，最后一个为code.length()，除此之外都紧跟在'\n'之后
+std::vector<int> split_chunks(std::string_view code, int jobs) {
+  int length = code.length();
+  int chunk_count = std::min<std::size_t>(jobs * kChunksPerJob, code.length() / kMinChunkSize);
+  std::vector<int> bounds{0};
+  for (int i = 1; i < chunk_count; ++i) {
+    int pos = find_line_end(code, static_cast<int>(static_cast<int64_t>(length) * i / chunk_count)) + 1;
+    if (pos >= length) break;
+    if (pos > bounds.back()) bounds.push_back(pos);
+  }
+  bounds.push_back(length);
+  return bounds;
+}
+
+struct ChunkResult {
+  TokenStream token_stream;
+  int resume{0};
+  std::exception_ptr error;  // 该段的结果可能会作废，所以先保存异常，拼接时再抛出
+};
+
+}
+
+template<typename Lexer>
+TokenStream ParallelLexer<Lexer>::lex(std::string_view code) {
+  auto bounds = split_chunks(code, jobs_);
+  int chunk_count = bounds.size() - 1;
+  if (jobs_ <= 1 || chunk_count <= 1) {
+    return Lexer().lex(code);
+  }
+
+  std::vector<ChunkResult> results(chunk_count);
+  std::atomic<int> next_chunk{0};
+  auto worker = [&] {
+    Lexer lexer;
+    for (int i = next_chunk++; i < chunk_count; i = next_chunk++) {
+      try {
+        results[i].resume = lexer.lex_range(code, bounds[i], bounds[i + 1], results[i].token_stream);
+      } catch (...) {
+        results[i].error = std::current_exception();
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int i = 1; i < std::min(jobs_, chunk_count); ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // 第一段一定有效，直接使用它的结果，其余的段按顺序拼接在后面
+  if (results[0].error) std::rethrow_exception(results[0].error);
+  std::size_t total = 0;
+  for (const auto &result : results) {
+    total += result.token_stream.size();
+  }
+  TokenStream token_stream = std::move(results[0].token_stream);
+  token_stream.reserve(total);
+  int resume = results[0].resume;
+  Lexer lexer;
+  for (int i = 1; i < chunk_count; ++i) {
+    if (resume == bounds[i]) {
+      if (results[i].error) std::rethrow_exception(results[i].error);
+      token_stream.append(results[i].token_stream);
+      resume = results[i].resume;
+    } else if (resume < bounds[i + 1]) {
+      // 上一个token跨过了分界点，该段的结果作废
+      resume = lexer.lex_range(code, resume, bounds[i + 1], token_stream);
+    }
+  }
+  return token_stream;
+}
+
+template<typename Lexer>
+TokenStream ParallelLexer<Lexer>::lex_file(const fs::path &file) {
+  SourceBuffer source(file);
+  return lex(source.view());
+}
+
+template class ParallelLexer<HandwrittenLexer>;
+template class ParallelLexer<TableLexer>;
+template class ParallelLexer<SpiritLexer>;
@@ -0,0 +1,28 @@
+#ifndef SCOMPILER_SRC_LEXER_PARALLEL_LEXER_HPP_
+#define SCOMPILER_SRC_LEXER_PARALLEL_LEXER_HPP_
+
+#include "token_stream.hpp"
+
+#include <string>
+#include <string_view>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// 将源文件在换行处切分为若干段，由多个线程同时对各段进行词法分析，再按顺序拼接
+// 每一段都假设自己从token的边界开始(换行之后不可能处于注释中，但可能处于跨行的字符串中)；
+// 若前一段的最后一个token跨过了分界点，则该段的结果作废，从前一段实际结束的位置开始重新分析
+// Lexer需要提供lex_range接口，见HandwrittenLexer
+template<typename Lexer>
+class ParallelLexer {
+ public:
+  explicit ParallelLexer(int jobs) : jobs_(jobs) {}
+  ~ParallelLexer() = default;
+
+  TokenStream lex(std::string_view code);
+  TokenStream lex_file(const fs::path &file);
+ private:
+  int jobs_;
+};
+
+#endif //SCOMPILER_SRC_LEXER_PARALLEL_LEXER_HPP_
@@ -1,267 +1,215 @@
 #include "spirit_lexer.hpp"
 
 #include "compile_error.hpp"
+#include "spirit_lexer_def.hpp"
+#include "source_buffer.hpp"
 
-#include <fstream>
-#include <boost/spirit/include/lex_lexertl.hpp>
+#include <algorithm>
+#include <iostream>
 
-namespace lex = boost::spirit::lex;
-
-enum ID {
-  ID_IDENTIFIER = 100,
-  ID_NEWLINE,
-  ID_SPACE,
-  ID_COMMENT,
-  ID_DECNUMBER,
-  ID_HEXNUMBER,
-  ID_OCTNUMBER,
-  ID_LPAREN,
-  ID_RPAREN,
-  ID_LSBRACE,
-  ID_RSBRACE,
-  ID_RCBRACE,
-  ID_LCBRACE,
-  ID_SEMICOLON,
-  ID_COMMA,
-  ID_SUB,
-  ID_ADD,
-  ID_TIMES,
-  ID_DIVIDE,
-  ID_MOD,
-  ID_NOT,
-  ID_LNOT,
-  ID_OR,
-  ID_LOR,
-  ID_AND,
-  ID_LAND,
-  ID_ASSIGN,
-  ID_GREATER,
-  ID_LESS,
-  ID_EQUAL,
-  ID_NEQUAL,
-  ID_GE,
-  ID_LE,
-  ID_QUESTION,
-  ID_COLON,
-  ID_STRING,
-  ID_UNKNOWN,
-};
-
-template<typename Lexer>
-class TLexer : public lex::lexer<Lexer> {
- public:
-  TLexer() {
-    this->self.add
-        (R"([a-zA-Z_][a-zA-Z0-9_]*)", ID_IDENTIFIER)
-        (R"([\n\r]+)", ID_NEWLINE)
-        (R"([ \t])", ID_SPACE)
-        (R"(\/\/.*?\n)", ID_COMMENT)
-        (R"(0[xX][0-9a-fA-F]+)", ID_HEXNUMBER)
-        (R"(0[0-7]*)", ID_OCTNUMBER)
-        (R"([1-9][0-9]*)", ID_DECNUMBER)
-        (R"(\()", ID_LPAREN)
-        (R"(\))", ID_RPAREN)
-        (R"(\[)", ID_LSBRACE)
-        (R"(\])", ID_RSBRACE)
-        (R"(\{)", ID_LCBRACE)
-        (R"(\})", ID_RCBRACE)
-        (R"(;)", ID_SEMICOLON)
-        (R"(,)", ID_COMMA)
-        (R"(-)", ID_SUB)
-        (R"(\+)", ID_ADD)
-        (R"(\*)", ID_TIMES)
-        (R"(\/)", ID_DIVIDE)
-        (R"(%)", ID_MOD)
-        (R"(~)", ID_NOT)
-        (R"(!=)", ID_NEQUAL)
-        (R"(!)", ID_LNOT)
-        (R"(\|\|)", ID_LOR)
-        (R"(\|)", ID_OR)
-        (R"(&&)", ID_LAND)
-        (R"(&)", ID_AND)
-        (R"(==)", ID_EQUAL)
-        (R"(>=)", ID_GE)
-        (R"(<=)", ID_LE)
-        (R"(<)", ID_LESS)
-        (R"(>)", ID_GREATER)
-        (R"(=)", ID_ASSIGN)
-        (R"(\?)", ID_QUESTION)
-        (R"(:)", ID_COLON)
-        (R"(\".*?\")", ID_STRING)
-        (R"(.)", ID_UNKNOWN);
-  }
-};
+#ifdef SCOMPILER_STATIC_LEXER
+#include <boost/spirit/include/lex_static_lexertl.hpp>
+#include "spirit_lexer_static.hpp"
+// 使用构建时生成的DFA表(见spirit_lexer_generator.cpp)，运行时无需再编译正则表达式
+using LexerType = lex::lexertl::static_lexer<lex::lexertl::token<>, lex::lexertl::static_::lexer_scompiler>;
+#else
+using LexerType = lex::lexertl::lexer<>;
+#endif
 
 class Tokenizer {
  public:
+  explicit Tokenizer(const char *code) : code_(code) {}
+
   template<typename T>
-  bool operator()(const T &t, std::vector<Token> &token_vec) const {
-    std::string t_str(t.value().begin(), t.value().end());
+  bool operator()(const T &t, TokenStream &token_stream) const {
+    std::string_view t_str(t.value().begin(), t.value().size());
+    auto offset = static_cast<SourceOffset>(t.value().begin() - code_);
     switch (t.id()) {
       case ID_IDENTIFIER: {
-        token_vec.push_back(get_token_by_identifier(t_str));
+        auto type = get_type_by_identifier(t_str);
+        if (type == TokenType::Identifier) {
+          token_stream.push_identifier(t_str, offset);
+        } else {
+          token_stream.push(type, offset);
+        }
         break;
       }
       case ID_NEWLINE:
       case ID_SPACE:
       case ID_COMMENT: break;
       case ID_HEXNUMBER: {
-        int num = std::stoi(t_str, nullptr, 16);
-        token_vec.emplace_back(TokenType::Number, num);
+        int num = std::stoi(std::string(t_str), nullptr, 16);
+        token_stream.push_number(num, offset);
         break;
       }
       case ID_OCTNUMBER: {
-        int num = std::stoi(t_str, nullptr, 8);
-        token_vec.emplace_back(TokenType::Number, num);
+        int num = std::stoi(std::string(t_str), nullptr, 8);
+        token_stream.push_number(num, offset);
         break;
       }
       case ID_DECNUMBER: {
-        int num = std::stoi(t_str);
-        token_vec.emplace_back(TokenType::Number, num);
+        int num = std::stoi(std::string(t_str));
+        token_stream.push_number(num, offset);
         break;
       }
       case ID_LPAREN: {
-        token_vec.emplace_back(TokenType::Lparen, "(");
+        token_stream.push(TokenType::Lparen, offset);
         break;
       }
       case ID_RPAREN: {
-        token_vec.emplace_back(TokenType::Rparen, ")");
+        token_stream.push(TokenType::Rparen, offset);
         break;
       }
       case ID_LSBRACE: {
-        token_vec.emplace_back(TokenType::LSbrace, "[");
+        token_stream.push(TokenType::LSbrace, offset);
         break;
       }
       case ID_RSBRACE: {
-        token_vec.emplace_back(TokenType::RSbrace, "]");
+        token_stream.push(TokenType::RSbrace, offset);
         break;
       }
       case ID_LCBRACE: {
-        token_vec.emplace_back(TokenType::LCbrace, "{");
+        token_stream.push(TokenType::LCbrace, offset);
         break;
       }
       case ID_RCBRACE: {
-        token_vec.emplace_back(TokenType::RCbrace, "}");
+        token_stream.push(TokenType::RCbrace, offset);
         break;
       }
       case ID_SEMICOLON: {
-        token_vec.emplace_back(TokenType::Semicolon, ";");
+        token_stream.push(TokenType::Semicolon, offset);
         break;
       }
       case ID_COMMA: {
-        token_vec.emplace_back(TokenType::Comma, ",");
+        token_stream.push(TokenType::Comma, offset);
         break;
       }
       case ID_SUB: {
-        token_vec.emplace_back(TokenType::Sub, "-");
+        token_stream.push(TokenType::Sub, offset);
         break;
       }
       case ID_ADD: {
-        token_vec.emplace_back(TokenType::Add, "+");
+        token_stream.push(TokenType::Add, offset);
         break;
       }
       case ID_TIMES: {
-        token_vec.emplace_back(TokenType::Times, "*");
+        token_stream.push(TokenType::Times, offset);
         break;
       }
       case ID_DIVIDE: {
-        token_vec.emplace_back(TokenType::Divide, "/");
+        token_stream.push(TokenType::Divide, offset);
         break;
       }
       case ID_MOD: {
-        token_vec.emplace_back(TokenType::Mod, "%");
+        token_stream.push(TokenType::Mod, offset);
         break;
       }
       case ID_NOT: {
-        token_vec.emplace_back(TokenType::Not, "~");
+        token_stream.push(TokenType::Not, offset);
         break;
       }
       case ID_LNOT: {
-        token_vec.emplace_back(TokenType::Lnot, "!");
+        token_stream.push(TokenType::Lnot, offset);
         break;
       }
       case ID_OR: {
-        token_vec.emplace_back(TokenType::Or, "|");
+        token_stream.push(TokenType::Or, offset);
         break;
       }
       case ID_LOR: {
-        token_vec.emplace_back(TokenType::Lor, "||");
+        token_stream.push(TokenType::Lor, offset);
         break;
       }
       case ID_AND: {
-        token_vec.emplace_back(TokenType::And, "&");
+        token_stream.push(TokenType::And, offset);
         break;
       }
       case ID_LAND: {
-        token_vec.emplace_back(TokenType::Land, "&&");
+        token_stream.push(TokenType::Land, offset);
         break;
       }
       case ID_ASSIGN: {
-        token_vec.emplace_back(TokenType::Assign, "=");
+        token_stream.push(TokenType::Assign, offset);
         break;
       }
       case ID_GREATER: {
-        token_vec.emplace_back(TokenType::Greater, ">");
+        token_stream.push(TokenType::Greater, offset);
         break;
       }
       case ID_LESS: {
-        token_vec.emplace_back(TokenType::Less, "<");
+        token_stream.push(TokenType::Less, offset);
         break;
       }
       case ID_EQUAL: {
-        token_vec.emplace_back(TokenType::Equal, "==");
+        token_stream.push(TokenType::Equal, offset);
         break;
       }
       case ID_NEQUAL: {
-        token_vec.emplace_back(TokenType::Nequal, "!=");
+        token_stream.push(TokenType::Nequal, offset);
         break;
       }
       case ID_GE: {
-        token_vec.emplace_back(TokenType::Ge, ">=");
+        token_stream.push(TokenType::Ge, offset);
         break;
       }
       case ID_LE: {
-        token_vec.emplace_back(TokenType::Le, "<=");
+        token_stream.push(TokenType::Le, offset);
         break;
       }
       case ID_QUESTION: {
-        token_vec.emplace_back(TokenType::Question, "?");
+        token_stream.push(TokenType::Question, offset);
         break;
       }
       case ID_COLON: {
-        token_vec.emplace_back(TokenType::Colon, ":");
+        token_stream.push(TokenType::Colon, offset);
         break;
       }
       case ID_STRING: {
-        token_vec.emplace_back(TokenType::String, t_str);
+        token_stream.push_string(t_str, offset);
         break;
       }
       case ID_UNKNOWN:
         std::cout << "ID_UNKNOWN: ";
       default:
-        throw lex_error("unknown character: " + t_str);
+        throw lex_error("unknown character: " + std::string(t_str), offset);
     }
     return true;
   }
+ private:
+  const char *code_;  // 源文件的开头，用于计算token的偏移
 };
 
-std::vector<Token> SpiritLexer::lex(const std::string &code) {
-  std::vector<Token> token_vec;
-  TLexer<lex::lexertl::lexer<>> tlexer;
-  Tokenizer tokenizer;
-  const char *first = code.c_str();
-  const char *last = &first[code.size()];
+TokenStream SpiritLexer::lex(std::string_view code) {
+  TokenStream token_stream;
+  lex_range(code, 0, code.length(), token_stream);
+  return token_stream;
+}
+
+int SpiritLexer::lex_range(std::string_view code, int begin, int end, TokenStream &token_stream) {
+  TLexer<LexerType> tlexer;
+  Tokenizer tokenizer(code.data());
+  const char *first = code.data() + begin;
+  const char *last = code.data() + code.size();
+  const char *range_end = code.data() + end;
+  const char *resume = range_end;
+  bool stopped = false;
   bool r = lex::tokenize(first, last,
                          tlexer,
-                         [tokenizer, &token_vec](auto &&PH1) {
-                           return tokenizer(std::forward<decltype(PH1)>(PH1), token_vec);
+                         [&](const auto &t) {
+                           if (t.value().begin() >= range_end) {
+                             stopped = true;
+                             return false;
+                           }
+                           auto id = t.id();
+                           if (id != ID_SPACE && id != ID_NEWLINE && id != ID_COMMENT) {
+                             resume = std::max(resume, t.value().end());
+                           }
+                           return tokenizer(t, token_stream);
                          });
-  assert(r);
-  return token_vec;
+  assert(r || stopped);
+  return static_cast<int>(resume - code.data());
 }
-std::vector<Token> SpiritLexer::lex_file(const fs::path &file) {
-  std::ifstream ifs(file);
-  std::stringstream ss;
-  ss << ifs.rdbuf();
-  return lex(ss.str());
+TokenStream SpiritLexer::lex_file(const fs::path &file) {
+  SourceBuffer source(file);
+  return lex(source.view());
 }
@@ -0,0 +1,95 @@
+#ifndef SCOMPILER_SRC_LEXER_SPIRIT_LEXER_DEF_HPP_
+#define SCOMPILER_SRC_LEXER_SPIRIT_LEXER_DEF_HPP_
+
+#include <boost/spirit/include/lex_lexertl.hpp>
+
+namespace lex = boost::spirit::lex;
+
+// TLexer的定义同时被SpiritLexer和spirit_lexer_generator使用
+// 后者在构建时将其编译为静态的DFA表(spirit_lexer_static.hpp)
+enum ID {
+  ID_IDENTIFIER = 100,
+  ID_NEWLINE,
+  ID_SPACE,
+  ID_COMMENT,
+  ID_DECNUMBER,
+  ID_HEXNUMBER,
+  ID_OCTNUMBER,
+  ID_LPAREN,
+  ID_RPAREN,
+  ID_LSBRACE,
+  ID_RSBRACE,
+  ID_RCBRACE,
+  ID_LCBRACE,
+  ID_SEMICOLON,
+  ID_COMMA,
+  ID_SUB,
+  ID_ADD,
+  ID_TIMES,
+  ID_DIVIDE,
+  ID_MOD,
+  ID_NOT,
+  ID_LNOT,
+  ID_OR,
+  ID_LOR,
+  ID_AND,
+  ID_LAND,
+  ID_ASSIGN,
+  ID_GREATER,
+  ID_LESS,
+  ID_EQUAL,
+  ID_NEQUAL,
+  ID_GE,
+  ID_LE,
+  ID_QUESTION,
+  ID_COLON,
+  ID_STRING,
+  ID_UNKNOWN,
+};
+
+template<typename Lexer>
+class TLexer : public lex::lexer<Lexer> {
+ public:
+  TLexer() {
+    this->self.add
+        (R"([a-zA-Z_][a-zA-Z0-9_]*)", ID_IDENTIFIER)
+        (R"([\n\r]+)", ID_NEWLINE)
+        (R"([ \t])", ID_SPACE)
+        (R"(\/\/.*?\n)", ID_COMMENT)
+        (R"(0[xX][0-9a-fA-F]+)", ID_HEXNUMBER)
+        (R"(0[0-7]*)", ID_OCTNUMBER)
+        (R"([1-9][0-9]*)", ID_DECNUMBER)
+        (R"(\()", ID_LPAREN)
+        (R"(\))", ID_RPAREN)
+        (R"(\[)", ID_LSBRACE)
+        (R"(\])", ID_RSBRACE)
+        (R"(\{)", ID_LCBRACE)
+        (R"(\})", ID_RCBRACE)
+        (R"(;)", ID_SEMICOLON)
+        (R"(,)", ID_COMMA)
+        (R"(-)", ID_SUB)
+        (R"(\+)", ID_ADD)
+        (R"(\*)", ID_TIMES)
+        (R"(\/)", ID_DIVIDE)
+        (R"(%)", ID_MOD)
+        (R"(~)", ID_NOT)
+        (R"(!=)", ID_NEQUAL)
+        (R"(!)", ID_LNOT)
+        (R"(\|\|)", ID_LOR)
+        (R"(\|)", ID_OR)
+        (R"(&&)", ID_LAND)
+        (R"(&)", ID_AND)
+        (R"(==)", ID_EQUAL)
+        (R"(>=)", ID_GE)
+        (R"(<=)", ID_LE)
+        (R"(<)", ID_LESS)
+        (R"(>)", ID_GREATER)
+        (R"(=)", ID_ASSIGN)
+        (R"(\?)", ID_QUESTION)
+        (R"(:)", ID_COLON)
+        (R"(\".*?\")", ID_STRING)
+        (R"(.)", ID_UNKNOWN);
+  }
+};
+
+#endif //SCOMPILER_SRC_LEXER_SPIRIT_LEXER_DEF_HPP_
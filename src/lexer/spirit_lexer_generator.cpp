@@ -0,0 +1,18 @@
+// 构建时运行，将TLexer中的正则表达式编译为DFA并生成静态表
+// 用法: spirit_lexer_generator <output-file>
+#include "spirit_lexer_def.hpp"
+
+#include <boost/spirit/include/lex_generate_static_lexertl.hpp>
+
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    std::cerr << "Usage: spirit_lexer_generator <output-file>\n";
+    return 1;
+  }
+  std::ofstream ofs(argv[1]);
+  TLexer<lex::lexertl::lexer<>> tlexer;
+  return lex::lexertl::generate_static_switch(tlexer, ofs, "scompiler") ? 0 : 1;
+}
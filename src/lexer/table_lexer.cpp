@@ -0,0 +1,233 @@
+#include "table_lexer.hpp"
+
+#include "char_scanner.hpp"
+#include "compile_error.hpp"
+#include "source_buffer.hpp"
+
+#include <array>
+
+namespace {
+
+// DFA的状态，Dead表示无法继续转移
+enum State : uint8_t {
+  Dead,
+  Start,
+  Space,
+  Comment,    // "//"之后，直到'\n'之前
+  Ident,
+  Zero,       // "0"
+  Oct,        // "0[0-7]+"
+  Dec,        // "[1-9][0-9]*"
+  HexPrefix,  // "0x"
+  Hex,        // "0x[0-9a-fA-F]+"
+  Slash,
+  Bang,
+  Pipe,
+  Amp,
+  AssignOp,
+  LessOp,
+  GreaterOp,
+  Single,     // 单字符的标点符号，具体类型由kSingleType给出
+  Double,     // 双字符的标点符号，具体类型由第一个字符对应的状态给出
+  StateCount,
+};
+
+// 到达某个状态后(不能继续转移时)需要执行的动作
+enum class Action : uint8_t {
+  Error,
+  Skip,
+  Identifier,
+  Oct,
+  Dec,
+  Hex,
+  Punctuation,
+};
+
+using TransitionTable = std::array<std::array<State, 256>, StateCount>;
+
+constexpr void set_range(TransitionTable &table, State from, char lo, char hi, State to) {
+  for (int c = static_cast<unsigned char>(lo); c <= static_cast<unsigned char>(hi); ++c) {
+    table[from][c] = to;
+  }
+}
+
+constexpr void set_chars(TransitionTable &table, State from, std::string_view chars, State to) {
+  for (char c : chars) table[from][static_cast<unsigned char>(c)] = to;
+}
+
+constexpr void set_identifier_body(TransitionTable &table, State from, State to) {
+  set_range(table, from, 'a', 'z', to);
+  set_range(table, from, 'A', 'Z', to);
+  set_range(table, from, '0', '9', to);
+  set_chars(table, from, "_", to);
+}
+
+// 以字符为下标(而非字符类别)，每步只需要查一次表
+constexpr TransitionTable kTransition = [] {
+  TransitionTable table{};
+  constexpr std::string_view spaces = " \t\n\v\f\r";
+  set_chars(table, Start, spaces, Space);
+  set_chars(table, Space, spaces, Space);
+
+  set_range(table, Start, 'a', 'z', Ident);
+  set_range(table, Start, 'A', 'Z', Ident);
+  set_chars(table, Start, "_", Ident);
+  set_identifier_body(table, Ident, Ident);
+
+  set_chars(table, Start, "0", Zero);
+  set_range(table, Zero, '0', '7', Oct);
+  set_range(table, Oct, '0', '7', Oct);
+  set_range(table, Start, '1', '9', Dec);
+  set_range(table, Dec, '0', '9', Dec);
+  set_chars(table, Zero, "xX", HexPrefix);
+  for (State from : {HexPrefix, Hex}) {
+    set_range(table, from, '0', '9', Hex);
+    set_range(table, from, 'a', 'f', Hex);
+    set_range(table, from, 'A', 'F', Hex);
+  }
+
+  set_chars(table, Start, "/", Slash);
+  set_chars(table, Slash, "/", Comment);
+  set_range(table, Comment, '\0', '\xff', Comment);
+  set_chars(table, Comment, "\n", Dead);
+
+  set_chars(table, Start, "()[]{};,-+*%~?:", Single);
+  set_chars(table, Start, "!", Bang);
+  set_chars(table, Start, "|", Pipe);
+  set_chars(table, Start, "&", Amp);
+  set_chars(table, Start, "=", AssignOp);
+  set_chars(table, Start, "<", LessOp);
+  set_chars(table, Start, ">", GreaterOp);
+  set_chars(table, Bang, "=", Double);
+  set_chars(table, Pipe, "|", Double);
+  set_chars(table, Amp, "&", Double);
+  set_chars(table, AssignOp, "=", Double);
+  set_chars(table, LessOp, "=", Double);
+  set_chars(table, GreaterOp, "=", Double);
+  return table;
+}();
+
+struct StateInfo {
+  Action action{Action::Error};
+  TokenType single{TokenType::Identifier};  // 停在该状态时的标点符号类型
+  TokenType pair{TokenType::Identifier};    // 从该状态转移到Double时的标点符号类型
+};
+
+constexpr std::array<StateInfo, StateCount> kStateInfo = [] {
+  std::array<StateInfo, StateCount> info{};
+  info[Space] = {Action::Skip};
+  info[Comment] = {Action::Skip};
+  info[Ident] = {Action::Identifier};
+  info[Zero] = {Action::Oct};
+  info[Oct] = {Action::Oct};
+  info[Dec] = {Action::Dec};
+  info[Hex] = {Action::Hex};
+  info[Slash] = {Action::Punctuation, TokenType::Divide};
+  info[Bang] = {Action::Punctuation, TokenType::Lnot, TokenType::Nequal};
+  info[Pipe] = {Action::Punctuation, TokenType::Or, TokenType::Lor};
+  info[Amp] = {Action::Punctuation, TokenType::And, TokenType::Land};
+  info[AssignOp] = {Action::Punctuation, TokenType::Assign, TokenType::Equal};
+  info[LessOp] = {Action::Punctuation, TokenType::Less, TokenType::Le};
+  info[GreaterOp] = {Action::Punctuation, TokenType::Greater, TokenType::Ge};
+  info[Single] = {Action::Punctuation};
+  info[Double] = {Action::Punctuation};
+  return info;
+}();
+
+// 单字符标点符号的类型，以字符为下标
+constexpr std::array<TokenType, 256> kSingleType = [] {
+  std::array<TokenType, 256> types{};
+  constexpr std::pair<char, TokenType> singles[] = {
+      {'(', TokenType::Lparen}, {')', TokenType::Rparen},
+      {'[', TokenType::LSbrace}, {']', TokenType::RSbrace},
+      {'{', TokenType::LCbrace}, {'}', TokenType::RCbrace},
+      {';', TokenType::Semicolon}, {',', TokenType::Comma},
+      {'-', TokenType::Sub}, {'+', TokenType::Add},
+      {'*', TokenType::Times}, {'%', TokenType::Mod},
+      {'~', TokenType::Not}, {'?', TokenType::Question},
+      {':', TokenType::Colon},
+  };
+  for (auto [c, type] : singles) types[static_cast<unsigned char>(c)] = type;
+  return types;
+}();
+
+// 除Start和HexPrefix外的状态都是接受状态，并且停在HexPrefix时("0x"之后没有十六进制数字)本来就是错误，
+// 所以一直转移到Dead为止就是最长匹配，不需要记录上一个接受状态并回退
+static_assert(kStateInfo[Start].action == Action::Error && kStateInfo[HexPrefix].action == Action::Error);
+
+uint32_t parse_oct_digits(const char *first, const char *last) {
+  uint32_t value = 0;
+  for (; first != last; ++first) {
+    value = value * 8 + (*first - '0');
+  }
+  return value;
+}
+
+}
+
+TokenStream TableLexer::lex(std::string_view code) {
+  TokenStream token_stream;
+  lex_range(code, 0, code.length(), token_stream);
+  return token_stream;
+}
+
+int TableLexer::lex_range(std::string_view code, int begin, int end, TokenStream &token_stream) {
+  const char *p = code.data();
+  int index = begin, length = code.length();
+  while (index < end) {
+    int token_begin = index;
+    State state = kTransition[Start][static_cast<unsigned char>(p[index])];
+    State prev = Start;
+    while (state != Dead) {
+      prev = state;
+      if (++index == length) break;
+      state = kTransition[state][static_cast<unsigned char>(p[index])];
+    }
+    // 此时prev为最后到达的状态，[token_begin, index)为匹配的字符串
+    const auto &info = kStateInfo[prev];
+    switch (info.action) {
+      case Action::Skip:
+        if (index > end) return end;  // 跨过end的空白由下一段重新跳过
+        break;
+      case Action::Identifier: {
+        auto id = code.substr(token_begin, index - token_begin);
+        auto type = get_type_by_identifier(id);
+        if (type == TokenType::Identifier) {
+          token_stream.push_identifier(id, token_begin);
+        } else {
+          token_stream.push(type, token_begin);
+        }
+        break;
+      }
+      case Action::Oct:
+        token_stream.push_number(static_cast<int>(parse_oct_digits(p + token_begin + 1, p + index)), token_begin);
+        break;
+      case Action::Dec:
+        token_stream.push_number(static_cast<int>(parse_dec_digits(p + token_begin, p + index)), token_begin);
+        break;
+      case Action::Hex:
+        token_stream.push_number(static_cast<int>(parse_hex_digits(p + token_begin + 2, p + index)), token_begin);
+        break;
+      case Action::Punctuation:
+        if (prev == Single) {
+          token_stream.push(kSingleType[static_cast<unsigned char>(p[token_begin])], token_begin);
+        } else if (prev == Double) {
+          token_stream.push(kStateInfo[kTransition[Start][static_cast<unsigned char>(p[token_begin])]].pair, token_begin);
+        } else {
+          token_stream.push(info.single, token_begin);
+        }
+        break;
+      case Action::Error:
+        if (prev == HexPrefix) {
+          throw lex_error("invalid hex number", token_begin);
+        }
+        throw lex_error(std::string("unknown character: ") + p[token_begin], token_begin);
+    }
+  }
+  return index;
+}
+
+TokenStream TableLexer::lex_file(const fs::path &file) {
+  SourceBuffer source(file);
+  return lex(source.view());
+}
@@ -0,0 +1,25 @@
+#ifndef SCOMPILER_SRC_LEXER_TABLE_LEXER_HPP_
+#define SCOMPILER_SRC_LEXER_TABLE_LEXER_HPP_
+
+#include "token_stream.hpp"
+
+#include <string>
+#include <string_view>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// 表驱动的词法分析器，DFA的状态转移表在编译期(constexpr)生成
+class TableLexer {
+ public:
+  TableLexer() = default;
+  ~TableLexer() = default;
+
+  TokenStream lex(std::string_view code);
+  TokenStream lex_file(const fs::path &file);
+  // 对code中从begin开始、在end之前开始的token进行词法分析，结果追加到token_stream中
+  // 返回下一段应当开始分析的位置：通常为end，若最后一个token跨过了end则为该token的结尾
+  int lex_range(std::string_view code, int begin, int end, TokenStream &token_stream);
+};
+
+#endif //SCOMPILER_SRC_LEXER_TABLE_LEXER_HPP_
@@ -5,39 +5,150 @@
 #include "optimizer/optimizer.hpp"
 #include "asm_generator/asm_generator.hpp"
 
+#include "ast_cache.hpp"
+#include "ir_io.hpp"
 #include "config.hpp"
+#include "compile_error.hpp"
+#include "line_table.hpp"
+#include "source_buffer.hpp"
 
 /* for debug */
 #include "debug.hpp"
+#include <chrono>
 #include <fstream>
+#include <optional>
+#include <thread>
 
-int main(int argc, char *argv[]) {
-  config.init(argc, argv);
-  auto token_stream = lex_file(config.input_file);
-  if (config.print_token) {
-    std::ofstream ofs(config.token_file);
-    ofs << token_stream << std::endl;
-  }
-  ProgramPtr program = parse(token_stream);
-  if (config.print_ast) {
-    std::ofstream ofs(config.ast_file);
-    ofs << program << std::endl;
-  }
-  check(program);
-  IRBuilderPtr ir_builder = translate(program);
+// 从IR开始完成剩余的编译步骤，source_file不为空时生成调试信息
+void compile_ir(IRBuilderPtr &ir_builder, const std::string &source_file) {
   if (config.print_ir) {
     std::ofstream ofs(config.ir_file);
     ofs << ir_builder << std::endl;
   }
+  if (config.emit_ir_bin) {
+    std::ofstream ofs(config.ir_bin_file, std::ios::binary);
+    ofs << serialize_ir(ir_builder);
+    return;
+  }
   optimize(ir_builder, config.optimize_level);
   if (config.print_low_ir) {
     std::ofstream ofs(config.low_ir_file);
     ofs << ir_builder << std::endl;
   }
-  std::vector<std::string> asm_vec = generate(ir_builder);
+  std::vector<std::string> asm_vec = generate(ir_builder, source_file);
   std::ofstream ofs(config.output_file);
   for (auto &code : asm_vec) {
     ofs << code << "\n";
   }
   ofs << std::endl;
 }
+
+// 从AST开始完成剩余的编译步骤，line_table用于生成调试信息
+void compile(ProgramPtr &program, LineTable &line_table) {
+  if (config.print_ast) {
+    std::ofstream ofs(config.ast_file);
+    ofs << program << std::endl;
+  }
+  check(program);
+  IRBuilderPtr ir_builder = translate(program, config.debug_info ? &line_table : nullptr);
+  compile_ir(ir_builder, config.debug_info ? config.input_file : "");
+}
+
+void report(const compile_error &e, LineTable *line_table) {
+  std::cerr << config.input_file;
+  if (line_table && e.offset() != kNoOffset) {
+    auto[line, column] = line_table->locate(e.offset());
+    std::cerr << ":" << line << ":" << column;
+  }
+  std::cerr << ": error: " << e.what() << std::endl;
+}
+
+// 输入文件每次被修改后重新编译，只重新分析改动的顶层函数和声明
+[[noreturn]] void watch() {
+  IncrementalParser parser(config.lexer, config.jobs);
+  std::optional<fs::file_time_type> last_write_time;
+  while (true) {
+    std::error_code ec;
+    auto write_time = fs::last_write_time(config.input_file, ec);
+    if (!ec && write_time != last_write_time) {
+      last_write_time = write_time;
+      std::optional<SourceBuffer> source;
+      std::optional<LineTable> line_table;
+      try {
+        source.emplace(config.input_file);
+        line_table.emplace(source->view());
+        ProgramPtr program = parser.update(source->view());
+        if (config.print_token) {
+          std::ofstream ofs(config.token_file);
+          ofs << parser.token_stream() << std::endl;
+        }
+        compile(program, *line_table);
+        std::cerr << config.input_file << ": reparsed " << parser.reparsed_items() << " of "
+                  << program->func_decl_vec().size() << " items" << std::endl;
+      } catch (const compile_error &e) {
+        report(e, line_table ? &*line_table : nullptr);
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  }
+}
+
+int main(int argc, char *argv[]) {
+  config.init(argc, argv);
+  if (config.watch) {
+    watch();
+  }
+  // 源文件在整个编译过程中保持映射，报错或生成调试信息时才通过line_table计算行号
+  std::optional<SourceBuffer> source;
+  std::optional<LineTable> line_table;
+  try {
+    source.emplace(config.input_file);
+    line_table.emplace(source->view());
+    if (config.from_ir) {  // IR中的LOC指令对应的源文件未知，不生成调试信息
+      IRBuilderPtr ir_builder = read_ir(source->view());
+      compile_ir(ir_builder, "");
+      return 0;
+    }
+    Arena arena;  // AST的所有节点，编译结束时一次性释放
+    TokenStream token_stream;  // AST中的名字指向token_stream中的字符串
+    ProgramPtr program = nullptr;
+    // 输出token流和惰性分析时总是进行完整的词法和语法分析
+    std::optional<ASTCache> ast_cache;
+    if (!config.ast_cache_dir.empty() && !config.print_token && !config.lazy) {
+      ast_cache.emplace(config.ast_cache_dir);
+      program = ast_cache->load(source->view(), arena);
+    }
+    if (!program) {
+      auto begin = std::chrono::steady_clock::now();
+      token_stream = lex(source->view(), config.lexer, config.jobs);
+      if (config.print_token) {
+        std::ofstream ofs(config.token_file);
+        ofs << token_stream << std::endl;
+      }
+      if (config.lazy) {
+        LazyParser parser(config.lazy_root_vec, config.jobs);
+        program = parser.parse(token_stream, arena);
+        std::cerr << config.input_file << ": parsed " << parser.parsed_function_count() << " of "
+                  << parser.function_count() << " function bodies, skipped " << parser.skipped_tokens() << " tokens"
+                  << std::endl;
+      } else {
+        program = parse(token_stream, arena, config.jobs);
+      }
+      if (ast_cache) {
+        auto parse_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+        ast_cache->store(source->view(), program, parse_us.count());
+        std::cerr << config.input_file << ": ast cache miss";
+      }
+    } else {
+      std::cerr << config.input_file << ": ast cache hit, saved " << ast_cache->last_saved_us() / 1000.0 << " ms";
+    }
+    if (ast_cache) {
+      std::cerr << " (" << ast_cache->hits() << " hits of " << ast_cache->hits() + ast_cache->misses()
+                << ", " << ast_cache->saved_us() / 1000.0 << " ms saved in total)" << std::endl;
+    }
+    compile(program, *line_table);
+  } catch (const compile_error &e) {
+    report(e, line_table ? &*line_table : nullptr);
+    return 1;
+  }
+}
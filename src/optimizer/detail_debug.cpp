@@ -3,7 +3,7 @@
 #include "debug.hpp"
 
 std::ostream &operator<<(std::ostream &os, const BasicBlock &basic_block) {
-  for (auto &ir : basic_block.ir_list_) {
+  for (auto ir : basic_block.ir_list_) {
     os << *ir << std::endl;
   }
   return os;
@@ -41,13 +41,13 @@ std::ostream &operator<<(std::ostream &os, FunctionBlock &function_block) {
     os << blue << "successor: " << normal;
     PRINT_PRED_SUCC_BLOCKS(basic_block->successor_list_);
     os << blue << "use: " << normal;
-    PRINT_ELEMENTS(basic_block->use_);
+    PRINT_ELEMENTS(basic_block->use_.to_set());
     os << blue << "def: " << normal;
-    PRINT_ELEMENTS(basic_block->def_);
+    PRINT_ELEMENTS(basic_block->def_.to_set());
     os << blue << "live_variable_IN_: " << normal;
-    PRINT_ELEMENTS(basic_block->live_variable_IN_);
+    PRINT_ELEMENTS(basic_block->live_variable_IN_.to_set());
     os << blue << "live_variable_OUT_: " << normal;
-    PRINT_ELEMENTS(basic_block->live_variable_OUT_);
+    PRINT_ELEMENTS(basic_block->live_variable_OUT_.to_set());
     os << std::endl;
   }
   std::cout << "----------------------------------" << std::endl;
@@ -56,7 +56,7 @@ std::ostream &operator<<(std::ostream &os, FunctionBlock &function_block) {
 
 std::ostream &operator<<(std::ostream &os, const Module &module) {
   std::cout << yellow << "global_declarations: " << normal << std::endl;
-  for (auto &ir : module.global_ir_list()) {
+  for (auto ir : module.global_ir_list()) {
     std::cout << *ir << std::endl;
   }
   std::cout << yellow << "functions: " << normal << std::endl;
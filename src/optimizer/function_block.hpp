@@ -6,25 +6,26 @@
 
 class FunctionBlock {
  public:
-  explicit FunctionBlock(std::list<IRCodePtr> ir_list);
-  std::list<IRCodePtr> collect();
-  void allocate_registers();
+  explicit FunctionBlock(IRList ir_list);
+  IRList collect();
+  // 溢出和加载变量时生成的指令分配在ir_builder中
+  void allocate_registers(IRBuilder &ir_builder);
   [[nodiscard]] const std::vector<BasicBlockPtr> &basic_block_vec() const { return basic_block_vec_; }
-  [[nodiscard]] const std::string &func_name() const { return func_name_; }
+  [[nodiscard]] Symbol func_name() const { return func_name_; }
   void live_variable_analysis();
  private:
-  void divide_into_basic_blocks(std::list<IRCodePtr> ir_list);
+  void divide_into_basic_blocks(IRList ir_list);
   void link_basic_blocks();
   IRCodePtr header_;
   IRCodePtr footer_;
-  std::string func_name_;
+  Symbol func_name_;
   std::vector<BasicBlockPtr> basic_block_vec_;
 };
 
 using FunctionBlockPtr = std::shared_ptr<FunctionBlock>;
 
-inline FunctionBlockPtr new_function_block(std::list<IRCodePtr> &&ir_list) {
-  return std::make_shared<FunctionBlock>(ir_list);
+inline FunctionBlockPtr new_function_block(IRList &&ir_list) {
+  return std::make_shared<FunctionBlock>(std::move(ir_list));
 }
 
 #endif //SCOMPILER_SRC_OPTIMIZER_FUNCTION_BLOCK_HPP_
@@ -0,0 +1,61 @@
+#ifndef SCOMPILER_SRC_OPTIMIZER_IR_VAR_SET_HPP_
+#define SCOMPILER_SRC_OPTIMIZER_IR_VAR_SET_HPP_
+
+#include "variable.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+// 以IRVar::index()为下标的位向量，只能保存局部变量和参数，用于活跃变量分析
+// 位向量的长度按需增长，比较时忽略末尾的0
+class IRVarSet {
+ public:
+  IRVarSet() = default;
+  ~IRVarSet() = default;
+
+  void insert(IRVar var) {
+    auto index = var.index();
+    if (index / 64 >= word_vec_.size()) word_vec_.resize(index / 64 + 1);
+    word_vec_[index / 64] |= uint64_t{1} << (index % 64);
+  }
+  void erase(IRVar var) {
+    auto index = var.index();
+    if (index / 64 < word_vec_.size()) word_vec_[index / 64] &= ~(uint64_t{1} << (index % 64));
+  }
+  void clear() { std::fill(word_vec_.begin(), word_vec_.end(), 0); }
+  // this |= other
+  void unite(const IRVarSet &other) {
+    if (other.word_vec_.size() > word_vec_.size()) word_vec_.resize(other.word_vec_.size());
+    for (std::size_t i = 0; i < other.word_vec_.size(); ++i) word_vec_[i] |= other.word_vec_[i];
+  }
+  // this -= other
+  void subtract(const IRVarSet &other) {
+    auto size = std::min(word_vec_.size(), other.word_vec_.size());
+    for (std::size_t i = 0; i < size; ++i) word_vec_[i] &= ~other.word_vec_[i];
+  }
+  // 转换为std::set，供逐条语句的活跃变量使用
+  [[nodiscard]] std::set<IRVar> to_set() const {
+    std::set<IRVar> result;
+    for (std::size_t i = 0; i < word_vec_.size(); ++i) {
+      for (auto word = word_vec_[i]; word != 0; word &= word - 1) {
+        auto index = static_cast<int>(i * 64 + __builtin_ctzll(word));
+        result.insert(index % 2 == 0 ? IRVar::local(index / 2) : IRVar::param((index + 1) / 2));
+      }
+    }
+    return result;
+  }
+
+  bool operator==(const IRVarSet &other) const {
+    const auto &longer = word_vec_.size() >= other.word_vec_.size() ? word_vec_ : other.word_vec_;
+    const auto &shorter = word_vec_.size() >= other.word_vec_.size() ? other.word_vec_ : word_vec_;
+    return std::equal(shorter.begin(), shorter.end(), longer.begin())
+        && std::all_of(longer.begin() + shorter.size(), longer.end(), [](uint64_t word) { return word == 0; });
+  }
+  bool operator!=(const IRVarSet &other) const { return !(*this == other); }
+ private:
+  std::vector<uint64_t> word_vec_;
+};
+
+#endif //SCOMPILER_SRC_OPTIMIZER_IR_VAR_SET_HPP_
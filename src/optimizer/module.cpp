@@ -1,25 +1,27 @@
 #include "module.hpp"
 
-Module::Module(std::list<IRCodePtr> ir_list) {
+Module::Module(IRBuilder &ir_builder) : ir_builder_(ir_builder) {
+  auto ir_list = std::move(ir_builder.ircode_list());
   while (!ir_list.empty()) {
     while (!ir_list.empty() && ir_list.front()->op() != IROp::FUNBEG) { // 全局声明
-      global_ir_list_.splice(global_ir_list_.end(), ir_list, ir_list.begin());
+      global_ir_list_.push_back(ir_list.pop_front());
     }
     if (ir_list.empty()) break;
-    auto iter = ir_list.begin();
-    while ((*iter)->op() != IROp::FUNEND) ++iter;
-    ++iter; // 跳到FUNEND的下一句
-    std::list<IRCodePtr> tmp_ir_list;
-    tmp_ir_list.splice(tmp_ir_list.end(), ir_list, ir_list.begin(), iter);
+    IRList tmp_ir_list;
+    while (ir_list.front()->op() != IROp::FUNEND) {
+      tmp_ir_list.push_back(ir_list.pop_front());
+    }
+    tmp_ir_list.push_back(ir_list.pop_front()); // FUNEND
     function_vec_.push_back(new_function_block(std::move(tmp_ir_list)));
   }
 }
 
-std::list<IRCodePtr> Module::collect() {
-  std::list<IRCodePtr> ir_list;
-  ir_list.splice(ir_list.end(), global_ir_list_);
+IRList Module::collect() {
+  IRList ir_list;
+  ir_list.splice(global_ir_list_);
   for (auto &function : function_vec_) {
-    ir_list.splice(ir_list.end(), function->collect());
+    auto function_ir_list = function->collect();
+    ir_list.splice(function_ir_list);
   }
   return ir_list;
 }
@@ -30,6 +32,6 @@ void Module::optimize(int optimize_level) {
 
 void Module::allocate_registers() {
   for (auto &func : function_vec_) {
-    func->allocate_registers();
+    func->allocate_registers(ir_builder_);
   }
 }
@@ -5,15 +5,17 @@
 
 class Module {
  public:
-  explicit Module(std::list<IRCodePtr> ir_list);
+  // 取走ir_builder中的指令，之后新生成的指令也分配在ir_builder中
+  explicit Module(IRBuilder &ir_builder);
   void optimize(int optimize_level);
   void allocate_registers();
-  std::list<IRCodePtr> collect();
+  IRList collect();
   [[nodiscard]] const std::vector<FunctionBlockPtr> &function_vec() const { return function_vec_; }
-  [[nodiscard]] const std::list<IRCodePtr> &global_ir_list() const { return global_ir_list_; }
+  [[nodiscard]] const IRList &global_ir_list() const { return global_ir_list_; }
  private:
+  IRBuilder &ir_builder_;
   std::vector<FunctionBlockPtr> function_vec_;
-  std::list<IRCodePtr> global_ir_list_;
+  IRList global_ir_list_;
 };
 
 #endif //SCOMPILER_SRC_OPTIMIZER_MODULE_HPP_
@@ -8,7 +8,7 @@
 #include "detail_debug.hpp"
 
 inline void optimize(IRBuilderPtr &ir_builder, int optimize_level) {
-  Module module(ir_builder->ircode_list());
+  Module module(*ir_builder);
 //  std::cout << module;
   module.optimize(optimize_level);
   module.allocate_registers();
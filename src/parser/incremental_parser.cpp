@@ -0,0 +1,120 @@
+#include "incremental_parser.hpp"
+
+#include "parallel_parser.hpp"
+#include "../lexer/lexer.hpp"
+
+#include <algorithm>
+
+ProgramPtr IncrementalParser::update(std::string_view code) {
+  if (!program_ || item_info_vec_.empty() || arena_->allocated_bytes() > kMaxArenaGrowth * full_parse_bytes_) {
+    return parse_all(code);
+  }
+  std::size_t old_length = code_.length(), new_length = code.length();
+  // 公共前缀和公共后缀之间的部分为改动的部分
+  auto prefix = static_cast<std::size_t>(
+      std::mismatch(code_.begin(), code_.end(), code.begin(), code.end()).first - code_.begin());
+  if (prefix == old_length && old_length == new_length) {  // 没有改动
+    reparsed_items_ = relexed_bytes_ = 0;
+    return program_;
+  }
+  std::size_t suffix = 0, max_suffix = std::min(old_length, new_length) - prefix;
+  while (suffix < max_suffix && code_[old_length - 1 - suffix] == code[new_length - 1 - suffix]) {
+    ++suffix;
+  }
+  auto shift = static_cast<int64_t>(new_length) - static_cast<int64_t>(old_length);
+
+  // 第一个token在pos之前开始的顶层项的个数
+  std::size_t item_count = item_info_vec_.size();
+  auto count_before = [&](std::size_t pos) {
+    std::size_t low = 0, high = item_count;
+    while (low < high) {
+      auto mid = (low + high) / 2;
+      if (item_begin(mid) < pos) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    return low;
+  };
+  // 重新分析[first, last)中的项：包含改动部分前一个字符的项，直到第一个从未改动的后缀中开始的项为止
+  std::size_t damage_begin = prefix == 0 ? 0 : prefix - 1, damage_end = old_length - suffix;
+  std::size_t first = std::max<std::size_t>(count_before(damage_begin + 1), 1) - 1;
+  std::size_t last = count_before(damage_end);
+
+  std::size_t region_begin = first == 0 ? 0 : item_begin(first), region_end;
+  TokenStream fresh;
+  while (true) {
+    fresh = TokenStream();
+    if (last == item_count) {
+      region_end = new_length;
+      lex_range(code, region_begin, region_end, fresh, lexer_name_);
+      break;
+    }
+    region_end = item_begin(last) + shift;
+    // 多分析一个字符：改动后在region_end处仍然开始一个token时，之后的token与原来的相同
+    lex_range(code, region_begin, region_end + 1, fresh, lexer_name_);
+    if (fresh.size() != 0 && fresh.offset(fresh.size() - 1) == region_end) {
+      fresh.pop_back();
+      break;
+    }
+    ++last;  // 下一项的开头被改动的部分吞并(例如改动后没有结束的字符串)，扩大重新分析的范围
+  }
+  RecursiveDescentParser parser(fresh, *arena_, true);
+  auto program = parser.parse();
+
+  // 以下只修改已有的结果，不会再抛出异常
+  auto token_begin = item_info_vec_[first].token_begin;
+  auto token_end = last == item_count ? token_stream_.size() : item_info_vec_[last].token_begin;
+  token_stream_.replace(token_begin, token_end, fresh, shift);
+  auto token_shift = static_cast<int64_t>(fresh.size()) - static_cast<int64_t>(token_end - token_begin);
+  for (auto i = last; i < item_count; ++i) {
+    auto &info = item_info_vec_[i];
+    info.token_begin += token_shift;
+    if (shift == 0) continue;
+    for (auto *node : info.source_node_vec) {
+      if (node->offset() != kNoOffset) {
+        node->set_offset(static_cast<SourceOffset>(node->offset() + shift));
+      }
+    }
+  }
+  auto &new_info_vec = parser.item_info_vec();
+  for (auto &info : new_info_vec) {
+    info.token_begin += token_begin;
+  }
+  item_info_vec_.erase(item_info_vec_.begin() + first, item_info_vec_.begin() + last);
+  item_info_vec_.insert(item_info_vec_.begin() + first,
+                        std::make_move_iterator(new_info_vec.begin()),
+                        std::make_move_iterator(new_info_vec.end()));
+  auto &item_vec = program_->func_decl_vec();
+  auto &new_item_vec = program->func_decl_vec();
+  item_vec.erase(item_vec.begin() + first, item_vec.begin() + last);
+  item_vec.insert(item_vec.begin() + first, new_item_vec.begin(), new_item_vec.end());
+
+  code_.assign(code);
+  reparsed_items_ = new_item_vec.size();
+  relexed_bytes_ = region_end - region_begin;
+  return program_;
+}
+
+ProgramPtr IncrementalParser::parse_all(std::string_view code) {
+  auto token_stream = lex(code, lexer_name_, jobs_);
+  auto arena = std::make_unique<Arena>();
+  ParallelParser parser(jobs_);
+  auto program = parser.parse(token_stream, *arena, true);
+
+  token_stream_ = std::move(token_stream);
+  arena_ = std::move(arena);
+  full_parse_bytes_ = std::max<std::size_t>(arena_->allocated_bytes(), 1 << 20);  // 文件很小时至少允许积累1MB
+  program_ = program;
+  item_info_vec_ = std::move(parser.item_info_vec());
+  code_.assign(code);
+  reparsed_items_ = item_info_vec_.size();
+  relexed_bytes_ = code.length();
+  return program_;
+}
+
+std::size_t IncrementalParser::item_begin(std::size_t index) const {
+  if (index == item_info_vec_.size()) return code_.length();
+  return token_stream_.offset(item_info_vec_[index].token_begin);
+}
@@ -0,0 +1,50 @@
+#ifndef SCOMPILER_SRC_PARSER_INCREMENTAL_PARSER_HPP_
+#define SCOMPILER_SRC_PARSER_INCREMENTAL_PARSER_HPP_
+
+#include "recursive_descent_parser.hpp"
+#include "token_stream.hpp"
+#include "arena.hpp"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// 保存上一次的源代码、token流和AST，源文件改动后只重新分析受影响的顶层函数和声明
+// 用于--watch模式下反复编译同一个文件
+class IncrementalParser {
+ public:
+  explicit IncrementalParser(std::string lexer_name = "handwritten", int jobs = 1)
+      : lexer_name_(std::move(lexer_name)), jobs_(jobs) {}
+  ~IncrementalParser() = default;
+
+  // 用新的源代码更新token流和AST并返回AST，第一次调用时完整地进行分析
+  // 抛出异常时保持上一次的结果不变，下一次调用仍与上一次成功分析的源代码比较
+  ProgramPtr update(std::string_view code);
+
+  TokenStream &token_stream() { return token_stream_; }
+  // 上一次update中重新分析的顶层项个数和源代码字节数
+  [[nodiscard]] std::size_t reparsed_items() const { return reparsed_items_; }
+  [[nodiscard]] std::size_t relexed_bytes() const { return relexed_bytes_; }
+
+ private:
+  ProgramPtr parse_all(std::string_view code);
+  // 顶层项index的第一个token在源代码中的偏移，index为项数时返回源代码长度
+  [[nodiscard]] std::size_t item_begin(std::size_t index) const;
+
+  std::string lexer_name_;
+  int jobs_;
+  std::string code_;
+  TokenStream token_stream_;
+  // 被替换的项仍然占用arena_中的内存，超过上一次完整分析时的kMaxArenaGrowth倍后重新完整地分析
+  static constexpr std::size_t kMaxArenaGrowth = 2;
+  std::unique_ptr<Arena> arena_;
+  std::size_t full_parse_bytes_{0};
+  ProgramPtr program_{nullptr};
+  std::vector<ItemInfo> item_info_vec_;  // 与program_->func_decl_vec()一一对应
+  std::size_t reparsed_items_{0};
+  std::size_t relexed_bytes_{0};
+};
+
+#endif //SCOMPILER_SRC_PARSER_INCREMENTAL_PARSER_HPP_
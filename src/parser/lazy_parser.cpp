@@ -0,0 +1,41 @@
+#include "lazy_parser.hpp"
+
+#include "parallel_parser.hpp"
+
+#include <unordered_map>
+
+ProgramPtr LazyParser::parse(const TokenStream &token_stream, Arena &arena) {
+  auto program = ParallelParser(jobs_, true).parse(token_stream, arena);
+
+  // 同名的函数定义可能有多个(由checker报错)，它们的函数体都需要分析
+  std::unordered_map<Symbol, std::vector<FunctionPtr>> definition_map;
+  for (auto &item : program->func_decl_vec()) {
+    if (!std::holds_alternative<FunctionPtr>(item)) continue;
+    auto function = std::get<FunctionPtr>(item);
+    if (!function->has_lazy_body()) continue;
+    definition_map[function->name()].push_back(function);
+    ++function_count_;
+    skipped_tokens_ += function->body_end() - function->body_begin();
+  }
+
+  std::vector<Symbol> work_vec;
+  for (const auto &root : root_vec_) {
+    work_vec.push_back(Symbol::intern(root));
+  }
+  while (!work_vec.empty()) {
+    auto name = work_vec.back();
+    work_vec.pop_back();
+    auto it = definition_map.find(name);
+    if (it == definition_map.end()) continue;  // 已经分析过，或者只有声明
+    for (auto function : it->second) {
+      RecursiveDescentParser parser(TokenCursor(token_stream, function->body_begin(), function->body_end()), arena);
+      function->compound_statement() = parser.parse_body();
+      ++parsed_function_count_;
+      skipped_tokens_ -= function->body_end() - function->body_begin();
+      auto &call_name_vec = parser.call_name_vec();
+      work_vec.insert(work_vec.end(), call_name_vec.begin(), call_name_vec.end());
+    }
+    definition_map.erase(it);
+  }
+  return program;
+}
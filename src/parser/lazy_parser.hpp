@@ -0,0 +1,33 @@
+#ifndef SCOMPILER_SRC_PARSER_LAZY_PARSER_HPP_
+#define SCOMPILER_SRC_PARSER_LAZY_PARSER_HPP_
+
+#include "recursive_descent_parser.hpp"
+#include "token_stream.hpp"
+#include "arena.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// 先只分析函数头，函数体通过花括号匹配跳过并记录其token范围，再从根函数(例如main)出发沿调用图分析能被调用到的函数体
+// 没有被调用到的函数定义保持has_lazy_body()的状态，检查和翻译时当作函数声明处理，不会生成代码
+class LazyParser {
+ public:
+  explicit LazyParser(std::vector<std::string> root_vec, int jobs = 1) : root_vec_(std::move(root_vec)), jobs_(jobs) {}
+  ~LazyParser() = default;
+
+  ProgramPtr parse(const TokenStream &token_stream, Arena &arena);
+  // 函数定义的个数，以及其中函数体被分析的个数
+  [[nodiscard]] std::size_t function_count() const { return function_count_; }
+  [[nodiscard]] std::size_t parsed_function_count() const { return parsed_function_count_; }
+  // 没有被分析的函数体中的token数
+  [[nodiscard]] std::size_t skipped_tokens() const { return skipped_tokens_; }
+ private:
+  std::vector<std::string> root_vec_;
+  int jobs_;
+  std::size_t function_count_{0};
+  std::size_t parsed_function_count_{0};
+  std::size_t skipped_tokens_{0};
+};
+
+#endif //SCOMPILER_SRC_PARSER_LAZY_PARSER_HPP_
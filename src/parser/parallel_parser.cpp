@@ -0,0 +1,105 @@
+#include "parallel_parser.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <thread>
+
+namespace {
+
+// 每段至少包含的token数，避免小文件被切得过碎
+constexpr std::size_t kMinChunkTokens = 16 * 1024;
+// 段数取线程数的若干倍，使各线程的负载更均衡
+constexpr int kChunksPerJob = 4;
+
+// 返回各段的分界点(token的下标)，第一个为0，最后一个为token_stream.size()，其余都是某个顶层项的第一个token
+// 顶层项在花括号之外的';'处(声明)，或者在使花括号回到最外层的'}'处(函数定义)结束
+std::vector<std::size_t> split_items(const TokenStream &token_stream, int jobs) {
+  auto size = token_stream.size();
+  auto chunk_count = std::min<std::size_t>(jobs * kChunksPerJob, size / kMinChunkTokens);
+  std::vector<std::size_t> bounds{0};
+  if (chunk_count > 1) {
+    auto chunk_size = size / chunk_count;
+    int depth = 0;
+    for (std::size_t i = 0; i + 1 < size; ++i) {
+      auto type = token_stream.type(i);
+      if (type == TokenType::LCbrace) {
+        ++depth;
+        continue;
+      }
+      if (type == TokenType::RCbrace) {
+        --depth;
+      } else if (type != TokenType::Semicolon) {
+        continue;
+      }
+      if (depth == 0 && i + 1 - bounds.back() >= chunk_size) bounds.push_back(i + 1);
+    }
+  }
+  bounds.push_back(size);
+  return bounds;
+}
+
+struct ChunkResult {
+  ProgramPtr program{nullptr};
+  std::vector<ItemInfo> item_info_vec;
+  std::exception_ptr error;
+};
+
+}
+
+ProgramPtr ParallelParser::parse(const TokenStream &token_stream, Arena &arena, bool track_items) {
+  auto bounds = split_items(token_stream, jobs_);
+  int chunk_count = bounds.size() - 1;
+  if (jobs_ <= 1 || chunk_count <= 1) {
+    RecursiveDescentParser parser(token_stream, arena, track_items);
+    parser.set_lazy_bodies(lazy_bodies_);
+    auto program = parser.parse();
+    item_info_vec_ = std::move(parser.item_info_vec());
+    return program;
+  }
+
+  std::vector<ChunkResult> results(chunk_count);
+  std::atomic<int> next_chunk{0};
+  auto worker = [&](Arena &chunk_arena) {
+    for (int i = next_chunk++; i < chunk_count; i = next_chunk++) {
+      try {
+        RecursiveDescentParser parser(TokenCursor(token_stream, bounds[i], bounds[i + 1]), chunk_arena, track_items);
+        parser.set_lazy_bodies(lazy_bodies_);
+        results[i].program = parser.parse();
+        results[i].item_info_vec = std::move(parser.item_info_vec());
+      } catch (...) {
+        results[i].error = std::current_exception();
+      }
+    }
+  };
+  int thread_count = std::min(jobs_, chunk_count);
+  std::vector<Arena *> arena_vec;
+  for (int i = 0; i < thread_count; ++i) {
+    arena_vec.push_back(&arena.fork());
+  }
+  std::vector<std::thread> threads;
+  for (int i = 1; i < thread_count; ++i) {
+    threads.emplace_back(worker, std::ref(*arena_vec[i]));
+  }
+  worker(*arena_vec[0]);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::size_t total = 0;
+  for (const auto &result : results) {
+    if (result.error) std::rethrow_exception(result.error);
+    total += result.program->func_decl_vec().size();
+  }
+  ArenaVector<Program::value_type> func_decl_vec(&arena);
+  func_decl_vec.reserve(total);
+  item_info_vec_.clear();
+  for (auto &result : results) {
+    auto &item_vec = result.program->func_decl_vec();
+    func_decl_vec.insert(func_decl_vec.end(), item_vec.begin(), item_vec.end());
+    std::move(result.item_info_vec.begin(), result.item_info_vec.end(), std::back_inserter(item_info_vec_));
+  }
+  return arena.make<Program>(func_decl_vec);
+}
@@ -0,0 +1,27 @@
+#ifndef SCOMPILER_SRC_PARSER_PARALLEL_PARSER_HPP_
+#define SCOMPILER_SRC_PARSER_PARALLEL_PARSER_HPP_
+
+#include "recursive_descent_parser.hpp"
+#include "token_stream.hpp"
+#include "arena.hpp"
+
+#include <vector>
+
+// 先通过花括号匹配找出顶层函数和声明的边界，将连续的若干项作为一段，由多个线程同时分析，再按源文件中的顺序拼接
+// 每个线程在arena的一个子Arena中分配节点，所以得到的AST同样只需要arena一直存在
+class ParallelParser {
+ public:
+  // lazy_bodies见RecursiveDescentParser::set_lazy_bodies
+  explicit ParallelParser(int jobs, bool lazy_bodies = false) : jobs_(jobs), lazy_bodies_(lazy_bodies) {}
+  ~ParallelParser() = default;
+
+  // 与RecursiveDescentParser相同，track_items为true时记录每个顶层项的ItemInfo
+  ProgramPtr parse(const TokenStream &token_stream, Arena &arena, bool track_items = false);
+  std::vector<ItemInfo> &item_info_vec() { return item_info_vec_; }
+ private:
+  int jobs_;
+  bool lazy_bodies_;
+  std::vector<ItemInfo> item_info_vec_;
+};
+
+#endif //SCOMPILER_SRC_PARSER_PARALLEL_PARSER_HPP_
@@ -2,11 +2,18 @@
 #define SCOMPILER_SRC_PARSER_PARSER_HPP_
 
 #include "recursive_descent_parser.hpp"
+#include "incremental_parser.hpp"
+#include "parallel_parser.hpp"
+#include "lazy_parser.hpp"
 
 using Parser = RecursiveDescentParser;
 
-ProgramPtr parse(TokenStream token_stream) {
-  Parser parser(token_stream);
+// 返回的AST分配在arena中，arena需要在使用AST期间一直存在；jobs > 1时并行地分析各个顶层项
+inline ProgramPtr parse(const TokenStream &token_stream, Arena &arena, int jobs = 1) {
+  if (jobs > 1) {
+    return ParallelParser(jobs).parse(token_stream, arena);
+  }
+  Parser parser(token_stream, arena);
   return parser.parse();
 }
 
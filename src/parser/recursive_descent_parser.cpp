@@ -1,527 +1,467 @@
 #include "recursive_descent_parser.hpp"
 
+#include <array>
+
+namespace {
+
+struct BinaryOpInfo {
+  int precedence{0};  // 越大结合得越紧，0表示不是二元运算符
+  BinaryExpr::Op op{BinaryExpr::Op::Times};
+};
+
+constexpr int kLowestPrecedence = 1;
+
+// 以TokenType为下标的二元运算符表，分析时每个运算符只需查一次表
+constexpr auto kBinaryOpTable = [] {
+  std::array<BinaryOpInfo, static_cast<std::size_t>(TokenType::String) + 1> table{};
+  auto set = [&table](TokenType type, int precedence, BinaryExpr::Op op) {
+    table[static_cast<std::size_t>(type)] = {precedence, op};
+  };
+  set(TokenType::Lor, 1, BinaryExpr::Op::Lor);
+  set(TokenType::Land, 2, BinaryExpr::Op::Land);
+  set(TokenType::Equal, 3, BinaryExpr::Op::Equal);
+  set(TokenType::Nequal, 3, BinaryExpr::Op::Nequal);
+  set(TokenType::Less, 4, BinaryExpr::Op::Less);
+  set(TokenType::Greater, 4, BinaryExpr::Op::Greater);
+  set(TokenType::Le, 4, BinaryExpr::Op::Le);
+  set(TokenType::Ge, 4, BinaryExpr::Op::Ge);
+  set(TokenType::Add, 5, BinaryExpr::Op::Add);
+  set(TokenType::Sub, 5, BinaryExpr::Op::Sub);
+  set(TokenType::Times, 6, BinaryExpr::Op::Times);
+  set(TokenType::Divide, 6, BinaryExpr::Op::Divide);
+  set(TokenType::Mod, 6, BinaryExpr::Op::Mod);
+  return table;
+}();
+
+// 是否可能由文法中的unary得到；括号中的二元运算等虽然也是unary，但不能作为左值，同样不允许
+bool is_unary(ExpressionPtr expression) {
+  switch (expression->kind()) {
+    case Expression::Kind::Literal:
+    case Expression::Kind::Ref:
+    case Expression::Kind::Call:
+    case Expression::Kind::Index:
+    case Expression::Kind::Unary: return true;
+    default: return false;
+  }
+}
+
+}
+
 ProgramPtr RecursiveDescentParser::parse() {
-  ProgramPtr program;
+  ProgramPtr program = nullptr;
   visit(program);
   return program;
 }
 
+CompoundStatementPtr RecursiveDescentParser::parse_body() {
+  CompoundStatementPtr compound_statement = nullptr;
+  record_calls_ = true;
+  visit(compound_statement);
+  record_calls_ = false;
+  return compound_statement;
+}
+
 void RecursiveDescentParser::visit(ProgramPtr &program) {
-  std::vector<Program::value_type> func_decl_vec;
+  ArenaVector<Program::value_type> func_decl_vec(&arena_);
 
-  while (!token_stream_.eof()) {  // still has tokens
-    if (token_stream_.look_ahead(2, TokenType::Lparen)) { // function
-      FunctionPtr function;
+  while (!cursor_.eof()) {  // still has tokens
+    if (track_items_) item_info_vec_.push_back({cursor_.index(), {}});
+    if (cursor_.look_ahead(2, TokenType::Lparen)) { // function
+      FunctionPtr function = nullptr;
       visit(function);
       func_decl_vec.emplace_back(function);
     } else { // declaration
-      DeclarationPtr declaration;
+      DeclarationPtr declaration = nullptr;
       visit(declaration);
       func_decl_vec.emplace_back(declaration);
     }
   }
 
-  program = std::make_shared<Program>(func_decl_vec);
+  program = arena_.make<Program>(func_decl_vec);
 }
 
 void RecursiveDescentParser::visit(FunctionPtr &function) {
   BaseType ret_type;
-  std::string func_name;
-  ParameterListPtr parameter_list;
-  CompoundStatementPtr compound_statement;
+  Symbol func_name;
+  ParameterListPtr parameter_list = nullptr;
+  CompoundStatementPtr compound_statement = nullptr;
 
   visit(ret_type);
-  func_name = token_stream_.consume_identifier();
-  token_stream_.consume(TokenType::Lparen);
+  auto name_offset = cursor_.cur_offset();
+  func_name = cursor_.consume_identifier();
+  cursor_.consume(TokenType::Lparen);
   visit(parameter_list);
-  token_stream_.consume(TokenType::Rparen);
-  if (token_stream_.is(TokenType::Semicolon)) {
-    token_stream_.advance();
+  cursor_.consume(TokenType::Rparen);
+  std::size_t body_begin = 0, body_end = 0;
+  if (cursor_.is(TokenType::Semicolon)) {
+    cursor_.advance();
+  } else if (lazy_bodies_) {  // 只记录函数体的范围
+    body_begin = cursor_.index();
+    cursor_.skip_block();
+    body_end = cursor_.index();
   } else {  // compound_statement
     visit(compound_statement);
   }
 
-  function = std::make_shared<Function>(ret_type, func_name, parameter_list, compound_statement);
+  function = arena_.make<Function>(ret_type, func_name, parameter_list, compound_statement);
+  function->set_body_range(body_begin, body_end);
+  set_offset(*function, name_offset);
 }
 
 void RecursiveDescentParser::visit(BaseType &type) {
-  if (token_stream_.is(TokenType::Int)) {
+  if (cursor_.is(TokenType::Int)) {
     type.set_type(SupportType::Int);
-    token_stream_.advance();
-  } else {
-    assert(false);  // 只支持int类型
+    cursor_.advance();
+  } else {  // 只支持int类型
+    cursor_.error("expected 'int'");
   }
 }
 
 void RecursiveDescentParser::visit(ParameterListPtr &parameter_list) {
-  if (token_stream_.is(TokenType::Rparen)) {  // empty list
-    parameter_list = std::make_shared<ParameterList>();
+  if (cursor_.is(TokenType::Rparen)) {  // empty list
+    parameter_list = arena_.make<ParameterList>();
     return;
   }
   BaseType var_type;
-  std::string id;
-  std::vector<VariablePtr> variable_vec;
+  Symbol id;
+  ArenaVector<VariablePtr> variable_vec(&arena_);
   int param_num = 0;
 
   while (true) {
     visit(var_type);
-    id = token_stream_.consume_identifier();
-    variable_vec.push_back(std::make_shared<Variable>(var_type.type(), id));
+    auto id_offset = cursor_.cur_offset();
+    id = cursor_.consume_identifier();
+    variable_vec.push_back(arena_.make<Variable>(var_type.type(), id));
+    set_offset(*variable_vec.back(), id_offset);
     variable_vec.back()->set_param_num(++param_num);
-    if (!token_stream_.is(TokenType::Comma)) break; // end
-    token_stream_.advance();
+    if (!cursor_.is(TokenType::Comma)) break; // end
+    cursor_.advance();
   }
 
-  parameter_list = std::make_shared<ParameterList>(variable_vec);
+  parameter_list = arena_.make<ParameterList>(variable_vec);
 }
 
 void RecursiveDescentParser::visit(CompoundStatementPtr &compound_statement) {
-  std::vector<BlockItemPtr> blockitem_vec;
+  ArenaVector<BlockItemPtr> blockitem_vec(&arena_);
 
-  token_stream_.consume(TokenType::LCbrace);
-  while (!token_stream_.is(TokenType::RCbrace)) {
-    BlockItemPtr block_item;
+  cursor_.consume(TokenType::LCbrace);
+  while (!cursor_.is(TokenType::RCbrace)) {
+    BlockItemPtr block_item = nullptr;
     visit(block_item);
     blockitem_vec.push_back(block_item);
   }
-  token_stream_.advance();
+  cursor_.advance();
 
-  compound_statement = std::make_shared<CompoundStatement>(blockitem_vec);
+  compound_statement = arena_.make<CompoundStatement>(blockitem_vec);
 }
 
 void RecursiveDescentParser::visit(BlockItemPtr &block_item) {
-  if (token_stream_.is_type()) {  // declaration
-    DeclarationPtr declaration;
+  if (cursor_.is_type()) {  // declaration
+    DeclarationPtr declaration = nullptr;
     visit(declaration);
-    block_item = std::make_shared<BlockItem>(declaration);
+    block_item = arena_.make<BlockItem>(declaration);
   } else {  // statement
-    StatementPtr statement;
+    StatementPtr statement = nullptr;
     visit(statement);
-    block_item = std::make_shared<BlockItem>(statement);
+    block_item = arena_.make<BlockItem>(statement);
   }
 }
 
 void RecursiveDescentParser::visit(StatementPtr &statement) {
-  if (token_stream_.is(TokenType::Return)) {
-    ExpressionPtr expression;
+  auto offset = cursor_.cur_offset();
+  if (cursor_.is(TokenType::Return)) {
+    ExpressionPtr expression = nullptr;
 
-    token_stream_.advance();
+    cursor_.advance();
     visit(expression);
-    token_stream_.consume(TokenType::Semicolon);
+    cursor_.consume(TokenType::Semicolon);
 
-    statement = std::make_shared<Statement>(std::make_shared<ReturnStatement>(expression));
-  } else if (token_stream_.is(TokenType::If)) {
-    ExpressionPtr cond_exp;
-    StatementPtr if_stmt;
-    StatementPtr else_stmt;
+    statement = arena_.make<Statement>(arena_.make<ReturnStatement>(expression));
+  } else if (cursor_.is(TokenType::If)) {
+    ExpressionPtr cond_exp = nullptr;
+    StatementPtr if_stmt = nullptr;
+    StatementPtr else_stmt = nullptr;
 
-    token_stream_.advance();
-    token_stream_.consume(TokenType::Lparen);
+    cursor_.advance();
+    cursor_.consume(TokenType::Lparen);
     visit(cond_exp);
-    token_stream_.consume(TokenType::Rparen);
+    cursor_.consume(TokenType::Rparen);
     visit(if_stmt);
-    if (token_stream_.is(TokenType::Else)) {  // has else branch
-      token_stream_.advance();
+    if (cursor_.is(TokenType::Else)) {  // has else branch
+      cursor_.advance();
       visit(else_stmt);
     }
 
-    statement = std::make_shared<Statement>(std::make_shared<IfStatement>(cond_exp, if_stmt, else_stmt));
-  } else if (token_stream_.is(TokenType::LCbrace)) {  // compound statement
-    CompoundStatementPtr compound_statement;
+    statement = arena_.make<Statement>(arena_.make<IfStatement>(cond_exp, if_stmt, else_stmt));
+  } else if (cursor_.is(TokenType::LCbrace)) {  // compound statement
+    CompoundStatementPtr compound_statement = nullptr;
     visit(compound_statement);
-    statement = std::make_shared<Statement>(compound_statement);
-  } else if (token_stream_.is(TokenType::For)) {
-    ExpressionPtr cond_exp;
-    ExpressionPtr update_exp;
-    StatementPtr loop_statement;
+    statement = arena_.make<Statement>(compound_statement);
+  } else if (cursor_.is(TokenType::For)) {
+    ExpressionPtr cond_exp = nullptr;
+    ExpressionPtr update_exp = nullptr;
+    StatementPtr loop_statement = nullptr;
 
-    token_stream_.advance();
-    token_stream_.consume(TokenType::Lparen);
-    if (token_stream_.is_type()) {  // declaration
-      DeclarationPtr init_decl;
+    cursor_.advance();
+    cursor_.consume(TokenType::Lparen);
+    if (cursor_.is_type()) {  // declaration
+      DeclarationPtr init_decl = nullptr;
 
       visit(init_decl);
-      if (!token_stream_.is(TokenType::Semicolon)) { // non-empty cond_exp
+      if (!cursor_.is(TokenType::Semicolon)) { // non-empty cond_exp
         visit(cond_exp);
       }
-      token_stream_.consume(TokenType::Semicolon);
-      if (!token_stream_.is(TokenType::Rparen)) { // non-empty update_exp
+      cursor_.consume(TokenType::Semicolon);
+      if (!cursor_.is(TokenType::Rparen)) { // non-empty update_exp
         visit(update_exp);
       }
-      token_stream_.consume(TokenType::Rparen);
+      cursor_.consume(TokenType::Rparen);
       visit(loop_statement);
 
-      statement = std::make_shared<Statement>(std::make_shared<ForDecStatement>(init_decl,
+      statement = arena_.make<Statement>(arena_.make<ForDecStatement>(init_decl,
                                                                                 cond_exp,
                                                                                 update_exp,
                                                                                 loop_statement));
     } else {  // expression
-      ExpressionPtr init_exp;
+      ExpressionPtr init_exp = nullptr;
 
-      if (!token_stream_.is(TokenType::Semicolon)) { // non-empty init_exp
+      if (!cursor_.is(TokenType::Semicolon)) { // non-empty init_exp
         visit(init_exp);
       }
-      token_stream_.consume(TokenType::Semicolon);
-      if (!token_stream_.is(TokenType::Semicolon)) { // non-empty cond_exp
+      cursor_.consume(TokenType::Semicolon);
+      if (!cursor_.is(TokenType::Semicolon)) { // non-empty cond_exp
         visit(cond_exp);
       }
-      token_stream_.consume(TokenType::Semicolon);
-      if (!token_stream_.is(TokenType::Rparen)) { // non-empty update_exp
+      cursor_.consume(TokenType::Semicolon);
+      if (!cursor_.is(TokenType::Rparen)) { // non-empty update_exp
         visit(update_exp);
       }
-      token_stream_.consume(TokenType::Rparen);
+      cursor_.consume(TokenType::Rparen);
       visit(loop_statement);
 
-      statement = std::make_shared<Statement>(std::make_shared<ForExpStatement>(init_exp,
+      statement = arena_.make<Statement>(arena_.make<ForExpStatement>(init_exp,
                                                                                 cond_exp,
                                                                                 update_exp,
                                                                                 loop_statement));
     }
-  } else if (token_stream_.is(TokenType::While)) {
-    ExpressionPtr cond_exp;
-    StatementPtr loop_statement;
+  } else if (cursor_.is(TokenType::While)) {
+    ExpressionPtr cond_exp = nullptr;
+    StatementPtr loop_statement = nullptr;
 
-    token_stream_.advance();
-    token_stream_.consume(TokenType::Lparen);
+    cursor_.advance();
+    cursor_.consume(TokenType::Lparen);
     visit(cond_exp);
-    token_stream_.consume(TokenType::Rparen);
+    cursor_.consume(TokenType::Rparen);
     visit(loop_statement);
 
-    statement = std::make_shared<Statement>(std::make_shared<WhileStatement>(cond_exp, loop_statement));
-  } else if (token_stream_.is(TokenType::Do)) {
-    StatementPtr loop_statement;
-    ExpressionPtr cond_exp;
+    statement = arena_.make<Statement>(arena_.make<WhileStatement>(cond_exp, loop_statement));
+  } else if (cursor_.is(TokenType::Do)) {
+    StatementPtr loop_statement = nullptr;
+    ExpressionPtr cond_exp = nullptr;
 
-    token_stream_.advance();
+    cursor_.advance();
     visit(loop_statement);
-    token_stream_.consume(TokenType::While);
-    token_stream_.consume(TokenType::Lparen);
+    cursor_.consume(TokenType::While);
+    cursor_.consume(TokenType::Lparen);
     visit(cond_exp);
-    token_stream_.consume(TokenType::Rparen);
-    token_stream_.consume(TokenType::Semicolon);
-
-    statement = std::make_shared<Statement>(std::make_shared<DoStatement>(loop_statement, cond_exp));
-  } else if (token_stream_.is(TokenType::Break)) {
-    token_stream_.advance();
-    token_stream_.consume(TokenType::Semicolon);
-
-    statement = std::make_shared<Statement>(std::make_shared<BreakStatement>());
-  } else if (token_stream_.is(TokenType::Continue)) {
-    token_stream_.advance();
-    token_stream_.consume(TokenType::Semicolon);
-
-    statement = std::make_shared<Statement>(std::make_shared<ContinueStatement>());
+    cursor_.consume(TokenType::Rparen);
+    cursor_.consume(TokenType::Semicolon);
+
+    statement = arena_.make<Statement>(arena_.make<DoStatement>(loop_statement, cond_exp));
+  } else if (cursor_.is(TokenType::Break)) {
+    cursor_.advance();
+    cursor_.consume(TokenType::Semicolon);
+
+    auto break_statement = arena_.make<BreakStatement>();
+    set_offset(*break_statement, offset);
+    statement = arena_.make<Statement>(break_statement);
+  } else if (cursor_.is(TokenType::Continue)) {
+    cursor_.advance();
+    cursor_.consume(TokenType::Semicolon);
+
+    auto continue_statement = arena_.make<ContinueStatement>();
+    set_offset(*continue_statement, offset);
+    statement = arena_.make<Statement>(continue_statement);
   } else {  // ExpStatement
-    ExpressionPtr exp;
+    ExpressionPtr exp = nullptr;
 
-    if (!token_stream_.is(TokenType::Semicolon)) {  // non-empty expression
+    if (!cursor_.is(TokenType::Semicolon)) {  // non-empty expression
       visit(exp);
     }
-    token_stream_.consume(TokenType::Semicolon);
+    cursor_.consume(TokenType::Semicolon);
 
-    statement = std::make_shared<Statement>(std::make_shared<ExpStatement>(exp));
+    statement = arena_.make<Statement>(arena_.make<ExpStatement>(exp));
   }
+  set_offset(*statement, offset);
 }
 
 void RecursiveDescentParser::visit(DeclarationPtr &declaration) {
   BaseType var_type;
-  std::string var_name;
-  std::vector<int> dimension_vec;
-  VariablePtr variable;
-  ExpressionPtr init_exp;
+  Symbol var_name;
+  ArenaVector<int> dimension_vec(&arena_);
+  VariablePtr variable = nullptr;
+  ExpressionPtr init_exp = nullptr;
 
+  auto offset = cursor_.cur_offset();
   visit(var_type);
-  var_name = token_stream_.consume_identifier();
-  while (token_stream_.is(TokenType::LSbrace)) {  // ArrayType
-    token_stream_.advance();
-    dimension_vec.push_back(token_stream_.consume_number());
-    token_stream_.consume(TokenType::RSbrace);
+  auto name_offset = cursor_.cur_offset();
+  var_name = cursor_.consume_identifier();
+  while (cursor_.is(TokenType::LSbrace)) {  // ArrayType
+    cursor_.advance();
+    dimension_vec.push_back(cursor_.consume_number());
+    cursor_.consume(TokenType::RSbrace);
   }
   if (dimension_vec.empty()) {  // Base Type
-    variable = std::make_shared<Variable>(var_type.type(), var_name);
+    variable = arena_.make<Variable>(var_type.type(), var_name);
   } else {  // Array Type
-    variable = std::make_shared<Variable>(var_type.type(), dimension_vec, var_name);
+    variable = arena_.make<Variable>(var_type.type(), dimension_vec, var_name);
   }
-  if (token_stream_.is(TokenType::Assign)) {  // has init expression
-    token_stream_.advance();
+  set_offset(*variable, name_offset);
+  if (cursor_.is(TokenType::Assign)) {  // has init expression
+    cursor_.advance();
     visit(init_exp);
   }
-  token_stream_.consume(TokenType::Semicolon);
+  cursor_.consume(TokenType::Semicolon);
 
-  declaration = std::make_shared<Declaration>(variable, init_exp);
+  declaration = arena_.make<Declaration>(variable, init_exp);
+  set_offset(*declaration, offset);
 }
 
 void RecursiveDescentParser::visit(ExpressionListPtr &expression_list) {
-  if (token_stream_.is(TokenType::Rparen)) {  // empty expression list
-    expression_list = std::make_shared<ExpressionList>();
+  if (cursor_.is(TokenType::Rparen)) {  // empty expression list
+    expression_list = arena_.make<ExpressionList>();
     return;
   }
-  std::vector<ExpressionPtr> expression_vec;
+  ArenaVector<ExpressionPtr> expression_vec(&arena_);
   while (true) {
-    ExpressionPtr expression;
+    ExpressionPtr expression = nullptr;
     visit(expression);
     expression_vec.push_back(expression);
-    if (token_stream_.is(TokenType::Rparen)) break; // end
-    token_stream_.consume(TokenType::Comma);
+    if (cursor_.is(TokenType::Rparen)) break; // end
+    cursor_.consume(TokenType::Comma);
   }
-  expression_list = std::make_shared<ExpressionList>(expression_vec);
+  expression_list = arena_.make<ExpressionList>(expression_vec);
 }
 
+// 先按conditional分析，后面是'='时再检查它能否作为赋值的左边(文法中的unary)，不需要回溯
 void RecursiveDescentParser::visit(ExpressionPtr &expression) {
-  AssignmentPtr assignment;
-  visit(assignment);
-  expression = std::make_shared<Expression>(assignment);
-}
+  ExpressionPtr right = nullptr;
 
-void RecursiveDescentParser::visit(AssignmentPtr &assignment) {
-  UnaryPtr left;
-  ExpressionPtr right;
-  ConditionalPtr conditional;
-
-  auto status = token_stream_.store();
-  visit(left);
-  if (token_stream_.is(TokenType::Assign)) {  // AssignExp
-    token_stream_.advance();
+  expression = parse_conditional();
+  if (cursor_.is(TokenType::Assign)) {  // AssignExpr
+    if (!is_unary(expression)) cursor_.error("expression is not assignable");
+    auto offset = cursor_.cur_offset();
+    cursor_.advance();
     visit(right);
 
-    assignment = std::make_shared<Assignment>(std::make_shared<AssignExp>(left, right));
-  } else {  // conditional
-    token_stream_.restore(status);  // restore to old status
-    visit(conditional);
-
-    assignment = std::make_shared<Assignment>(conditional);
-  }
-}
-
-void RecursiveDescentParser::visit(ConditionalPtr &conditional) {
-  LogicalOrPtr cond;
-  ExpressionPtr cond_true;
-  ConditionalPtr cond_false;
-
-  visit(cond);
-  if (token_stream_.is(TokenType::Question)) {  // cond ? cond_true : cond_false
-    token_stream_.advance();
-    visit(cond_true);
-    token_stream_.consume(TokenType::Colon);
-    visit(cond_false);
+    expression = arena_.make<AssignExpr>(expression, right);
+    set_offset(*expression, offset);
   }
-
-  conditional = std::make_shared<Conditional>(cond, cond_true, cond_false);
 }
 
-void RecursiveDescentParser::visit(LogicalOrPtr &logical_or) {
-  LogicalOrPtr left;
-  LogicalAndPtr right;
-  LogicalAndPtr tmp;
-
-  visit(tmp);
-  left = std::make_shared<LogicalOr>(tmp);
-  while (token_stream_.is(TokenType::Lor)) {
-    token_stream_.advance();
-    visit(right);
-    left = std::make_shared<LogicalOr>(left, right);
-  }
-
-  logical_or = left;
+ExpressionPtr RecursiveDescentParser::parse_conditional() {
+  auto cond = parse_binary(kLowestPrecedence);
+  if (!cursor_.is(TokenType::Question)) return cond;
+  // cond ? cond_true : cond_false
+  ExpressionPtr cond_true = nullptr;
+  auto offset = cursor_.cur_offset();
+  cursor_.advance();
+  visit(cond_true);
+  cursor_.consume(TokenType::Colon);
+  auto cond_false = parse_conditional();
+
+  auto conditional = arena_.make<ConditionalExpr>(cond, cond_true, cond_false);
+  set_offset(*conditional, offset);
+  return conditional;
 }
 
-void RecursiveDescentParser::visit(LogicalAndPtr &logical_and) {
-  LogicalAndPtr left;
-  EqualityPtr right;
-  EqualityPtr tmp;
-
-  visit(tmp);
-  left = std::make_shared<LogicalAnd>(tmp);
-  while (token_stream_.is(TokenType::Land)) {
-    token_stream_.advance();
-    visit(right);
-    left = std::make_shared<LogicalAnd>(left, right);
+ExpressionPtr RecursiveDescentParser::parse_binary(int min_precedence) {
+  auto left = parse_unary();
+  while (!cursor_.eof()) {
+    const auto &info = kBinaryOpTable[static_cast<std::size_t>(cursor_.cur_type())];
+    if (info.precedence < min_precedence) break;  // 不是二元运算符时precedence为0
+    auto offset = cursor_.cur_offset();
+    cursor_.advance();
+    // 右操作数只吸收优先级更高的运算符，从而实现左结合
+    auto right = parse_binary(info.precedence + 1);
+    left = arena_.make<BinaryExpr>(left, info.op, right);
+    set_offset(*left, offset);
   }
-
-  logical_and = left;
+  return left;
 }
 
-void RecursiveDescentParser::visit(EqualityPtr &equality) {
-  EqualityPtr left;
-  Equality::Op op;
-  RelationalPtr right;
-  RelationalPtr tmp;
-
-  visit(tmp);
-  left = std::make_shared<Equality>(tmp);
-  while (token_stream_.is_equality_op()) {
-    if (token_stream_.is(TokenType::Equal)) {
-      op = Equality::Op::Equal;
-    } else if (token_stream_.is(TokenType::Nequal)) {
-      op = Equality::Op::Nequal;
-    } else {
-      assert(false);
-    }
-    token_stream_.advance();
-    visit(right);
-    left = std::make_shared<Equality>(left, op, right);
-  }
-
-  equality = left;
-}
-
-void RecursiveDescentParser::visit(RelationalPtr &relational) {
-  RelationalPtr left;
-  Relational::Op op;
-  AdditivePtr right;
-  AdditivePtr tmp;
-
-  visit(tmp);
-  left = std::make_shared<Relational>(tmp);
-  while (token_stream_.is_relational_op()) {
-    if (token_stream_.is(TokenType::Less)) {
-      op = Relational::Op::Less;
-    } else if (token_stream_.is(TokenType::Greater)) {
-      op = Relational::Op::Greater;
-    } else if (token_stream_.is(TokenType::Le)) {
-      op = Relational::Op::Le;
-    } else if (token_stream_.is(TokenType::Ge)) {
-      op = Relational::Op::Ge;
-    } else {
-      assert(false);
-    }
-    token_stream_.advance();
-    visit(right);
-    left = std::make_shared<Relational>(left, op, right);
-  }
-
-  relational = left;
-}
-
-void RecursiveDescentParser::visit(AdditivePtr &additive) {
-  AdditivePtr left;
-  Additive::Op op;
-  MultiplicativePtr right;
-  MultiplicativePtr tmp;
-
-  visit(tmp);
-  left = std::make_shared<Additive>(tmp);
-  while (token_stream_.is_additive_op()) {
-    if (token_stream_.is(TokenType::Add)) {
-      op = Additive::Op::Add;
-    } else if (token_stream_.is(TokenType::Sub)) {
-      op = Additive::Op::Sub;
-    } else {
-      assert(false);
-    }
-    token_stream_.advance();
-    visit(right);
-    left = std::make_shared<Additive>(left, op, right);
-  }
-
-  additive = left;
-}
-
-void RecursiveDescentParser::visit(MultiplicativePtr &multiplicative) {
-  MultiplicativePtr left;
-  Multiplicative::Op op;
-  UnaryPtr right;
-  UnaryPtr tmp;
-
-  visit(tmp);
-  left = std::make_shared<Multiplicative>(tmp);
-  while (token_stream_.is_multiplicative_op()) {
-    if (token_stream_.is(TokenType::Times)) {
-      op = Multiplicative::Op::Times;
-    } else if (token_stream_.is(TokenType::Divide)) {
-      op = Multiplicative::Op::Divide;
-    } else if (token_stream_.is(TokenType::Mod)) {
-      op = Multiplicative::Op::Mod;
-    } else {
-      assert(false);
-    }
-    token_stream_.advance();
-    visit(right);
-    left = std::make_shared<Multiplicative>(left, op, right);
+ExpressionPtr RecursiveDescentParser::parse_unary() {
+  if (!cursor_.is_unary_op()) return parse_postfix();
+  UnaryExpr::Op op;
+  if (cursor_.is(TokenType::Sub)) {
+    op = UnaryExpr::Op::Sub;
+  } else if (cursor_.is(TokenType::Not)) {
+    op = UnaryExpr::Op::Not;
+  } else if (cursor_.is(TokenType::Lnot)) {
+    op = UnaryExpr::Op::Lnot;
+  } else {
+    cursor_.error("expected unary operator");
   }
+  auto offset = cursor_.cur_offset();
+  cursor_.advance();
+  auto operand = parse_unary();
 
-  multiplicative = left;
+  auto unary = arena_.make<UnaryExpr>(op, operand);
+  set_offset(*unary, offset);
+  return unary;
 }
 
-void RecursiveDescentParser::visit(UnaryPtr &unary) {
-  PostfixPtr p;
-  Unary::Op op;
-  UnaryPtr u;
-
-  if (token_stream_.is_unary_op()) {  // op unary
-    if (token_stream_.is(TokenType::Sub)) {
-      op = Unary::Op::Sub;
-    } else if (token_stream_.is(TokenType::Not)) {
-      op = Unary::Op::Not;
-    } else if (token_stream_.is(TokenType::Lnot)) {
-      op = Unary::Op::Lnot;
-    } else {
-      assert(false);
-    }
-    token_stream_.advance();
-    visit(u);
-    unary = std::make_shared<Unary>(op, u);
-  } else {  // postfix
-    visit(p);
-    unary = std::make_shared<Unary>(p);
-  }
-}
+ExpressionPtr RecursiveDescentParser::parse_postfix() {
+  ExpressionPtr base = nullptr;
 
-void RecursiveDescentParser::visit(PostfixPtr &postfix) {
-  FuncCallPtr func_call;
-  PrimaryPtr primary;
-  std::vector<ExpressionPtr> expression_vec;
-  bool is_primary = false;
+  if (cursor_.is(TokenType::Identifier) &&
+      cursor_.look_ahead(1, TokenType::Lparen)) { // func call
+    ExpressionListPtr expression_list = nullptr;
 
-  if (token_stream_.is(TokenType::Identifier) &&
-      token_stream_.look_ahead(1, TokenType::Lparen)) { // func call
-    ExpressionListPtr expression_list;
-    std::string func_name;
-
-    func_name = token_stream_.consume_identifier();
-    token_stream_.advance();
+    auto offset = cursor_.cur_offset();
+    auto func_name = cursor_.consume_identifier();
+    cursor_.advance();
     visit(expression_list);
-    token_stream_.consume(TokenType::Rparen);
+    cursor_.consume(TokenType::Rparen);
 
-    func_call = std::make_shared<FuncCall>(func_name, expression_list);
+    base = arena_.make<Call>(func_name, expression_list);
+    set_offset(*base, offset);
+    if (record_calls_) call_name_vec_.push_back(func_name);
   } else {  // primary
-    is_primary = true;
-    visit(primary);
+    base = parse_primary();
   }
-  while (token_stream_.is(TokenType::LSbrace)) { // Array
-    token_stream_.advance();
-    ExpressionPtr exp;
+  if (!cursor_.is(TokenType::LSbrace)) return base;
+
+  ArenaVector<ExpressionPtr> index_vec(&arena_);
+  auto offset = cursor_.cur_offset();
+  while (cursor_.is(TokenType::LSbrace)) { // Array
+    cursor_.advance();
+    ExpressionPtr exp = nullptr;
     visit(exp);
-    token_stream_.consume(TokenType::RSbrace);
-    expression_vec.push_back(exp);
-  }
-  if (expression_vec.empty()) { // primary or func call
-    if (is_primary) { // primary
-      postfix = std::make_shared<Postfix>(primary);
-    } else {  // func call
-      postfix = std::make_shared<Postfix>(func_call);
-    }
-  } else {
-    if (is_primary) { // primary
-      postfix = std::make_shared<Postfix>(std::make_shared<Array>(primary, expression_vec));
-    } else {  // func call
-      postfix = std::make_shared<Postfix>(std::make_shared<Array>(func_call, expression_vec));
-    }
+    cursor_.consume(TokenType::RSbrace);
+    index_vec.push_back(exp);
   }
+
+  auto index = arena_.make<Index>(base, index_vec);
+  set_offset(*index, offset);
+  return index;
 }
 
-void RecursiveDescentParser::visit(PrimaryPtr &primary) {
-  if (token_stream_.is(TokenType::Number)) {
-    primary = std::make_shared<Primary>(token_stream_.consume_number());
-  } else if (token_stream_.is(TokenType::Lparen)) {
-    ExpressionPtr exp;
-    token_stream_.advance();
-    visit(exp);
-    token_stream_.consume(TokenType::Rparen);
-    primary = std::make_shared<Primary>(exp);
-  } else if (token_stream_.is(TokenType::Identifier)) {
-    primary = std::make_shared<Primary>(token_stream_.consume_identifier());
+ExpressionPtr RecursiveDescentParser::parse_primary() {
+  auto offset = cursor_.cur_offset();
+  ExpressionPtr primary = nullptr;
+  if (cursor_.is(TokenType::Number)) {
+    primary = arena_.make<Literal>(cursor_.consume_number());
+  } else if (cursor_.is(TokenType::Lparen)) {  // 括号只改变结合顺序，不产生节点
+    cursor_.advance();
+    visit(primary);
+    cursor_.consume(TokenType::Rparen);
+    return primary;
+  } else if (cursor_.is(TokenType::Identifier)) {
+    primary = arena_.make<Ref>(cursor_.consume_identifier());
   } else {
-    assert(false);
+    cursor_.error("expected expression");
   }
+  set_offset(*primary, offset);
+  return primary;
 }
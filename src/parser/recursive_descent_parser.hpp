@@ -3,36 +3,64 @@
 
 #include "visitor.hpp"
 #include "token_stream.hpp"
+#include "arena.hpp"
 
-class RecursiveDescentParser : ASTVisitor {
+#include <vector>
+
+// 顶层的函数或声明的信息，供增量分析使用
+struct ItemInfo {
+  std::size_t token_begin;  // 第一个token在token_stream中的下标
+  std::vector<SourceNode *> source_node_vec;  // 其中记录了偏移的节点，源文件中该项之前的内容改变长度后需要整体移动
+};
+
+class RecursiveDescentParser : ASTVisitor<RecursiveDescentParser> {
  public:
-  explicit RecursiveDescentParser(TokenStream &token_stream) : token_stream_(token_stream) {}
+  // AST节点都分配在arena中；track_items为true时记录每个顶层项的ItemInfo
+  RecursiveDescentParser(const TokenStream &token_stream, Arena &arena, bool track_items = false)
+      : RecursiveDescentParser(TokenCursor(token_stream), arena, track_items) {}
+  // 只分析cursor范围内的token，范围需要由完整的顶层项组成
+  RecursiveDescentParser(TokenCursor cursor, Arena &arena, bool track_items = false)
+      : cursor_(cursor), arena_(arena), track_items_(track_items) {}
   ~RecursiveDescentParser() = default;
   ProgramPtr parse();
+  std::vector<ItemInfo> &item_info_vec() { return item_info_vec_; }
+
+  // lazy_bodies为true时跳过函数体，只记录其token范围，见LazyParser
+  void set_lazy_bodies(bool lazy_bodies) { lazy_bodies_ = lazy_bodies; }
+  // 将cursor范围内的token作为一个函数体进行分析，同时记录其中调用的函数名
+  CompoundStatementPtr parse_body();
+  std::vector<Symbol> &call_name_vec() { return call_name_vec_; }
  private:
-  void visit(ProgramPtr &program) override;
-  void visit(FunctionPtr &function) override;
-  void visit(BaseType &type) override;
-  void visit(ParameterListPtr &parameter_list) override;
-  void visit(CompoundStatementPtr &compound_statement) override;
-  void visit(BlockItemPtr &block_item) override;
-  void visit(StatementPtr &statement) override;
-  void visit(DeclarationPtr &declaration) override;
-  void visit(ExpressionListPtr &expression_list) override;
-  void visit(ExpressionPtr &expression) override;
-  void visit(AssignmentPtr &assignment) override;
-  void visit(ConditionalPtr &conditional) override;
-  void visit(LogicalOrPtr &logical_or) override;
-  void visit(LogicalAndPtr &logical_and) override;
-  void visit(EqualityPtr &equality) override;
-  void visit(RelationalPtr &relational) override;
-  void visit(AdditivePtr &additive) override;
-  void visit(MultiplicativePtr &multiplicative) override;
-  void visit(UnaryPtr &unary) override;
-  void visit(PostfixPtr &postfix) override;
-  void visit(PrimaryPtr &primary) override;
-
-  TokenStream &token_stream_;
+  void visit(ProgramPtr &program);
+  void visit(FunctionPtr &function);
+  void visit(BaseType &type);
+  void visit(ParameterListPtr &parameter_list);
+  void visit(CompoundStatementPtr &compound_statement);
+  void visit(BlockItemPtr &block_item);
+  void visit(StatementPtr &statement);
+  void visit(DeclarationPtr &declaration);
+  void visit(ExpressionListPtr &expression_list);
+  void visit(ExpressionPtr &expression);
+
+  // 表达式使用优先级爬升(Pratt)分析：同一层循环处理所有二元运算符，没有运算符时不产生额外的节点
+  ExpressionPtr parse_conditional();
+  ExpressionPtr parse_binary(int min_precedence);
+  ExpressionPtr parse_unary();
+  ExpressionPtr parse_postfix();
+  ExpressionPtr parse_primary();
+
+  void set_offset(SourceNode &node, SourceOffset offset) {
+    node.set_offset(offset);
+    if (track_items_) item_info_vec_.back().source_node_vec.push_back(&node);
+  }
+
+  TokenCursor cursor_;
+  Arena &arena_;
+  bool track_items_;
+  std::vector<ItemInfo> item_info_vec_;
+  bool lazy_bodies_{false};
+  bool record_calls_{false};
+  std::vector<Symbol> call_name_vec_;
 };
 
 #endif //SCOMPILER_SRC_PARSER_RECURSIVE_DESCENT_PARSER_HPP_
@@ -5,111 +5,164 @@ IRBuilderPtr Translator::translate(ProgramPtr &program) {
   return ir_builder_;
 }
 
+void Translator::new_loc(SourceOffset offset) {
+  if (!line_table_ || offset == kNoOffset) return;
+  auto[line, column] = line_table_->locate(offset);
+  ir_builder_->new_ir(IROp::LOC, IRAddr(line), IRAddr(column));
+}
+
+// &&和||翻译为条件跳转，右操作数只在左操作数不能决定结果时求值
+// 比较直接翻译为比较两个操作数的条件跳转，!交换跳转的条件
+void Translator::translate_cond(ExpressionPtr &cond, int label, bool jump_if) {
+  if (auto value = const_cond(cond)) {  // 条件是常量时直接跳转或者顺序执行，例如while (1)
+    if (*value == jump_if) {
+      ir_builder_->new_ir(IROp::JMP, IRAddr(label));
+    }
+    return;
+  }
+  if (cond->kind() == Expression::Kind::Unary) {
+    auto unary_expr = static_cast<UnaryExprPtr>(cond);
+    if (unary_expr->op() == UnaryExpr::Op::Lnot) {
+      translate_cond(unary_expr->operand(), label, !jump_if);
+      return;
+    }
+  }
+  if (cond->kind() == Expression::Kind::Binary) {
+    auto binary_expr = static_cast<BinaryExprPtr>(cond);
+    auto op = binary_expr->op();
+    // 为假时跳转的&&和为真时跳转的||：任一操作数满足条件即跳转
+    if ((op == BinaryExpr::Op::Land && !jump_if) || (op == BinaryExpr::Op::Lor && jump_if)) {
+      translate_cond(binary_expr->left(), label, jump_if);
+      translate_cond(binary_expr->right(), label, jump_if);
+      return;
+    }
+    // 其余情况下左操作数满足相反的条件时就可以跳过右操作数
+    if (op == BinaryExpr::Op::Land || op == BinaryExpr::Op::Lor) {
+      int skip_label = symbol_table_.alloc_label();
+      translate_cond(binary_expr->left(), skip_label, !jump_if);
+      translate_cond(binary_expr->right(), label, jump_if);
+      ir_builder_->new_ir(IROp::LABEL, IRAddr(skip_label));
+      return;
+    }
+    if (op >= BinaryExpr::Op::Less && op <= BinaryExpr::Op::Nequal) {
+      auto left = translate_operand(binary_expr->left());
+      auto right = translate_operand(binary_expr->right());
+      auto branch_op = jump_if ? to_branch_op(op) : negate_branch_op(to_branch_op(op));
+      if (left.is_imm() && !right.is_imm()) {
+        std::swap(left, right);
+        branch_op = swap_operands_op(branch_op);
+      }
+      ir_builder_->new_ir(branch_op, IRAddr(to_var(left)), right, IRAddr(label));
+      return;
+    }
+  }
+  auto value = translate_operand(cond);
+  ir_builder_->new_ir(jump_if ? IROp::BNEZ : IROp::BEQZ, value, IRAddr(label));
+}
+
+// 只有左操作数是常量时才折叠&&和||，例如a && 0中的a仍然需要求值
+std::optional<bool> Translator::const_cond(const ExpressionPtr &cond) {
+  if (auto value = constant_value(cond)) {
+    return *value != 0;
+  }
+  if (cond->kind() == Expression::Kind::Unary) {
+    auto unary_expr = static_cast<UnaryExprPtr>(cond);
+    if (unary_expr->op() == UnaryExpr::Op::Lnot) {
+      if (auto value = const_cond(unary_expr->operand())) return !*value;
+    }
+    return std::nullopt;
+  }
+  if (cond->kind() == Expression::Kind::Binary) {
+    auto binary_expr = static_cast<BinaryExprPtr>(cond);
+    bool is_land = binary_expr->op() == BinaryExpr::Op::Land;
+    if (!is_land && binary_expr->op() != BinaryExpr::Op::Lor) return std::nullopt;
+    auto left = const_cond(binary_expr->left());
+    if (!left) return std::nullopt;
+    if (*left != is_land) return left;  // 0 && x为假，1 || x为真，x不会被求值
+    return const_cond(binary_expr->right());
+  }
+  return std::nullopt;
+}
+
+IRAddr Translator::translate_operand(ExpressionPtr &exp) {
+  if (auto value = constant_value(exp)) {
+    return IRAddr(*value);
+  }
+  visit(exp);
+  return IRAddr(tmp_var_);
+}
+
+IRVar Translator::to_var(IRAddr addr) {
+  if (addr.is_var()) return addr.var();
+  auto var = IRVar::local(symbol_table_.alloc_var());
+  ir_builder_->new_ir(IROp::MOV, IRAddr(var), addr);
+  return var;
+}
+
 void Translator::visit(ProgramPtr &program) {
   for (auto &item : program->func_decl_vec()) {
-    if (std::holds_alternative<FunctionPtr>(item)) {
-      visit(std::get<FunctionPtr>(item));
-    } else if (std::holds_alternative<DeclarationPtr>(item)) {
-      visit(std::get<DeclarationPtr>(item));
-    } else { assert(false); }
+    visit_variant(item);
   }
 }
 
+// 变量和函数名都已经由checker绑定，翻译时不再按名字查找，符号表只用于分配IR变量和标签
 void Translator::visit(FunctionPtr &function) {
   symbol_table_.enter();
-  auto new_function_entry = std::make_shared<FunctionEntry>(function);
-  if (function->compound_statement()) { // 函数定义
-    symbol_table_.add_function_definition(new_function_entry);
+  if (function->compound_statement()) { // 函数定义，函数体没有被分析的函数定义(见LazyParser)不生成代码
     ir_builder_->new_ir(IROp::FUNBEG,
-                        new_ir_addr(function->name()),
-                        new_ir_addr(static_cast<int>(function->parameter_list()->variables().size())));
+                        IRAddr(function->name()),
+                        IRAddr(static_cast<int>(function->parameter_list()->variables().size())));
     visit(function->parameter_list());
     visit(function->compound_statement());
     ir_builder_->new_ir(IROp::FUNEND);
-  } else {  // 函数声明
-    symbol_table_.add_function_declaration(new_function_entry);
   }
   symbol_table_.leave();
 }
 
 void Translator::visit(BaseType &type) {}
 
-void Translator::visit(ParameterListPtr &parameter_list) {
-  /* 将函数参数添加到符号表中 */
-  for (auto &var : parameter_list->variables()) {
-    symbol_table_.add_variable(var);
-  }
-}
+void Translator::visit(ParameterListPtr &parameter_list) {}  // 参数在第一次使用时才分配IR变量
 
 void Translator::visit(CompoundStatementPtr &compound_statement) {
-  symbol_table_.enter();
   for (auto &block_item : compound_statement->block_item_vec()) {
     visit(block_item);
   }
-  symbol_table_.leave();
 }
 void Translator::visit(BlockItemPtr &block_item) {
-  if (std::holds_alternative<StatementPtr>(block_item->value())) {
-    visit(std::get<StatementPtr>(block_item->value()));
-  } else if (std::holds_alternative<DeclarationPtr>(block_item->value())) {
-    visit(std::get<DeclarationPtr>(block_item->value()));
-  } else { assert(false); }
+  visit_variant(block_item->value());
 }
 void Translator::visit(StatementPtr &statement) {
-  if (std::holds_alternative<ReturnStatementPtr>(statement->value())) {
-    visit(std::get<ReturnStatementPtr>(statement->value()));
-  } else if (std::holds_alternative<ExpStatementPtr>(statement->value())) {
-    visit(std::get<ExpStatementPtr>(statement->value()));
-  } else if (std::holds_alternative<IfStatementPtr>(statement->value())) {
-    visit(std::get<IfStatementPtr>(statement->value()));
-  } else if (std::holds_alternative<CompoundStatementPtr>(statement->value())) {
-    visit(std::get<CompoundStatementPtr>(statement->value()));
-  } else if (std::holds_alternative<ForExpStatementPtr>(statement->value())) {
-    visit(std::get<ForExpStatementPtr>(statement->value()));
-  } else if (std::holds_alternative<ForDecStatementPtr>(statement->value())) {
-    visit(std::get<ForDecStatementPtr>(statement->value()));
-  } else if (std::holds_alternative<WhileStatementPtr>(statement->value())) {
-    visit(std::get<WhileStatementPtr>(statement->value()));
-  } else if (std::holds_alternative<DoStatementPtr>(statement->value())) {
-    visit(std::get<DoStatementPtr>(statement->value()));
-  } else if (std::holds_alternative<BreakStatementPtr>(statement->value())) {
-    visit(std::get<BreakStatementPtr>(statement->value()));
-  } else if (std::holds_alternative<ContinueStatementPtr>(statement->value())) {
-    visit(std::get<ContinueStatementPtr>(statement->value()));
-  } else { assert(false); }
+  if (!std::holds_alternative<CompoundStatementPtr>(statement->value())) {
+    new_loc(statement->offset());
+  }
+  visit_variant(statement->value());
 }
 void Translator::visit(DeclarationPtr &declaration) {
-  symbol_table_.add_variable(declaration->var());
-  auto[var, is_global] = symbol_table_.lookup_variable(declaration->var()->name());
+  auto &var = declaration->var();
+  auto is_global = var->is_global();
   auto is_array = var->type().is_array();
-  auto get_number_of_init_exp = [](const ExpressionPtr &exp) {
-    auto cond = std::get<ConditionalPtr>(exp->assignment()->value());
-    auto postfix = std::get<PostfixPtr>(cond->cond()->right()->right()->right()->right()->right()->right()->value());
-    auto primary = std::get<PrimaryPtr>(postfix->value());
-    return std::get<int>(primary->value());
-  };
   if (is_global) {  // 全局变量
     if (is_array) {
-      ir_builder_->new_ir(IROp::GBSS, new_ir_addr(var->name()), new_ir_addr(var->type().array_size() * 4));
+      ir_builder_->new_ir(IROp::GBSS, IRAddr(var->name()), IRAddr(var->type().array_size() * 4));
     } else {
       if (declaration->init_exp()) {  // 初始化
-        int number = get_number_of_init_exp(declaration->init_exp()); // 在checker阶段进行检查
-        ir_builder_->new_ir(IROp::GINI, new_ir_addr(var->name()), new_ir_addr(number));
+        auto number = constant_value(declaration->init_exp());  // checker保证全局变量的初始值是常量
+        ir_builder_->new_ir(IROp::GINI, IRAddr(var->name()), IRAddr(*number));
       } else {
-        ir_builder_->new_ir(IROp::GBSS, new_ir_addr(var->name()), new_ir_addr(4));
+        ir_builder_->new_ir(IROp::GBSS, IRAddr(var->name()), IRAddr(4));
       }
     }
   } else {
+    new_loc(declaration->offset());
     if (is_array) {
-      tmp_var_ = symbol_table_.lookup_ir_var(var->name());  // 为局部数组的基址分配一个IR变量
-      ir_builder_->new_ir(IROp::ALLOC, new_ir_addr(tmp_var_), new_ir_addr(var->type().array_size() * 4));
+      tmp_var_ = symbol_table_.ir_var(var);  // 为局部数组的基址分配一个IR变量
+      ir_builder_->new_ir(IROp::ALLOC, IRAddr(tmp_var_), IRAddr(var->type().array_size() * 4));
     } else {
       if (declaration->init_exp()) {
-        visit(declaration->init_exp());
-        auto right_var1 = tmp_var_;
-        auto left_var0 = symbol_table_.lookup_ir_var(declaration->var()->name());
+        auto right = translate_operand(declaration->init_exp());
+        auto left_var0 = symbol_table_.ir_var(var);
         // 没有必要修改tmp_var_，因为声明语句不能再赋给其他的值
-        ir_builder_->new_ir(IROp::MOV, new_ir_addr(left_var0), new_ir_addr(right_var1));
+        ir_builder_->new_ir(IROp::MOV, IRAddr(left_var0), right);
       }
     }
   }
@@ -119,156 +172,194 @@ void Translator::visit(ExpressionListPtr &expression_list) {
   // 从右向左传递参数
   for (auto it = expression_list->expression_vec().rbegin(); it != expression_list->expression_vec().rend(); ++it) {
     visit(*it);
-    ir_builder_->new_ir(IROp::PARAM, new_ir_addr(tmp_var_));
+    ir_builder_->new_ir(IROp::PARAM, IRAddr(tmp_var_));
   }
 }
 void Translator::visit(ExpressionPtr &expression) {
-  visit(expression->assignment());
-}
-void Translator::visit(AssignmentPtr &assignment) {
-  if (std::holds_alternative<ConditionalPtr>(assignment->value())) {
-    visit(std::get<ConditionalPtr>(assignment->value()));
-  } else if (std::holds_alternative<AssignExpPtr>(assignment->value())) {
-    visit(std::get<AssignExpPtr>(assignment->value()));
-  } else { assert(false); }
-}
-void Translator::visit(ConditionalPtr &conditional) {
-  visit(conditional->cond());
-  if (conditional->cond_true()) {
-    visit(conditional->cond_true());
-    visit(conditional->cond_false());
+  visit_expression(expression);
+}
+void Translator::visit(LiteralPtr &literal) {
+  tmp_var_ = IRVar::local(symbol_table_.alloc_var());
+  ir_builder_->new_ir(IROp::MOV, IRAddr(tmp_var_), IRAddr(literal->value()));
+}
+void Translator::visit(RefPtr &ref) {
+  auto variable = ref->variable();
+  tmp_var_ = symbol_table_.ir_var(variable);
+  bool is_array = variable->type().is_array();
+  if (tmp_var_.is_global()) { // 全局变量
+    tmp_var_ = IRVar::local(symbol_table_.alloc_var());
+    ir_builder_->new_ir(IROp::LA, IRAddr(tmp_var_), IRAddr(variable->name()));
+    if (!is_array) {  // 数组类型只需加载到地址，而变量类型需要加载到值
+      auto addr_var = tmp_var_;
+      tmp_var_ = IRVar::local(symbol_table_.alloc_var());
+      ir_builder_->new_ir(IROp::LOAD, IRAddr(tmp_var_), IRAddr(addr_var), IRAddr(0));
+    }
+  } // 局部变量无需做额外处理
+  variable_ = variable;
+}
+void Translator::visit(CallPtr &call) {
+  visit(call->expression_list());
+  tmp_var_ = IRVar::local(symbol_table_.alloc_var());
+  ir_builder_->new_ir(IROp::CALL, IRAddr(tmp_var_), IRAddr(call->func_name()));
+}
+void Translator::visit(IndexPtr &index) {
+  assert(index->base()->kind() == Expression::Kind::Ref);  // 不支持对函数的返回值使用下标
+  visit(index->base());
+  auto base_var = tmp_var_;
+  auto array = variable_;
+  auto &dimension_vec = array->type().dimension_vec();
+  int sz = dimension_vec.size();
+  std::vector<int> offset_vec(sz);
+  int ini = 1;
+  for (int i = sz - 1; i >= 0; --i) {
+    if (i == sz - 1) {
+      offset_vec[i] = ini;
+    } else {
+      offset_vec[i] = offset_vec[i - 1] * dimension_vec[i - 1];
+    }
   }
-}
-void Translator::visit(LogicalOrPtr &logical_or) {
-  if (logical_or->left()) {
-    visit(logical_or->left());
-    auto right_var1 = tmp_var_;
-    visit(logical_or->right());
-    auto right_var2 = tmp_var_;
-    tmp_var_ = IRVar(symbol_table_.alloc_var());
-    ir_builder_->new_ir(IROp::LOR, new_ir_addr(tmp_var_), new_ir_addr(right_var1), new_ir_addr(right_var2));
-  } else {
-    visit(logical_or->right());
+  // 字面量下标的偏移量直接累加，放入LOAD指令的立即数中，其余下标的偏移量用指令计算
+  int64_t const_offset = 0;
+  IRAddr offset;
+  auto add_offset = [&](IRAddr term) {
+    if (offset.empty()) {
+      offset = term;
+    } else {
+      auto sum_var = IRVar::local(symbol_table_.alloc_var());
+      ir_builder_->new_ir(IROp::ADD, IRAddr(sum_var), IRAddr(to_var(offset)), term);
+      offset = IRAddr(sum_var);
+    }
+  };
+  for (int i = 0; i < sz; ++i) {
+    auto index_addr = translate_operand(index->index_vec()[i]);
+    if (index_addr.is_imm()) {
+      const_offset += static_cast<int64_t>(index_addr.imm()) * offset_vec[i];
+    } else if (offset_vec[i] == 1) {
+      add_offset(index_addr);
+    } else {
+      auto t_var = IRVar::local(symbol_table_.alloc_var());
+      ir_builder_->new_ir(IROp::MUL, IRAddr(t_var), index_addr, IRAddr(offset_vec[i]));
+      add_offset(IRAddr(t_var));
+    }
   }
-}
-void Translator::visit(LogicalAndPtr &logical_and) {
-  if (logical_and->left()) {
-    visit(logical_and->left());
-    auto right_var1 = tmp_var_;
-    visit(logical_and->right());
-    auto right_var2 = tmp_var_;
-    tmp_var_ = IRVar(symbol_table_.alloc_var());
-    ir_builder_->new_ir(IROp::LAND, new_ir_addr(tmp_var_), new_ir_addr(right_var1), new_ir_addr(right_var2));
-  } else {
-    visit(logical_and->right());
+  int64_t byte_offset = -const_offset * 4;  // 数组向低地址增长
+  if (!is_imm12(byte_offset)) {  // 放不进立即数时与其他下标一起计算
+    add_offset(IRAddr(static_cast<int>(const_offset)));
+    byte_offset = 0;
   }
-}
-void Translator::visit(EqualityPtr &equality) {
-  if (equality->left()) {
-    visit(equality->left());
-    auto right_var1 = tmp_var_;
-    visit(equality->right());
-    auto right_var2 = tmp_var_;
-    ir_builder_->new_ir(to_ir_op(equality->op()),
-                        new_ir_addr(tmp_var_),
-                        new_ir_addr(right_var1),
-                        new_ir_addr(right_var2));
-  } else {
-    visit(equality->right());
+  auto addr_var = base_var;
+  if (!offset.empty()) {
+    auto offset_var = IRVar::local(symbol_table_.alloc_var());
+    ir_builder_->new_ir(IROp::MUL, IRAddr(offset_var), IRAddr(to_var(offset)), IRAddr(4)); // 偏移量乘以4
+    addr_var = IRVar::local(symbol_table_.alloc_var());
+    ir_builder_->new_ir(IROp::SUB, IRAddr(addr_var), IRAddr(base_var), IRAddr(offset_var));
   }
-}
-void Translator::visit(RelationalPtr &relational) {
-  if (relational->left()) {
-    visit(relational->left());
-    auto right_var1 = tmp_var_;
-    visit(relational->right());
-    auto right_var2 = tmp_var_;
-    tmp_var_ = IRVar(symbol_table_.alloc_var());
-    ir_builder_->new_ir(to_ir_op(relational->op()),
-                        new_ir_addr(tmp_var_),
-                        new_ir_addr(right_var1),
-                        new_ir_addr(right_var2));
-  } else {
-    visit(relational->right());
+  tmp_var_ = IRVar::local(symbol_table_.alloc_var());
+  ir_builder_->new_ir(IROp::LOAD, IRAddr(tmp_var_), IRAddr(addr_var), IRAddr(static_cast<int>(byte_offset)));
+  variable_ = array;
+}
+void Translator::visit(UnaryExprPtr &unary_expr) {
+  visit(unary_expr->operand());
+  auto right_var = tmp_var_;
+  tmp_var_ = IRVar::local(symbol_table_.alloc_var());
+  ir_builder_->new_ir(to_ir_op(unary_expr->op()), IRAddr(tmp_var_), IRAddr(right_var));
+}
+void Translator::visit(BinaryExprPtr &binary_expr) {
+  if (binary_expr->op() == BinaryExpr::Op::Land || binary_expr->op() == BinaryExpr::Op::Lor) {
+    // 需要值的&&和||：先假设结果为0，条件成立时再改为1
+    ExpressionPtr cond = binary_expr;
+    if (auto value = const_cond(cond)) {  // 结果是常量时右操作数不会被求值，也不需要跳转
+      tmp_var_ = to_var(IRAddr(*value ? 1 : 0));
+      return;
+    }
+    auto result_var = IRVar::local(symbol_table_.alloc_var());
+    int end_label = symbol_table_.alloc_label();
+    ir_builder_->new_ir(IROp::MOV, IRAddr(result_var), IRAddr(0));
+    translate_cond(cond, end_label);
+    ir_builder_->new_ir(IROp::MOV, IRAddr(result_var), IRAddr(1));
+    ir_builder_->new_ir(IROp::LABEL, IRAddr(end_label));
+    tmp_var_ = result_var;
+    return;
   }
-}
-void Translator::visit(AdditivePtr &additive) {
-  if (additive->left()) {
-    visit(additive->left());
-    auto right_var1 = tmp_var_;
-    visit(additive->right());
-    auto right_var2 = tmp_var_;
-    tmp_var_ = IRVar(symbol_table_.alloc_var());
-    ir_builder_->new_ir(to_ir_op(additive->op()),
-                        new_ir_addr(tmp_var_),
-                        new_ir_addr(right_var1),
-                        new_ir_addr(right_var2));
-  } else {
-    visit(additive->right());
+  auto left = translate_operand(binary_expr->left());
+  auto right = translate_operand(binary_expr->right());
+  auto ir_op = to_ir_op(binary_expr->op());
+  if (left.is_imm() && !right.is_imm() && can_swap_operands(ir_op)) {  // 立即数尽量放在第二个操作数
+    std::swap(left, right);
+    ir_op = swap_operands_op(ir_op);
   }
-}
-void Translator::visit(MultiplicativePtr &multiplicative) {
-  if (multiplicative->left()) {
-    visit(multiplicative->left());
-    auto right_var1 = tmp_var_;
-    visit(multiplicative->right());
-    auto right_var2 = tmp_var_;
-    tmp_var_ = IRVar(symbol_table_.alloc_var());
-    ir_builder_->new_ir(to_ir_op(multiplicative->op()),
-                        new_ir_addr(tmp_var_),
-                        new_ir_addr(right_var1),
-                        new_ir_addr(right_var2));
-  } else {
-    visit(multiplicative->right());
+  auto left_var = to_var(left);
+  tmp_var_ = IRVar::local(symbol_table_.alloc_var());
+  ir_builder_->new_ir(ir_op,
+                      IRAddr(tmp_var_),
+                      IRAddr(left_var),
+                      right);
+}
+void Translator::visit(ConditionalExprPtr &conditional_expr) {
+  // 字面量(包括取负的字面量，见translate_operand)和非数组的局部变量(包括参数)不生成指令，求值没有副作用
+  auto is_cheap = [](const ExpressionPtr &exp) {
+    if (exp->kind() == Expression::Kind::Literal) return true;
+    if (exp->kind() == Expression::Kind::Unary) {
+      auto unary_expr = static_cast<UnaryExprPtr>(exp);
+      return unary_expr->op() == UnaryExpr::Op::Sub && unary_expr->operand()->kind() == Expression::Kind::Literal;
+    }
+    if (exp->kind() != Expression::Kind::Ref) return false;
+    auto variable = static_cast<RefPtr>(exp)->variable();
+    return !variable->is_global() && !variable->type().is_array();
+  };
+  auto is_logical = [](const ExpressionPtr &exp, bool include_compare) {
+    if (exp->kind() == Expression::Kind::Unary) {
+      return include_compare && static_cast<UnaryExprPtr>(exp)->op() == UnaryExpr::Op::Lnot;
+    }
+    if (exp->kind() != Expression::Kind::Binary) return false;
+    auto op = static_cast<BinaryExprPtr>(exp)->op();
+    if (op == BinaryExpr::Op::Land || op == BinaryExpr::Op::Lor) return true;
+    return include_compare && op >= BinaryExpr::Op::Less && op <= BinaryExpr::Op::Nequal;
+  };
+  auto &cond = conditional_expr->cond();
+  if (auto value = const_cond(cond)) {  // 条件是常量时只翻译被选中的分支
+    visit(*value ? conditional_expr->cond_true() : conditional_expr->cond_false());
+    return;
   }
-}
-void Translator::visit(UnaryPtr &unary) {
-  if (std::holds_alternative<PostfixPtr>(unary->value())) {
-    visit(std::get<PostfixPtr>(unary->value()));
-  } else if (std::holds_alternative<UnaryPtr>(unary->value())) {
-    visit(std::get<UnaryPtr>(unary->value()));
-    auto right_var = tmp_var_;
-    tmp_var_ = IRVar(symbol_table_.alloc_var());
-    ir_builder_->new_ir(to_ir_op(unary->op()), new_ir_addr(tmp_var_), new_ir_addr(right_var));
-  } else { assert(false); }
-}
-void Translator::visit(PostfixPtr &postfix) {
-  if (std::holds_alternative<PrimaryPtr>(postfix->value())) {
-    visit(std::get<PrimaryPtr>(postfix->value()));
-  } else if (std::holds_alternative<FuncCallPtr>(postfix->value())) {
-    visit(std::get<FuncCallPtr>(postfix->value()));
-  } else if (std::holds_alternative<ArrayPtr>(postfix->value())) {
-    visit(std::get<ArrayPtr>(postfix->value()));
-    // 暂时不处理
-  } else { assert(false); }
-}
-void Translator::visit(PrimaryPtr &primary) {
-  if (std::holds_alternative<ExpressionPtr>(primary->value())) {
-    visit(std::get<ExpressionPtr>(primary->value()));
-  } else if (std::holds_alternative<int>(primary->value())) {
-    int imm = std::get<int>(primary->value());
-    tmp_var_ = IRVar(symbol_table_.alloc_var());
-    ir_builder_->new_ir(IROp::MOV, new_ir_addr(tmp_var_), new_ir_addr(imm));
-  } else if (std::holds_alternative<std::string>(primary->value())) {
-    auto name = std::get<std::string>(primary->value());
-    tmp_var_ = symbol_table_.lookup_ir_var(name);
-    auto[variable, is_global] = symbol_table_.lookup_variable(name);
-    bool is_array = variable->type().is_array();
-    if (tmp_var_.is_global()) { // 全局变量
-      tmp_var_ = IRVar(symbol_table_.alloc_var());
-      ir_builder_->new_ir(IROp::LA, new_ir_addr(tmp_var_), new_ir_addr(name));
-      if (!is_array) {  // 数组类型只需加载到地址，而变量类型需要加载到值
-        auto addr_var = tmp_var_;
-        tmp_var_ = IRVar(symbol_table_.alloc_var());
-        ir_builder_->new_ir(IROp::LOAD, new_ir_addr(tmp_var_), new_ir_addr(addr_var), new_ir_addr(0));
-      }
-    } // 局部变量无需做额外处理
-    name_ = variable->name();
-  } else { assert(false); }
+  if (is_cheap(conditional_expr->cond_true()) && is_cheap(conditional_expr->cond_false())
+      && !is_logical(cond, false)) {
+    // 两个分支都很简单时不跳转：result = false + (true - false) * (cond != 0)
+    visit(cond);
+    auto cond_var = tmp_var_;
+    if (!is_logical(cond, true)) {  // 比较和!的结果已经是0或1
+      cond_var = IRVar::local(symbol_table_.alloc_var());
+      ir_builder_->new_ir(IROp::NE, IRAddr(cond_var), IRAddr(tmp_var_), IRAddr(0));
+    }
+    auto true_value = translate_operand(conditional_expr->cond_true());
+    auto false_value = translate_operand(conditional_expr->cond_false());
+    auto diff_var = IRVar::local(symbol_table_.alloc_var());
+    if (true_value.is_imm() && false_value.is_imm()) {  // 两个分支都是常量时差值也是常量
+      auto diff = static_cast<int>(static_cast<unsigned>(true_value.imm()) - static_cast<unsigned>(false_value.imm()));
+      ir_builder_->new_ir(IROp::MUL, IRAddr(diff_var), IRAddr(cond_var), IRAddr(diff));
+    } else {
+      ir_builder_->new_ir(IROp::SUB, IRAddr(diff_var), IRAddr(to_var(true_value)), false_value);
+      ir_builder_->new_ir(IROp::MUL, IRAddr(diff_var), IRAddr(diff_var), IRAddr(cond_var));
+    }
+    tmp_var_ = IRVar::local(symbol_table_.alloc_var());
+    ir_builder_->new_ir(IROp::ADD, IRAddr(tmp_var_), IRAddr(diff_var), false_value);
+    return;
+  }
+  // 只计算被选中的分支，两个分支的值都MOV到同一个临时变量中
+  auto result_var = IRVar::local(symbol_table_.alloc_var());
+  int false_label = symbol_table_.alloc_label();
+  int end_label = symbol_table_.alloc_label();
+  translate_cond(cond, false_label);
+  visit(conditional_expr->cond_true());
+  ir_builder_->new_ir(IROp::MOV, IRAddr(result_var), IRAddr(tmp_var_));
+  ir_builder_->new_ir(IROp::JMP, IRAddr(end_label));
+  ir_builder_->new_ir(IROp::LABEL, IRAddr(false_label));
+  visit(conditional_expr->cond_false());
+  ir_builder_->new_ir(IROp::MOV, IRAddr(result_var), IRAddr(tmp_var_));
+  ir_builder_->new_ir(IROp::LABEL, IRAddr(end_label));
+  tmp_var_ = result_var;
 }
 void Translator::visit(ReturnStatementPtr &return_statement) {
-  visit(return_statement->exp());
-  ir_builder_->new_ir(IROp::RET, new_ir_addr(tmp_var_));
+  ir_builder_->new_ir(IROp::RET, translate_operand(return_statement->exp()));
 }
 void Translator::visit(ExpStatementPtr &exp_statement) {
   if (exp_statement->exp()) {
@@ -276,18 +367,25 @@ void Translator::visit(ExpStatementPtr &exp_statement) {
   }
 }
 void Translator::visit(IfStatementPtr &if_statement) {
-  visit(if_statement->cond_exp());
+  if (auto value = const_cond(if_statement->cond_exp())) {  // 条件是常量时不翻译不会执行的分支
+    if (*value) {
+      visit(if_statement->if_stmt());
+    } else if (if_statement->else_stmt()) {
+      visit(if_statement->else_stmt());
+    }
+    return;
+  }
   int false_label_number = symbol_table_.alloc_label();
-  ir_builder_->new_ir(IROp::BEQZ, new_ir_addr(tmp_var_), new_ir_addr(false_label_number));
+  translate_cond(if_statement->cond_exp(), false_label_number);
   visit(if_statement->if_stmt());
   if (if_statement->else_stmt()) {  // has else branch
     int end_label_number = symbol_table_.alloc_label();
-    ir_builder_->new_ir(IROp::JMP, new_ir_addr(end_label_number));
-    ir_builder_->new_ir(IROp::LABEL, new_ir_addr(false_label_number));
+    ir_builder_->new_ir(IROp::JMP, IRAddr(end_label_number));
+    ir_builder_->new_ir(IROp::LABEL, IRAddr(false_label_number));
     visit(if_statement->else_stmt());
-    ir_builder_->new_ir(IROp::LABEL, new_ir_addr(end_label_number));
+    ir_builder_->new_ir(IROp::LABEL, IRAddr(end_label_number));
   } else {  // no else branch, false_label就是end_label
-    ir_builder_->new_ir(IROp::LABEL, new_ir_addr(false_label_number));
+    ir_builder_->new_ir(IROp::LABEL, IRAddr(false_label_number));
   }
 }
 void Translator::visit(ForExpStatementPtr &for_exp_statement) {
@@ -295,18 +393,21 @@ void Translator::visit(ForExpStatementPtr &for_exp_statement) {
   if (for_exp_statement->init_exp()) {
     visit(for_exp_statement->init_exp());
   }
-  ir_builder_->new_ir(IROp::LABEL, new_ir_addr(symbol_table_.loop_begin_label()));
-  if (for_exp_statement->cond_exp()) {
-    visit(for_exp_statement->cond_exp());
+  if (for_exp_statement->cond_exp() && const_cond(for_exp_statement->cond_exp()) == false) {  // 循环体一次也不执行
+    symbol_table_.leave_loop();
+    return;
+  }
+  ir_builder_->new_ir(IROp::LABEL, IRAddr(symbol_table_.loop_begin_label()));
+  if (for_exp_statement->cond_exp()) {  // 没有条件时不跳出循环
+    translate_cond(for_exp_statement->cond_exp(), symbol_table_.loop_break_label());
   }
-  ir_builder_->new_ir(IROp::BEQZ, new_ir_addr(tmp_var_), new_ir_addr(symbol_table_.loop_break_label()));
   visit(for_exp_statement->statement());
-  ir_builder_->new_ir(IROp::LABEL, new_ir_addr(symbol_table_.loop_continue_label()));
+  ir_builder_->new_ir(IROp::LABEL, IRAddr(symbol_table_.loop_continue_label()));
   if (for_exp_statement->update_exp()) {
     visit(for_exp_statement->update_exp());
   }
-  ir_builder_->new_ir(IROp::JMP, new_ir_addr(symbol_table_.loop_begin_label()));
-  ir_builder_->new_ir(IROp::LABEL, new_ir_addr(symbol_table_.loop_break_label()));
+  ir_builder_->new_ir(IROp::JMP, IRAddr(symbol_table_.loop_begin_label()));
+  ir_builder_->new_ir(IROp::LABEL, IRAddr(symbol_table_.loop_break_label()));
   symbol_table_.leave_loop();
 }
 void Translator::visit(ForDecStatementPtr &for_dec_statement) {
@@ -314,103 +415,65 @@ void Translator::visit(ForDecStatementPtr &for_dec_statement) {
   if (for_dec_statement->init_decl()) {
     visit(for_dec_statement->init_decl());
   }
-  ir_builder_->new_ir(IROp::LABEL, new_ir_addr(symbol_table_.loop_begin_label()));
-  if (for_dec_statement->cond_exp()) {
-    visit(for_dec_statement->cond_exp());
+  if (for_dec_statement->cond_exp() && const_cond(for_dec_statement->cond_exp()) == false) {  // 循环体一次也不执行
+    symbol_table_.leave_loop();
+    return;
+  }
+  ir_builder_->new_ir(IROp::LABEL, IRAddr(symbol_table_.loop_begin_label()));
+  if (for_dec_statement->cond_exp()) {  // 没有条件时不跳出循环
+    translate_cond(for_dec_statement->cond_exp(), symbol_table_.loop_break_label());
   }
-  ir_builder_->new_ir(IROp::BEQZ, new_ir_addr(tmp_var_), new_ir_addr(symbol_table_.loop_break_label()));
   visit(for_dec_statement->statement());
-  ir_builder_->new_ir(IROp::LABEL, new_ir_addr(symbol_table_.loop_continue_label()));
+  ir_builder_->new_ir(IROp::LABEL, IRAddr(symbol_table_.loop_continue_label()));
   if (for_dec_statement->update_exp()) {
     visit(for_dec_statement->update_exp());
   }
-  ir_builder_->new_ir(IROp::JMP, new_ir_addr(symbol_table_.loop_begin_label()));
-  ir_builder_->new_ir(IROp::LABEL, new_ir_addr(symbol_table_.loop_break_label()));
+  ir_builder_->new_ir(IROp::JMP, IRAddr(symbol_table_.loop_begin_label()));
+  ir_builder_->new_ir(IROp::LABEL, IRAddr(symbol_table_.loop_break_label()));
   symbol_table_.leave_loop();
 }
 void Translator::visit(WhileStatementPtr &while_statement) {
+  if (const_cond(while_statement->cond_exp()) == false) return;  // 循环体一次也不执行
   symbol_table_.enter_loop();
-  ir_builder_->new_ir(IROp::LABEL, new_ir_addr(symbol_table_.loop_begin_label()));
-  ir_builder_->new_ir(IROp::LABEL, new_ir_addr(symbol_table_.loop_continue_label()));
-  visit(while_statement->cond_exp());
-  ir_builder_->new_ir(IROp::BEQZ, new_ir_addr(tmp_var_), new_ir_addr(symbol_table_.loop_break_label()));
+  ir_builder_->new_ir(IROp::LABEL, IRAddr(symbol_table_.loop_begin_label()));
+  ir_builder_->new_ir(IROp::LABEL, IRAddr(symbol_table_.loop_continue_label()));
+  translate_cond(while_statement->cond_exp(), symbol_table_.loop_break_label());
   visit(while_statement->statement());
-  ir_builder_->new_ir(IROp::JMP, new_ir_addr(symbol_table_.loop_begin_label()));
-  ir_builder_->new_ir(IROp::LABEL, new_ir_addr(symbol_table_.loop_break_label()));
+  ir_builder_->new_ir(IROp::JMP, IRAddr(symbol_table_.loop_begin_label()));
+  ir_builder_->new_ir(IROp::LABEL, IRAddr(symbol_table_.loop_break_label()));
   symbol_table_.leave_loop();
 }
 void Translator::visit(DoStatementPtr &do_statement) {
   symbol_table_.enter_loop();
-  ir_builder_->new_ir(IROp::LABEL, new_ir_addr(symbol_table_.loop_begin_label()));
+  ir_builder_->new_ir(IROp::LABEL, IRAddr(symbol_table_.loop_begin_label()));
   visit(do_statement->statement());
-  ir_builder_->new_ir(IROp::LABEL, new_ir_addr(symbol_table_.loop_continue_label()));
-  visit(do_statement->cond_exp());
-  ir_builder_->new_ir(IROp::BEQZ, new_ir_addr(tmp_var_), new_ir_addr(symbol_table_.loop_break_label()));
-  ir_builder_->new_ir(IROp::JMP, new_ir_addr(symbol_table_.loop_begin_label()));
-  ir_builder_->new_ir(IROp::LABEL, new_ir_addr(symbol_table_.loop_break_label()));
+  ir_builder_->new_ir(IROp::LABEL, IRAddr(symbol_table_.loop_continue_label()));
+  translate_cond(do_statement->cond_exp(), symbol_table_.loop_begin_label(), true);
+  ir_builder_->new_ir(IROp::LABEL, IRAddr(symbol_table_.loop_break_label()));
   symbol_table_.leave_loop();
 }
 void Translator::visit(BreakStatementPtr &break_statement) {
-  ir_builder_->new_ir(IROp::JMP, new_ir_addr(symbol_table_.loop_break_label()));
+  ir_builder_->new_ir(IROp::JMP, IRAddr(symbol_table_.loop_break_label()));
 }
 void Translator::visit(ContinueStatementPtr &continue_statement) {
-  ir_builder_->new_ir(IROp::JMP, new_ir_addr(symbol_table_.loop_continue_label()));
+  ir_builder_->new_ir(IROp::JMP, IRAddr(symbol_table_.loop_continue_label()));
 }
-void Translator::visit(AssignExpPtr &assign_exp) {
-  visit(assign_exp->right()); // 先访问右边的表达式
-  auto right_var1 = tmp_var_;
-  visit(assign_exp->left());
-  auto unary_name = name_;
-  auto[var, is_global] = symbol_table_.lookup_variable(unary_name);
-  if (is_global || var->type().is_array()) {  // 全局变量或全局数组或局部数组，都要用STORE指令存入内存中
+void Translator::visit(AssignExprPtr &assign_expr) {
+  auto right = translate_operand(assign_expr->right()); // 先访问右边的表达式
+  visit(assign_expr->left());
+  auto var = variable_;
+  if (var->is_global() || var->type().is_array()) {  // 全局变量或全局数组或局部数组，都要用STORE指令存入内存中
     // 直接把最后一条LOAD指令改成STORE指令
     ir_builder_->last_ir()->op() = IROp::STORE;
-    ir_builder_->last_ir()->a0() = new_ir_addr(right_var1);
-  } else {
-    ir_builder_->new_ir(IROp::MOV, new_ir_addr(tmp_var_), new_ir_addr(right_var1));
-  }
-  // 不修改tmp_var_，这样assign_exp的返回值就是左边的值
-}
-void Translator::visit(FuncCallPtr &func_call) {
-  visit(func_call->expression_list());
-  tmp_var_ = IRVar(symbol_table_.alloc_var());
-  ir_builder_->new_ir(IROp::CALL, new_ir_addr(tmp_var_), new_ir_addr(func_call->func_name()));
-}
-void Translator::visit(ArrayPtr &array) {
-  if (std::holds_alternative<PrimaryPtr>(array->name())) {
-    auto primary = std::get<PrimaryPtr>(array->name());
-    visit(primary);
-    auto base_var = tmp_var_;
-    auto array_name = name_;
-    auto[result, is_global] = symbol_table_.lookup_variable(array_name);
-    auto dimension_vec = result->type().dimension_vec();
-    int sz = dimension_vec.size();
-    std::vector<int> offset_vec(sz);
-    int ini = 1;
-    for (int i = sz - 1; i >= 0; --i) {
-      if (i == sz - 1) {
-        offset_vec[i] = ini;
-      } else {
-        offset_vec[i] = offset_vec[i - 1] * dimension_vec[i - 1];
-      }
-    }
-    auto offset_var = IRVar(symbol_table_.alloc_var());
-    ir_builder_->new_ir(IROp::MOV, new_ir_addr(offset_var), new_ir_addr(0));  // 初始化为0
-    for (int i = 0; i < sz; ++i) {
-      visit(array->expression_vec()[i]);
-      auto t_var = IRVar(symbol_table_.alloc_var());
-      ir_builder_->new_ir(IROp::MUL, new_ir_addr(t_var), new_ir_addr(tmp_var_), new_ir_addr(offset_vec[i]));
-      ir_builder_->new_ir(IROp::ADD, new_ir_addr(offset_var), new_ir_addr(offset_var), new_ir_addr(t_var));
+    ir_builder_->last_ir()->a0() = right;
+    // LOAD的目标变量不再被赋值，assign_expr的返回值改为右边的值，例如(g = 7) && a
+    if (right.is_var()) {
+      tmp_var_ = right.var();
+    } else {
+      ir_builder_->new_ir(IROp::MOV, IRAddr(tmp_var_), right);
     }
-    ir_builder_->new_ir(IROp::MUL, new_ir_addr(offset_var), new_ir_addr(offset_var), new_ir_addr(4)); // 偏移量乘以4
-    auto addr_var = IRVar(symbol_table_.alloc_var());
-    ir_builder_->new_ir(IROp::SUB, new_ir_addr(addr_var), new_ir_addr(base_var), new_ir_addr(offset_var));
-    tmp_var_ = IRVar(symbol_table_.alloc_var());
-    ir_builder_->new_ir(IROp::LOAD, new_ir_addr(tmp_var_), new_ir_addr(addr_var), new_ir_addr(0));
-    name_ = array_name;
-  } else if (std::holds_alternative<FuncCallPtr>(array->name())) {
-    assert(false);  // 不支持该语法
   } else {
-    assert(false);
+    // 不修改tmp_var_，这样assign_expr的返回值就是左边的值
+    ir_builder_->new_ir(IROp::MOV, IRAddr(tmp_var_), right);
   }
 }
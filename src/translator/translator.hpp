@@ -4,56 +4,67 @@
 #include "visitor.hpp"
 #include "symbol_table.hpp"
 #include "ir.hpp"
+#include "line_table.hpp"
 
-class Translator : DetailedASTVisitor {
+#include <optional>
+
+class Translator : ASTVisitor<Translator> {
+  friend class ASTVisitor<Translator>;
  public:
-  Translator() : ir_builder_(std::make_shared<IRBuilder>()) {}
+  // line_table不为nullptr时，在每条语句之前生成LOC指令
+  explicit Translator(LineTable *line_table = nullptr)
+      : ir_builder_(std::make_shared<IRBuilder>()), line_table_(line_table) {}
   ~Translator() = default;
   IRBuilderPtr translate(ProgramPtr &program);
  private:
-  void visit(ProgramPtr &program) override;
-  void visit(FunctionPtr &function) override;
-  void visit(BaseType &type) override;
-  void visit(ParameterListPtr &parameter_list) override;
-  void visit(CompoundStatementPtr &compound_statement) override;
-  void visit(BlockItemPtr &block_item) override;
-  void visit(StatementPtr &statement) override;
-  void visit(DeclarationPtr &declaration) override;
-  void visit(ExpressionListPtr &expression_list) override;
-  void visit(ExpressionPtr &expression) override;
-  void visit(AssignmentPtr &assignment) override;
-  void visit(ConditionalPtr &conditional) override;
-  void visit(LogicalOrPtr &logical_or) override;
-  void visit(LogicalAndPtr &logical_and) override;
-  void visit(EqualityPtr &equality) override;
-  void visit(RelationalPtr &relational) override;
-  void visit(AdditivePtr &additive) override;
-  void visit(MultiplicativePtr &multiplicative) override;
-  void visit(UnaryPtr &unary) override;
-  void visit(PostfixPtr &postfix) override;
-  void visit(PrimaryPtr &primary) override;
-  void visit(ReturnStatementPtr &return_statement) override;
-  void visit(ExpStatementPtr &exp_statement) override;
-  void visit(IfStatementPtr &if_statement) override;
-  void visit(ForExpStatementPtr &for_exp_statement) override;
-  void visit(ForDecStatementPtr &for_dec_statement) override;
-  void visit(WhileStatementPtr &while_statement) override;
-  void visit(DoStatementPtr &do_statement) override;
-  void visit(BreakStatementPtr &break_statement) override;
-  void visit(ContinueStatementPtr &continue_statement) override;
-  void visit(AssignExpPtr &assign_exp) override;
-  void visit(FuncCallPtr &func_call) override;
-  void visit(ArrayPtr &array) override;
+  void visit(ProgramPtr &program);
+  void visit(FunctionPtr &function);
+  void visit(BaseType &type);
+  void visit(ParameterListPtr &parameter_list);
+  void visit(CompoundStatementPtr &compound_statement);
+  void visit(BlockItemPtr &block_item);
+  void visit(StatementPtr &statement);
+  void visit(DeclarationPtr &declaration);
+  void visit(ExpressionListPtr &expression_list);
+  void visit(ExpressionPtr &expression);
+  void visit(ReturnStatementPtr &return_statement);
+  void visit(ExpStatementPtr &exp_statement);
+  void visit(IfStatementPtr &if_statement);
+  void visit(ForExpStatementPtr &for_exp_statement);
+  void visit(ForDecStatementPtr &for_dec_statement);
+  void visit(WhileStatementPtr &while_statement);
+  void visit(DoStatementPtr &do_statement);
+  void visit(BreakStatementPtr &break_statement);
+  void visit(ContinueStatementPtr &continue_statement);
+  void visit(LiteralPtr &literal);
+  void visit(RefPtr &ref);
+  void visit(CallPtr &call);
+  void visit(IndexPtr &index);
+  void visit(UnaryExprPtr &unary_expr);
+  void visit(BinaryExprPtr &binary_expr);
+  void visit(ConditionalExprPtr &conditional_expr);
+  void visit(AssignExprPtr &assign_expr);
+
+  void new_loc(SourceOffset offset);
+  // 条件的真假等于jump_if时跳转到label，否则顺序执行
+  void translate_cond(ExpressionPtr &cond, int label, bool jump_if = false);
+  // 不求值就能确定真假的条件(字面量以及由它们组成的!、&&和||)返回其真假，否则返回空
+  static std::optional<bool> const_cond(const ExpressionPtr &cond);
+  // 字面量(包括取负的字面量)直接作为立即数，不生成指令；其他表达式返回保存结果的变量
+  IRAddr translate_operand(ExpressionPtr &exp);
+  // 指令的第一个源操作数必须是变量，立即数先MOV到新的变量中
+  IRVar to_var(IRAddr addr);
 
   IRBuilderPtr ir_builder_;
+  LineTable *line_table_;
   SymbolTable symbol_table_;
   IRVar tmp_var_;
-  // 之所以保存IRVar而不是保存IRAddrPtr，是因为我觉得一个变量在不同语句中的出现不应该共享相同的地址，应该每次重新分配
-  std::string name_;
+  // 操作数直接保存在指令中，所以一个变量在不同语句中的出现不会共享同一个操作数
+  VariablePtr variable_{nullptr};  // 最近一次访问的Ref或Index对应的变量，供Index和AssignExpr使用
 };
 
-inline IRBuilderPtr translate(ProgramPtr &program) {
-  Translator translator;
+inline IRBuilderPtr translate(ProgramPtr &program, LineTable *line_table = nullptr) {
+  Translator translator(line_table);
   return translator.translate(program);
 }
 
@@ -0,0 +1,584 @@
+#include "ast_cache.hpp"
+
+#include "visitor.hpp"
+#include "byte_stream.hpp"
+#include "string_util.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// AST的结构改变时需要增加版本号，使旧的缓存失效
+constexpr uint64_t kFormatVersion = 1;
+constexpr std::string_view kCacheMagic = "SCAC";
+
+// 可以为空的指针先写入一个标记：0表示nullptr
+// 表达式的标记为kind() + 1，语句的类型为variant的下标
+class ASTWriter : public ASTVisitor<ASTWriter> {
+  friend class ASTVisitor<ASTWriter>;
+ public:
+  std::string write(ProgramPtr &program) {
+    visit(program);
+    ByteWriter header;
+    header.write_uint(kFormatVersion);
+    header.write_uint(name_vec_.size());
+    for (auto name : name_vec_) {
+      auto str = name.str();
+      header.write_uint(str.size());
+      header.write_bytes(str);
+    }
+    header.write_bytes(out_.buf());
+    return std::move(header.buf());
+  }
+
+ private:
+  void write_name(Symbol name) {
+    auto [it, inserted] = name_index_.try_emplace(name, name_vec_.size());
+    if (inserted) name_vec_.push_back(name);
+    out_.write_uint(it->second);
+  }
+  void write_offset(const SourceNode &node) {
+    int64_t offset = node.offset() == kNoOffset ? 0 : static_cast<int64_t>(node.offset()) + 1;
+    out_.write_int(offset - last_offset_);
+    last_offset_ = offset;
+  }
+  void write_variable(VariablePtr variable) {
+    write_name(variable->name());
+    write_offset(*variable);
+    out_.write_uint(variable->param_num());
+    out_.write_uint(static_cast<uint64_t>(variable->type().type()));
+    out_.write_uint(variable->type().dimension_vec().size());
+    for (auto dim : variable->type().dimension_vec()) {
+      out_.write_int(dim);
+    }
+  }
+  void write_expression(ExpressionPtr expression) {
+    if (!expression) {
+      out_.write_uint(0);
+      return;
+    }
+    visit(expression);
+  }
+  void write_statement(StatementPtr statement) {
+    out_.write_uint(statement ? 1 : 0);
+    if (statement) visit(statement);
+  }
+
+  void visit(ProgramPtr &program) {
+    out_.write_uint(program->func_decl_vec().size());
+    for (auto &item : program->func_decl_vec()) {
+      out_.write_uint(item.index());
+      visit_variant(item);
+    }
+  }
+  void visit(FunctionPtr &function) {
+    visit(function->ret_type());
+    write_name(function->name());
+    write_offset(*function);
+    visit(function->parameter_list());
+    out_.write_uint(function->compound_statement() ? 1 : 0);
+    if (function->compound_statement()) visit(function->compound_statement());
+  }
+  void visit(BaseType &type) {
+    out_.write_uint(static_cast<uint64_t>(type.type()));
+  }
+  void visit(ParameterListPtr &parameter_list) {
+    out_.write_uint(parameter_list->variables().size());
+    for (auto &var : parameter_list->variables()) {
+      write_variable(var);
+    }
+  }
+  void visit(CompoundStatementPtr &compound_statement) {
+    out_.write_uint(compound_statement->block_item_vec().size());
+    for (auto &block_item : compound_statement->block_item_vec()) {
+      visit(block_item);
+    }
+  }
+  void visit(BlockItemPtr &block_item) {
+    out_.write_uint(block_item->value().index());
+    visit_variant(block_item->value());
+  }
+  void visit(StatementPtr &statement) {
+    out_.write_uint(statement->value().index());
+    write_offset(*statement);
+    visit_variant(statement->value());
+  }
+  void visit(DeclarationPtr &declaration) {
+    write_offset(*declaration);
+    write_variable(declaration->var());
+    write_expression(declaration->init_exp());
+  }
+  void visit(ExpressionListPtr &expression_list) {
+    out_.write_uint(expression_list->expression_vec().size());
+    for (auto &exp : expression_list->expression_vec()) {
+      visit(exp);
+    }
+  }
+  void visit(ExpressionPtr &expression) {
+    out_.write_uint(static_cast<uint64_t>(expression->kind()) + 1);
+    write_offset(*expression);
+    visit_expression(expression);
+  }
+
+  void visit(ReturnStatementPtr &return_statement) {
+    write_expression(return_statement->exp());
+  }
+  void visit(ExpStatementPtr &exp_statement) {
+    write_expression(exp_statement->exp());
+  }
+  void visit(IfStatementPtr &if_statement) {
+    write_expression(if_statement->cond_exp());
+    write_statement(if_statement->if_stmt());
+    write_statement(if_statement->else_stmt());
+  }
+  void visit(ForExpStatementPtr &for_exp_statement) {
+    write_expression(for_exp_statement->init_exp());
+    write_expression(for_exp_statement->cond_exp());
+    write_expression(for_exp_statement->update_exp());
+    write_statement(for_exp_statement->statement());
+  }
+  void visit(ForDecStatementPtr &for_dec_statement) {
+    visit(for_dec_statement->init_decl());
+    write_expression(for_dec_statement->cond_exp());
+    write_expression(for_dec_statement->update_exp());
+    write_statement(for_dec_statement->statement());
+  }
+  void visit(WhileStatementPtr &while_statement) {
+    write_expression(while_statement->cond_exp());
+    write_statement(while_statement->statement());
+  }
+  void visit(DoStatementPtr &do_statement) {
+    write_statement(do_statement->statement());
+    write_expression(do_statement->cond_exp());
+  }
+  void visit(BreakStatementPtr &break_statement) {
+    write_offset(*break_statement);
+  }
+  void visit(ContinueStatementPtr &continue_statement) {
+    write_offset(*continue_statement);
+  }
+  void visit(LiteralPtr &literal) {
+    out_.write_int(literal->value());
+  }
+  void visit(RefPtr &ref) {
+    write_name(ref->name());
+  }
+  void visit(CallPtr &call) {
+    write_name(call->func_name());
+    visit(call->expression_list());
+  }
+  void visit(IndexPtr &index) {
+    visit(index->base());
+    out_.write_uint(index->index_vec().size());
+    for (auto &exp : index->index_vec()) {
+      visit(exp);
+    }
+  }
+  void visit(UnaryExprPtr &unary_expr) {
+    out_.write_uint(static_cast<uint64_t>(unary_expr->op()));
+    visit(unary_expr->operand());
+  }
+  void visit(BinaryExprPtr &binary_expr) {
+    out_.write_uint(static_cast<uint64_t>(binary_expr->op()));
+    visit(binary_expr->left());
+    visit(binary_expr->right());
+  }
+  void visit(ConditionalExprPtr &conditional_expr) {
+    visit(conditional_expr->cond());
+    visit(conditional_expr->cond_true());
+    visit(conditional_expr->cond_false());
+  }
+  void visit(AssignExprPtr &assign_expr) {
+    visit(assign_expr->left());
+    visit(assign_expr->right());
+  }
+
+  ByteWriter out_;
+  std::unordered_map<Symbol, uint64_t> name_index_;
+  std::vector<Symbol> name_vec_;
+  int64_t last_offset_{0};
+};
+
+// 与ASTWriter的顺序一一对应，和RecursiveDescentParser一样通过visit的参数返回新建的节点
+class ASTReader : public ASTVisitor<ASTReader> {
+ public:
+  ASTReader(std::string_view data, Arena &arena) : in_(data), arena_(arena) {}
+
+  ProgramPtr read() {
+    if (in_.read_uint() != kFormatVersion) throw bad_format();
+    auto name_count = in_.read_count();
+    name_vec_.reserve(name_count);
+    for (std::size_t i = 0; i < name_count; ++i) {
+      name_vec_.push_back(Symbol::intern(in_.read_bytes(in_.read_count())));
+    }
+    ProgramPtr program = nullptr;
+    visit(program);
+    if (!in_.eof()) throw bad_format();
+    return program;
+  }
+
+ private:
+  Symbol read_name() { return name_vec_[in_.read_index(name_vec_.size() - 1)]; }
+  // 读取的offset设置到node中
+  void read_offset(SourceNode &node) {
+    last_offset_ += in_.read_int();
+    if (last_offset_ < 0 || last_offset_ > kNoOffset) throw bad_format();
+    node.set_offset(last_offset_ == 0 ? kNoOffset : static_cast<SourceOffset>(last_offset_ - 1));
+  }
+  SupportType read_type() { return static_cast<SupportType>(in_.read_index(static_cast<int>(SupportType::Int))); }
+  template<typename E>
+  E read_enum(E last) { return static_cast<E>(in_.read_index(static_cast<std::size_t>(last))); }
+  VariablePtr read_variable() {
+    auto name = read_name();
+    SourceNode offset;
+    read_offset(offset);
+    auto param_num = static_cast<int>(in_.read_index(INT32_MAX));
+    auto type = read_type();
+    ArenaVector<int> dimension_vec(&arena_);
+    auto dim_count = in_.read_count();
+    dimension_vec.reserve(dim_count);
+    for (std::size_t i = 0; i < dim_count; ++i) {
+      dimension_vec.push_back(static_cast<int>(in_.read_int()));
+    }
+    VariablePtr variable = dimension_vec.empty() ? arena_.make<Variable>(type, name)
+                                                 : arena_.make<Variable>(type, std::move(dimension_vec), name);
+    variable->set_offset(offset.offset());
+    variable->set_param_num(param_num);
+    return variable;
+  }
+  ExpressionPtr read_expression() {
+    ExpressionPtr expression = nullptr;
+    visit(expression);
+    return expression;
+  }
+  // 不能为空的表达式
+  ExpressionPtr read_operand() {
+    auto expression = read_expression();
+    if (!expression) throw bad_format();
+    return expression;
+  }
+  StatementPtr read_statement() {
+    StatementPtr statement = nullptr;
+    if (in_.read_index(1)) visit(statement);
+    return statement;
+  }
+
+  void visit(ProgramPtr &program) {
+    ArenaVector<Program::value_type> func_decl_vec(&arena_);
+    auto count = in_.read_count();
+    func_decl_vec.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      if (in_.read_index(1) == 0) {
+        FunctionPtr function = nullptr;
+        visit(function);
+        func_decl_vec.emplace_back(function);
+      } else {
+        DeclarationPtr declaration = nullptr;
+        visit(declaration);
+        func_decl_vec.emplace_back(declaration);
+      }
+    }
+    program = arena_.make<Program>(std::move(func_decl_vec));
+  }
+  void visit(FunctionPtr &function) {
+    BaseType ret_type;
+    visit(ret_type);
+    auto name = read_name();
+    SourceNode offset;
+    read_offset(offset);
+    ParameterListPtr parameter_list = nullptr;
+    visit(parameter_list);
+    CompoundStatementPtr compound_statement = nullptr;
+    if (in_.read_index(1)) visit(compound_statement);
+    function = arena_.make<Function>(ret_type, name, parameter_list, compound_statement);
+    function->set_offset(offset.offset());
+  }
+  void visit(BaseType &type) {
+    type.set_type(read_type());
+  }
+  void visit(ParameterListPtr &parameter_list) {
+    ArenaVector<VariablePtr> variable_vec(&arena_);
+    auto count = in_.read_count();
+    variable_vec.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      variable_vec.push_back(read_variable());
+    }
+    parameter_list = arena_.make<ParameterList>(std::move(variable_vec));
+  }
+  void visit(CompoundStatementPtr &compound_statement) {
+    ArenaVector<BlockItemPtr> block_item_vec(&arena_);
+    auto count = in_.read_count();
+    block_item_vec.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      BlockItemPtr block_item = nullptr;
+      visit(block_item);
+      block_item_vec.push_back(block_item);
+    }
+    compound_statement = arena_.make<CompoundStatement>(std::move(block_item_vec));
+  }
+  void visit(BlockItemPtr &block_item) {
+    if (in_.read_index(1) == 0) {
+      StatementPtr statement = nullptr;
+      visit(statement);
+      block_item = arena_.make<BlockItem>(statement);
+    } else {
+      DeclarationPtr declaration = nullptr;
+      visit(declaration);
+      block_item = arena_.make<BlockItem>(declaration);
+    }
+  }
+  void visit(StatementPtr &statement) {
+    auto index = in_.read_index(std::variant_size_v<Statement::value_type> - 1);
+    SourceNode offset;
+    read_offset(offset);
+    switch (index) {
+      case 0: statement = arena_.make<Statement>(read_as<ReturnStatementPtr>()); break;
+      case 1: statement = arena_.make<Statement>(read_as<ExpStatementPtr>()); break;
+      case 2: statement = arena_.make<Statement>(read_as<IfStatementPtr>()); break;
+      case 3: statement = arena_.make<Statement>(read_as<CompoundStatementPtr>()); break;
+      case 4: statement = arena_.make<Statement>(read_as<ForExpStatementPtr>()); break;
+      case 5: statement = arena_.make<Statement>(read_as<ForDecStatementPtr>()); break;
+      case 6: statement = arena_.make<Statement>(read_as<WhileStatementPtr>()); break;
+      case 7: statement = arena_.make<Statement>(read_as<DoStatementPtr>()); break;
+      case 8: statement = arena_.make<Statement>(read_as<BreakStatementPtr>()); break;
+      case 9: statement = arena_.make<Statement>(read_as<ContinueStatementPtr>()); break;
+      default: throw bad_format();
+    }
+    statement->set_offset(offset.offset());
+  }
+  void visit(DeclarationPtr &declaration) {
+    SourceNode offset;
+    read_offset(offset);
+    auto variable = read_variable();
+    declaration = arena_.make<Declaration>(variable, read_expression());
+    declaration->set_offset(offset.offset());
+  }
+  void visit(ExpressionListPtr &expression_list) {
+    ArenaVector<ExpressionPtr> expression_vec(&arena_);
+    auto count = in_.read_count();
+    expression_vec.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      expression_vec.push_back(read_operand());
+    }
+    expression_list = arena_.make<ExpressionList>(std::move(expression_vec));
+  }
+  void visit(ExpressionPtr &expression) {
+    auto tag = in_.read_index(static_cast<std::size_t>(Expression::Kind::Assign) + 1);
+    if (tag == 0) {
+      expression = nullptr;
+      return;
+    }
+    SourceNode offset;
+    read_offset(offset);
+    switch (static_cast<Expression::Kind>(tag - 1)) {
+      case Expression::Kind::Literal: expression = read_as<LiteralPtr>(); break;
+      case Expression::Kind::Ref: expression = read_as<RefPtr>(); break;
+      case Expression::Kind::Call: expression = read_as<CallPtr>(); break;
+      case Expression::Kind::Index: expression = read_as<IndexPtr>(); break;
+      case Expression::Kind::Unary: expression = read_as<UnaryExprPtr>(); break;
+      case Expression::Kind::Binary: expression = read_as<BinaryExprPtr>(); break;
+      case Expression::Kind::Conditional: expression = read_as<ConditionalExprPtr>(); break;
+      case Expression::Kind::Assign: expression = read_as<AssignExprPtr>(); break;
+    }
+    expression->set_offset(offset.offset());
+  }
+
+  void visit(ReturnStatementPtr &return_statement) {
+    return_statement = arena_.make<ReturnStatement>(read_operand());
+  }
+  void visit(ExpStatementPtr &exp_statement) {
+    exp_statement = arena_.make<ExpStatement>(read_expression());
+  }
+  void visit(IfStatementPtr &if_statement) {
+    auto cond_exp = read_operand();
+    auto if_stmt = read_statement();
+    auto else_stmt = read_statement();
+    if (!if_stmt) throw bad_format();
+    if_statement = arena_.make<IfStatement>(cond_exp, if_stmt, else_stmt);
+  }
+  void visit(ForExpStatementPtr &for_exp_statement) {
+    auto init_exp = read_expression();
+    auto cond_exp = read_expression();
+    auto update_exp = read_expression();
+    auto statement = read_statement();
+    if (!statement) throw bad_format();
+    for_exp_statement = arena_.make<ForExpStatement>(init_exp, cond_exp, update_exp, statement);
+  }
+  void visit(ForDecStatementPtr &for_dec_statement) {
+    DeclarationPtr init_decl = nullptr;
+    visit(init_decl);
+    auto cond_exp = read_expression();
+    auto update_exp = read_expression();
+    auto statement = read_statement();
+    if (!statement) throw bad_format();
+    for_dec_statement = arena_.make<ForDecStatement>(init_decl, cond_exp, update_exp, statement);
+  }
+  void visit(WhileStatementPtr &while_statement) {
+    auto cond_exp = read_operand();
+    auto statement = read_statement();
+    if (!statement) throw bad_format();
+    while_statement = arena_.make<WhileStatement>(cond_exp, statement);
+  }
+  void visit(DoStatementPtr &do_statement) {
+    auto statement = read_statement();
+    auto cond_exp = read_operand();
+    if (!statement) throw bad_format();
+    do_statement = arena_.make<DoStatement>(statement, cond_exp);
+  }
+  void visit(BreakStatementPtr &break_statement) {
+    break_statement = arena_.make<BreakStatement>();
+    read_offset(*break_statement);
+  }
+  void visit(ContinueStatementPtr &continue_statement) {
+    continue_statement = arena_.make<ContinueStatement>();
+    read_offset(*continue_statement);
+  }
+  void visit(LiteralPtr &literal) {
+    literal = arena_.make<Literal>(static_cast<int>(in_.read_int()));
+  }
+  void visit(RefPtr &ref) {
+    ref = arena_.make<Ref>(read_name());
+  }
+  void visit(CallPtr &call) {
+    auto func_name = read_name();
+    ExpressionListPtr expression_list = nullptr;
+    visit(expression_list);
+    call = arena_.make<Call>(func_name, expression_list);
+  }
+  void visit(IndexPtr &index) {
+    auto base = read_operand();
+    ArenaVector<ExpressionPtr> index_vec(&arena_);
+    auto count = in_.read_count();
+    index_vec.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      index_vec.push_back(read_operand());
+    }
+    index = arena_.make<Index>(base, std::move(index_vec));
+  }
+  void visit(UnaryExprPtr &unary_expr) {
+    auto op = read_enum(UnaryExpr::Op::Lnot);
+    unary_expr = arena_.make<UnaryExpr>(op, read_operand());
+  }
+  void visit(BinaryExprPtr &binary_expr) {
+    auto op = read_enum(BinaryExpr::Op::Lor);
+    auto left = read_operand();
+    binary_expr = arena_.make<BinaryExpr>(left, op, read_operand());
+  }
+  void visit(ConditionalExprPtr &conditional_expr) {
+    auto cond = read_operand();
+    auto cond_true = read_operand();
+    conditional_expr = arena_.make<ConditionalExpr>(cond, cond_true, read_operand());
+  }
+  void visit(AssignExprPtr &assign_expr) {
+    auto left = read_operand();
+    assign_expr = arena_.make<AssignExpr>(left, read_operand());
+  }
+
+  template<typename T>
+  T read_as() {
+    T node = nullptr;
+    visit(node);
+    return node;
+  }
+
+  ByteReader in_;
+  Arena &arena_;
+  std::vector<Symbol> name_vec_;
+  int64_t last_offset_{0};
+};
+
+uint64_t elapsed_us(std::chrono::steady_clock::time_point begin) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+}
+
+}  // namespace
+
+std::string serialize_ast(ProgramPtr &program) {
+  return ASTWriter().write(program);
+}
+
+ProgramPtr deserialize_ast(std::string_view data, Arena &arena) {
+  try {
+    return ASTReader(data, arena).read();
+  } catch (const bad_format &) {
+    return nullptr;
+  }
+}
+
+ASTCache::ASTCache(fs::path dir) : dir_(std::move(dir)) {
+  std::error_code ec;
+  fs::create_directories(dir_, ec);
+  std::ifstream ifs(dir_ / "stats");
+  ifs >> hits_ >> misses_ >> saved_us_;
+  if (!ifs) hits_ = misses_ = saved_us_ = 0;
+}
+
+// 缓存文件：kCacheMagic, 源文件的哈希值, 源文件的长度, 分析时间(us), AST的哈希值, 序列化的AST
+ProgramPtr ASTCache::load(std::string_view source, Arena &arena) {
+  auto begin = std::chrono::steady_clock::now();
+  auto hash = hash_bytes(source);
+  std::ifstream ifs(entry_path(hash), std::ios::binary | std::ios::ate);
+  ProgramPtr program = nullptr;
+  uint64_t parse_us = 0;
+  if (ifs) {
+    std::string data(static_cast<std::size_t>(ifs.tellg()), '\0');
+    ifs.seekg(0);
+    ifs.read(data.data(), static_cast<std::streamsize>(data.size()));
+    try {
+      ByteReader in(data);
+      if (in.read_bytes(kCacheMagic.size()) == kCacheMagic && in.read_uint() == hash
+          && in.read_uint() == source.size()) {
+        parse_us = in.read_uint();
+        auto checksum = in.read_uint();
+        if (hash_bytes(in.rest()) == checksum) program = deserialize_ast(in.rest(), arena);
+      }
+    } catch (const bad_format &) {}
+  }
+  if (program) {
+    ++hits_;
+    last_saved_us_ = static_cast<int64_t>(parse_us) - static_cast<int64_t>(elapsed_us(begin));
+    saved_us_ += last_saved_us_;
+  } else {
+    ++misses_;
+  }
+  save_stats();
+  return program;
+}
+
+void ASTCache::store(std::string_view source, ProgramPtr &program, uint64_t parse_us) {
+  auto hash = hash_bytes(source);
+  ByteWriter out;
+  out.write_bytes(kCacheMagic);
+  out.write_uint(hash);
+  out.write_uint(source.size());
+  out.write_uint(parse_us);
+  auto data = serialize_ast(program);
+  out.write_uint(hash_bytes(data));
+  out.write_bytes(data);
+  // 先写入临时文件再重命名，同时运行的其他编译不会读到写了一半的文件
+  auto path = entry_path(hash);
+  auto tmp_path = fs::path(path).concat(".tmp");
+  {
+    std::ofstream ofs(tmp_path, std::ios::binary);
+    ofs.write(out.buf().data(), static_cast<std::streamsize>(out.buf().size()));
+    if (!ofs) return;
+  }
+  std::error_code ec;
+  fs::rename(tmp_path, path, ec);
+}
+
+fs::path ASTCache::entry_path(uint64_t hash) const {
+  std::stringstream ss;
+  ss << std::hex << std::setw(16) << std::setfill('0') << hash << ".ast";
+  return dir_ / ss.str();
+}
+
+void ASTCache::save_stats() {
+  std::ofstream ofs(dir_ / "stats");
+  ofs << hits_ << " " << misses_ << " " << saved_us_ << "\n";
+}
@@ -0,0 +1,49 @@
+#ifndef SCOMPILER_SRC_UTIL_AST_CACHE_HPP_
+#define SCOMPILER_SRC_UTIL_AST_CACHE_HPP_
+
+#include "ast.hpp"
+#include "arena.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace fs = std::filesystem;
+
+// AST的紧凑二进制格式：先是字符串表，所有名字只保存一次，之后按先序保存各个节点
+// 整数使用LEB128变长编码，节点的offset保存为与上一个offset的差
+std::string serialize_ast(ProgramPtr &program);
+// 名字驻留为Symbol，data不完整或格式不对时返回nullptr
+ProgramPtr deserialize_ast(std::string_view data, Arena &arena);
+
+// 以源文件内容的哈希值为键，将序列化的AST保存在目录dir中，源文件没有改动时不需要再进行词法和语法分析
+// 目录中的stats文件累计记录命中次数、未命中次数和节省的时间
+class ASTCache {
+ public:
+  explicit ASTCache(fs::path dir);
+  ~ASTCache() = default;
+
+  // 命中时返回分配在arena中的AST，否则返回nullptr
+  ProgramPtr load(std::string_view source, Arena &arena);
+  // parse_us为本次词法和语法分析所用的时间，命中时用来计算节省的时间
+  void store(std::string_view source, ProgramPtr &program, uint64_t parse_us);
+
+  // 包括本次在内的累计统计
+  [[nodiscard]] uint64_t hits() const { return hits_; }
+  [[nodiscard]] uint64_t misses() const { return misses_; }
+  [[nodiscard]] int64_t saved_us() const { return saved_us_; }
+  // 本次命中时节省的时间(分析时间减去读取时间)
+  [[nodiscard]] int64_t last_saved_us() const { return last_saved_us_; }
+ private:
+  [[nodiscard]] fs::path entry_path(uint64_t hash) const;
+  void save_stats();
+
+  fs::path dir_;
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+  int64_t saved_us_{0};
+  int64_t last_saved_us_{0};
+};
+
+#endif //SCOMPILER_SRC_UTIL_AST_CACHE_HPP_
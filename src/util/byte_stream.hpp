@@ -0,0 +1,71 @@
+#ifndef SCOMPILER_SRC_UTIL_BYTE_STREAM_HPP_
+#define SCOMPILER_SRC_UTIL_BYTE_STREAM_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// AST缓存和二进制IR共用的编码：整数使用LEB128变长编码，有符号整数先进行zigzag编码
+class ByteWriter {
+ public:
+  void write_uint(uint64_t value) {
+    while (value >= 0x80) {
+      buf_.push_back(static_cast<char>(value | 0x80));
+      value >>= 7;
+    }
+    buf_.push_back(static_cast<char>(value));
+  }
+  // zigzag编码，使绝对值小的负数也只占用很少的字节
+  void write_int(int64_t value) {
+    write_uint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+  }
+  void write_bytes(std::string_view bytes) { buf_.append(bytes); }
+  std::string &buf() { return buf_; }
+ private:
+  std::string buf_;
+};
+
+// 数据不完整或格式不对
+struct bad_format {};
+
+class ByteReader {
+ public:
+  explicit ByteReader(std::string_view data) : data_(data) {}
+
+  uint64_t read_uint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (pos_ == data_.size()) throw bad_format();
+      auto byte = static_cast<unsigned char>(data_[pos_++]);
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) return value;
+    }
+    throw bad_format();
+  }
+  int64_t read_int() {
+    auto value = read_uint();
+    return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+  }
+  // 读取不超过max的非负整数，用于下标、个数和枚举值
+  std::size_t read_index(std::size_t max) {
+    auto value = read_uint();
+    if (value > max) throw bad_format();
+    return value;
+  }
+  // 每个元素至少占用一个字节，个数不会超过剩余的字节数
+  std::size_t read_count() { return read_index(data_.size() - pos_); }
+  std::string_view read_bytes(std::size_t size) {
+    if (size > data_.size() - pos_) throw bad_format();
+    auto bytes = data_.substr(pos_, size);
+    pos_ += size;
+    return bytes;
+  }
+  [[nodiscard]] std::string_view rest() const { return data_.substr(pos_); }
+  [[nodiscard]] bool eof() const { return pos_ == data_.size(); }
+ private:
+  std::string_view data_;
+  std::size_t pos_{0};
+};
+
+#endif //SCOMPILER_SRC_UTIL_BYTE_STREAM_HPP_
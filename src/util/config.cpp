@@ -1,7 +1,10 @@
 #include "config.hpp"
 
 #include <boost/program_options.hpp>
+#include <algorithm>
 #include <iostream>
+#include <sstream>
+#include <thread>
 #include <filesystem>
 
 using namespace boost::program_options;
@@ -17,7 +20,16 @@ void Config::init(int argc, char **argv) {
       ("ir-file,i", value<std::string>(), "file to store ir code")
       ("low-ir-file,l", value<std::string>(), "file to store low ir code(after optimized and reg allocated)")
       ("output-file,o", value<std::string>(), "file to store asm code")
-      ("optimize,O", value<int>(), "optimize level");
+      ("optimize,O", value<int>(), "optimize level")
+      ("debug,g", "emit .file/.loc directives in asm code")
+      ("watch,w", "recompile when input file changes, reparsing only the changed functions")
+      ("lazy", value<std::string>()->implicit_value("main"),
+       "only parse and compile functions reachable from the given comma-separated roots (default: main)")
+      ("ast-cache", value<std::string>(), "directory to cache parsed ast, keyed by the hash of the source file")
+      ("from-ir", "the input file is ir (text from --ir-file or binary from --emit-ir-bin), start from the optimizer")
+      ("emit-ir-bin", value<std::string>(), "file to store binary ir, stop before the optimizer")
+      ("lexer", value<std::string>(), "lexer implementation: spirit|handwritten|table (default: handwritten)")
+      ("jobs,j", value<int>(), "number of threads used by lexer and parser (0 for all cores, default: 1)");
 
   positional_options_description p;
   p.add("input-file", 1);
@@ -60,6 +72,47 @@ void Config::init(int argc, char **argv) {
   if (vm.count("optimize")) {
     optimize_level = vm["optimize"].as<int>();
   }
+  if (vm.count("debug")) {
+    debug_info = true;
+  }
+  if (vm.count("watch")) {
+    watch = true;
+  }
+  if (vm.count("ast-cache")) {
+    ast_cache_dir = vm["ast-cache"].as<std::string>();
+  }
+  if (vm.count("from-ir")) {
+    from_ir = true;
+    if (vm.count("watch") || vm.count("lazy")) {
+      std::cout << "--from-ir cannot be used with --watch or --lazy\n";
+      exit(1);
+    }
+  }
+  if (vm.count("emit-ir-bin")) {
+    emit_ir_bin = true;
+    ir_bin_file = vm["emit-ir-bin"].as<std::string>();
+  }
+  if (vm.count("lazy")) {
+    lazy = true;
+    std::stringstream ss(vm["lazy"].as<std::string>());
+    for (std::string root; std::getline(ss, root, ',');) {
+      if (!root.empty()) lazy_root_vec.push_back(root);
+    }
+  }
+  if (vm.count("jobs")) {
+    jobs = vm["jobs"].as<int>();
+    if (jobs <= 0) {
+      jobs = std::max(1u, std::thread::hardware_concurrency());
+    }
+  }
+  if (vm.count("lexer")) {
+    lexer = vm["lexer"].as<std::string>();
+    if (lexer != "spirit" && lexer != "handwritten" && lexer != "table") {
+      std::cout << "unknown lexer: " << lexer << "\n";
+      std::cout << desc;
+      exit(1);
+    }
+  }
 //  std::cout << "input-file: " << input_file << "\n"
 //            << "token-file: " << token_file << "\n"
 //            << "ast-file: " << ast_file << "\n"
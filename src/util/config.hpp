@@ -2,6 +2,7 @@
 #define SCOMPILER_SRC_BASE_CONFIG_HPP_
 
 #include <string>
+#include <vector>
 
 class Config {
  public:
@@ -16,11 +17,21 @@ class Config {
   std::string ir_file;
   std::string low_ir_file;
   std::string output_file;
+  std::string lexer{"handwritten"};
+  std::string ast_cache_dir;  // 为空时不使用AST缓存
+  std::string ir_bin_file;
   bool print_token{false};
   bool print_ast{false};
   bool print_ir{false};
   bool print_low_ir{false};
+  bool debug_info{false};
+  bool watch{false};
+  bool lazy{false};
+  bool from_ir{false};  // 输入文件为IR，从优化器开始编译
+  bool emit_ir_bin{false};  // 输出二进制IR后停止，不进行优化和生成汇编
+  std::vector<std::string> lazy_root_vec;
   int optimize_level{0};
+  int jobs{1};
 };
 
 inline Config config;
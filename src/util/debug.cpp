@@ -51,25 +51,22 @@ std::string to_string(const TokenType &pt) {
   return "";
 }
 
-std::ostream &operator<<(std::ostream &os, const Token &token) {
-  if (token.is_keyword()) {
-    os << "( " << token.get_string() << " , " << to_string(token.type()) << " )";
-  } else if (token.is_punctuation()) {
-    os << "( " << token.get_string() << " , " << to_string(token.type()) << " )";
-  } else if (token.is_identifier()) {
-    os << "( " << token.get_string() << " , Identifier )";
-  } else if (token.is_number()) {
-    os << "( " << token.get_number() << " , Number )";
-  } else if (token.is_string()) {
-    os << "( " << token.get_string() << " , String )";
-  }
-  return os;
-}
-
 std::ostream &operator<<(std::ostream &os, TokenStream &token_stream) {
-  std::for_each(token_stream.begin(), token_stream.end(), [&os](auto token) {
-    os << token << "\n";
-  });
+  for (std::size_t i = 0; i < token_stream.size(); ++i) {
+    auto token = token_stream[i];
+    if (token.is_keyword()) {
+      os << "( " << token_stream.text(token) << " , " << to_string(token.type()) << " )";
+    } else if (token.is_punctuation()) {
+      os << "( " << token_stream.text(token) << " , " << to_string(token.type()) << " )";
+    } else if (token.is_identifier()) {
+      os << "( " << token_stream.text(token) << " , Identifier )";
+    } else if (token.is_number()) {
+      os << "( " << token.get_number() << " , Number )";
+    } else if (token.is_string()) {
+      os << "( " << token_stream.text(token) << " , String )";
+    }
+    os << "\n";
+  }
   return os;
 }
 
@@ -93,52 +90,39 @@ std::ostream &operator<<(std::ostream &os, Variable &variable) {
   return os;
 }
 
-std::string to_string(const Equality::Op &op) {
+std::string to_string(const BinaryExpr::Op &op) {
   switch (op) {
-    case Equality::Op::Equal: return "==";
-    case Equality::Op::Nequal: return "!=";
+    case BinaryExpr::Op::Times: return "*";
+    case BinaryExpr::Op::Divide: return "/";
+    case BinaryExpr::Op::Mod: return "%";
+    case BinaryExpr::Op::Add: return "+";
+    case BinaryExpr::Op::Sub: return "-";
+    case BinaryExpr::Op::Less: return "<";
+    case BinaryExpr::Op::Greater: return ">";
+    case BinaryExpr::Op::Le: return "<=";
+    case BinaryExpr::Op::Ge: return ">=";
+    case BinaryExpr::Op::Equal: return "==";
+    case BinaryExpr::Op::Nequal: return "!=";
+    case BinaryExpr::Op::Land: return "&&";
+    case BinaryExpr::Op::Lor: return "||";
   }
   return "";
 }
-std::string to_string(const Relational::Op &op) {
+std::string to_string(const UnaryExpr::Op &op) {
   switch (op) {
-    case Relational::Op::Less: return "<";
-    case Relational::Op::Greater: return ">";
-    case Relational::Op::Le: return "<=";
-    case Relational::Op::Ge: return ">=";
-  }
-  return "";
-}
-std::string to_string(const Additive::Op &op) {
-  switch (op) {
-    case Additive::Op::Add: return "+";
-    case Additive::Op::Sub: return "-";
-  }
-  return "";
-}
-std::string to_string(const Multiplicative::Op &op) {
-  switch (op) {
-    case Multiplicative::Op::Times: return "*";
-    case Multiplicative::Op::Divide: return "/";
-    case Multiplicative::Op::Mod: return "%";
-  }
-  return "";
-}
-std::string to_string(const Unary::Op &op) {
-  switch (op) {
-    case Unary::Op::Sub: return "-";
-    case Unary::Op::Not: return "~";
-    case Unary::Op::Lnot: return "!";
+    case UnaryExpr::Op::Sub: return "-";
+    case UnaryExpr::Op::Not: return "~";
+    case UnaryExpr::Op::Lnot: return "!";
   }
   return "";
 }
 
-class ASTPrinter : public DetailedASTVisitor {
+class ASTPrinter : public ASTVisitor<ASTPrinter> {
  public:
   explicit ASTPrinter(std::ostream &ostream = std::cout)
       : os(ostream) {}
 
-  void visit(ProgramPtr &program) override {
+  void visit(ProgramPtr &program) {
     os << "program\n";
     auto total_num = program->func_decl_vec().size();
     int cur_num = 0;
@@ -148,19 +132,13 @@ class ASTPrinter : public DetailedASTVisitor {
       ++cur_num;
       is_end_ = (cur_num == total_num);
       prefix_ = stored_prefix;
-      if (std::holds_alternative<FunctionPtr>(item)) {
-        visit(std::get<FunctionPtr>(item));
-      } else if (std::holds_alternative<DeclarationPtr>(item)) {
-        visit(std::get<DeclarationPtr>(item));
-      } else {
-        assert(false);
-      }
+      visit_variant(item);
     }
   }
-  void visit(FunctionPtr &function) override {
+  void visit(FunctionPtr &function) {
     auto stored_prefix = append_prefix(prefix_);
     print_front();
-    os << "function(" << function->name() << ")\n";
+    os << "function(" << function->name() << (function->has_lazy_body() ? ", body skipped" : "") << ")\n";
     is_end_ = false;
     prefix_ = stored_prefix;
     visit(function->ret_type());
@@ -177,11 +155,11 @@ class ASTPrinter : public DetailedASTVisitor {
       visit(function->parameter_list());
     }
   }
-  void visit(BaseType &type) override {
+  void visit(BaseType &type) {
     print_front();
     os << "type: " << to_string(type.type()) << "\n";
   }
-  void visit(ParameterListPtr &parameter_list) override {
+  void visit(ParameterListPtr &parameter_list) {
     auto stored_prefix = append_prefix(prefix_);
     print_front();
     os << "parameterList\n";
@@ -199,7 +177,7 @@ class ASTPrinter : public DetailedASTVisitor {
     print_front();
     os << "variable(" << *variable << ")\n";
   }
-  void visit(CompoundStatementPtr &compound_statement) override {
+  void visit(CompoundStatementPtr &compound_statement) {
     auto stored_prefix = append_prefix(prefix_);
     print_front();
     os << "compoundStatement\n";
@@ -212,51 +190,23 @@ class ASTPrinter : public DetailedASTVisitor {
       visit(block_item);
     }
   }
-  void visit(BlockItemPtr &block_item) override {
+  void visit(BlockItemPtr &block_item) {
     auto stored_prefix = append_prefix(prefix_);
     print_front();
     os << "blockItem\n";
     is_end_ = true;
     prefix_ = stored_prefix;
-    if (std::holds_alternative<StatementPtr>(block_item->value())) {
-      visit(std::get<StatementPtr>(block_item->value()));
-    } else if (std::holds_alternative<DeclarationPtr>(block_item->value())) {
-      visit(std::get<DeclarationPtr>(block_item->value()));
-    } else {
-      assert(false);
-    }
+    visit_variant(block_item->value());
   }
-  void visit(StatementPtr &statement) override {
+  void visit(StatementPtr &statement) {
     auto stored_prefix = append_prefix(prefix_);
     print_front();
     os << "statement\n";
     is_end_ = true;
     prefix_ = stored_prefix;
-    if (std::holds_alternative<ReturnStatementPtr>(statement->value())) {
-      visit(std::get<ReturnStatementPtr>(statement->value()));
-    } else if (std::holds_alternative<ExpStatementPtr>(statement->value())) {
-      visit(std::get<ExpStatementPtr>(statement->value()));
-    } else if (std::holds_alternative<IfStatementPtr>(statement->value())) {
-      visit(std::get<IfStatementPtr>(statement->value()));
-    } else if (std::holds_alternative<CompoundStatementPtr>(statement->value())) {
-      visit(std::get<CompoundStatementPtr>(statement->value()));
-    } else if (std::holds_alternative<ForExpStatementPtr>(statement->value())) {
-      visit(std::get<ForExpStatementPtr>(statement->value()));
-    } else if (std::holds_alternative<ForDecStatementPtr>(statement->value())) {
-      visit(std::get<ForDecStatementPtr>(statement->value()));
-    } else if (std::holds_alternative<WhileStatementPtr>(statement->value())) {
-      visit(std::get<WhileStatementPtr>(statement->value()));
-    } else if (std::holds_alternative<DoStatementPtr>(statement->value())) {
-      visit(std::get<DoStatementPtr>(statement->value()));
-    } else if (std::holds_alternative<BreakStatementPtr>(statement->value())) {
-      visit(std::get<BreakStatementPtr>(statement->value()));
-    } else if (std::holds_alternative<ContinueStatementPtr>(statement->value())) {
-      visit(std::get<ContinueStatementPtr>(statement->value()));
-    } else {
-      assert(false);
-    }
+    visit_variant(statement->value());
   }
-  void visit(DeclarationPtr &declaration) override {
+  void visit(DeclarationPtr &declaration) {
     auto stored_prefix = append_prefix(prefix_);
     print_front();
     os << "declaration\n";
@@ -273,7 +223,7 @@ class ASTPrinter : public DetailedASTVisitor {
       visit(declaration->var());
     }
   }
-  void visit(ExpressionListPtr &expression_list) override {
+  void visit(ExpressionListPtr &expression_list) {
     auto stored_prefix = append_prefix(prefix_);
     print_front();
     os << "expressionList\n";
@@ -286,188 +236,7 @@ class ASTPrinter : public DetailedASTVisitor {
       visit(exp);
     }
   }
-  void visit(ExpressionPtr &expression) override {
-    auto stored_prefix = append_prefix(prefix_);
-    print_front();
-    os << "expression\n";
-    is_end_ = true;
-    prefix_ = stored_prefix;
-    visit(expression->assignment());
-  }
-  void visit(AssignmentPtr &assignment) override {
-    auto stored_prefix = append_prefix(prefix_);
-    print_front();
-    os << "assignment\n";
-    is_end_ = true;
-    prefix_ = stored_prefix;
-    if (std::holds_alternative<ConditionalPtr>(assignment->value())) {
-      visit(std::get<ConditionalPtr>(assignment->value()));
-    } else if (std::holds_alternative<AssignExpPtr>(assignment->value())) {
-      visit(std::get<AssignExpPtr>(assignment->value()));
-    } else {
-      assert(false);
-    }
-  }
-  void visit(ConditionalPtr &conditional) override {
-    auto stored_prefix = append_prefix(prefix_);
-    print_front();
-    os << "conditional\n";
-    if (conditional->cond_true()) { // cond '?' cond_true ':' cond_false
-      is_end_ = false;
-      prefix_ = stored_prefix;
-      visit(conditional->cond());
-      is_end_ = false;
-      prefix_ = stored_prefix;
-      visit(conditional->cond_true());
-      is_end_ = true;
-      prefix_ = stored_prefix;
-      visit(conditional->cond_false());
-    } else {  // logical_or
-      is_end_ = true;
-      prefix_ = stored_prefix;
-      visit(conditional->cond());
-    }
-  }
-  void visit(LogicalOrPtr &logical_or) override {
-    auto stored_prefix = append_prefix(prefix_);
-    print_front();
-    os << "logicalOr\n";
-    if (logical_or->left()) { // or || and
-      is_end_ = false;
-      prefix_ = stored_prefix;
-      visit(logical_or->left());
-    } // else :  logical_and
-    is_end_ = true;
-    prefix_ = stored_prefix;
-    visit(logical_or->right());
-  }
-  void visit(LogicalAndPtr &logical_and) override {
-    auto stored_prefix = append_prefix(prefix_);
-    print_front();
-    os << "logicalAnd\n";
-    if (logical_and->left()) { // and && equality
-      is_end_ = false;
-      prefix_ = stored_prefix;
-      visit(logical_and->left());
-    } // else : equality
-    is_end_ = true;
-    prefix_ = stored_prefix;
-    visit(logical_and->right());
-  }
-  void visit(EqualityPtr &equality) override {
-    auto stored_prefix = append_prefix(prefix_);
-    print_front();
-    os << "equality\n";
-    if (equality->left()) {
-      is_end_ = false;
-      prefix_ = stored_prefix;
-      visit(equality->left());
-      is_end_ = false;
-      prefix_ = stored_prefix;
-      visit < Equality > (equality->op());
-    }
-    is_end_ = true;
-    prefix_ = stored_prefix;
-    visit(equality->right());
-  }
-  void visit(RelationalPtr &relational) override {
-    auto stored_prefix = append_prefix(prefix_);
-    print_front();
-    os << "relational\n";
-    if (relational->left()) {
-      is_end_ = false;
-      prefix_ = stored_prefix;
-      visit(relational->left());
-      is_end_ = false;
-      prefix_ = stored_prefix;
-      visit < Relational > (relational->op());
-    }
-    is_end_ = true;
-    prefix_ = stored_prefix;
-    visit(relational->right());
-  }
-  void visit(AdditivePtr &additive) override {
-    auto stored_prefix = append_prefix(prefix_);
-    print_front();
-    os << "additive\n";
-    if (additive->left()) {
-      is_end_ = false;
-      prefix_ = stored_prefix;
-      visit(additive->left());
-      is_end_ = false;
-      prefix_ = stored_prefix;
-      visit < Additive > (additive->op());
-    }
-    is_end_ = true;
-    prefix_ = stored_prefix;
-    visit(additive->right());
-  }
-  void visit(MultiplicativePtr &multiplicative) override {
-    auto stored_prefix = append_prefix(prefix_);
-    print_front();
-    os << "multiplicative\n";
-    if (multiplicative->left()) {
-      is_end_ = false;
-      prefix_ = stored_prefix;
-      visit(multiplicative->left());
-      is_end_ = false;
-      prefix_ = stored_prefix;
-      visit < Multiplicative > (multiplicative->op());
-    }
-    is_end_ = true;
-    prefix_ = stored_prefix;
-    visit(multiplicative->right());
-  }
-  void visit(UnaryPtr &unary) override {
-    auto stored_prefix = append_prefix(prefix_);
-    print_front();
-    os << "unary\n";
-    if (std::holds_alternative<PostfixPtr>(unary->value())) {
-      is_end_ = true;
-      prefix_ = stored_prefix;
-      visit(std::get<PostfixPtr>(unary->value()));
-    } else if (std::holds_alternative<UnaryPtr>(unary->value())) {
-      is_end_ = false;
-      prefix_ = stored_prefix;
-      visit < Unary > (unary->op());
-      is_end_ = true;
-      prefix_ = stored_prefix;
-      visit(std::get<UnaryPtr>(unary->value()));
-    }
-  }
-  void visit(PostfixPtr &postfix) override {
-    auto stored_prefix = append_prefix(prefix_);
-    print_front();
-    os << "postfix\n";
-    is_end_ = true;
-    prefix_ = stored_prefix;
-    if (std::holds_alternative<PrimaryPtr>(postfix->value())) {
-      visit(std::get<PrimaryPtr>(postfix->value()));
-    } else if (std::holds_alternative<FuncCallPtr>(postfix->value())) {
-      visit(std::get<FuncCallPtr>(postfix->value()));
-    } else if (std::holds_alternative<ArrayPtr>(postfix->value())) {
-      visit(std::get<ArrayPtr>(postfix->value()));
-    } else {
-      assert(false);
-    }
-  }
-  void visit(PrimaryPtr &primary) override {
-    auto stored_prefix = append_prefix(prefix_);
-    print_front();
-    if (std::holds_alternative<ExpressionPtr>(primary->value())) {
-      os << "primary\n";
-      is_end_ = true;
-      prefix_ = stored_prefix;
-      visit(std::get<ExpressionPtr>(primary->value()));
-    } else if (std::holds_alternative<int>(primary->value())) {
-      os << "primary(Interger: " << std::get<int>(primary->value()) << ")\n";
-    } else if (std::holds_alternative<std::string>(primary->value())) {
-      os << "primary(Identifier: " << std::get<std::string>(primary->value()) << ")\n";
-    } else {
-      assert(false);
-    }
-  }
-  void visit(ReturnStatementPtr &return_statement) override {
+  void visit(ReturnStatementPtr &return_statement) {
     auto stored_prefix = append_prefix(prefix_);
     print_front();
     os << "returnStatement\n";
@@ -475,7 +244,7 @@ class ASTPrinter : public DetailedASTVisitor {
     prefix_ = stored_prefix;
     visit(return_statement->exp());
   }
-  void visit(ExpStatementPtr &exp_statement) override {
+  void visit(ExpStatementPtr &exp_statement) {
     auto stored_prefix = append_prefix(prefix_);
     print_front();
     os << "expStatement\n";
@@ -485,7 +254,7 @@ class ASTPrinter : public DetailedASTVisitor {
       visit(exp_statement->exp());
     }
   }
-  void visit(IfStatementPtr &if_statement) override {
+  void visit(IfStatementPtr &if_statement) {
     auto stored_prefix = append_prefix(prefix_);
     print_front();
     os << "ifStatement\n";
@@ -505,7 +274,7 @@ class ASTPrinter : public DetailedASTVisitor {
       visit(if_statement->if_stmt());
     }
   }
-  void visit(ForExpStatementPtr &for_exp_statement) override {
+  void visit(ForExpStatementPtr &for_exp_statement) {
     auto stored_prefix = append_prefix(prefix_);
     print_front();
     os << "forExpStatement\n";
@@ -528,7 +297,7 @@ class ASTPrinter : public DetailedASTVisitor {
     prefix_ = stored_prefix;
     visit(for_exp_statement->statement());
   }
-  void visit(ForDecStatementPtr &for_dec_statement) override {
+  void visit(ForDecStatementPtr &for_dec_statement) {
     auto stored_prefix = append_prefix(prefix_);
     print_front();
     os << "forDecStatement\n";
@@ -551,7 +320,7 @@ class ASTPrinter : public DetailedASTVisitor {
     prefix_ = stored_prefix;
     visit(for_dec_statement->statement());
   }
-  void visit(WhileStatementPtr &while_statement) override {
+  void visit(WhileStatementPtr &while_statement) {
     auto stored_prefix = append_prefix(prefix_);
     print_front();
     os << "whileStatement\n";
@@ -562,7 +331,7 @@ class ASTPrinter : public DetailedASTVisitor {
     prefix_ = stored_prefix;
     visit(while_statement->statement());
   }
-  void visit(DoStatementPtr &do_statement) override {
+  void visit(DoStatementPtr &do_statement) {
     auto stored_prefix = append_prefix(prefix_);
     print_front();
     os << "doStatement\n";
@@ -573,57 +342,103 @@ class ASTPrinter : public DetailedASTVisitor {
     prefix_ = stored_prefix;
     visit(do_statement->cond_exp());
   }
-  void visit(BreakStatementPtr &break_statement) override {
+  void visit(BreakStatementPtr &break_statement) {
     auto stored_prefix = append_prefix(prefix_);
     print_front();
     os << "breakStatement\n";
   }
-  void visit(ContinueStatementPtr &continue_statement) override {
+  void visit(ContinueStatementPtr &continue_statement) {
     auto stored_prefix = append_prefix(prefix_);
     print_front();
     os << "continueStatement\n";
   }
-  void visit(AssignExpPtr &assign_exp) override {
+  void visit(ExpressionPtr &expression) {
+    visit_expression(expression);
+  }
+  void visit(LiteralPtr &literal) {
     auto stored_prefix = append_prefix(prefix_);
     print_front();
-    os << "assignExp\n";
-    is_end_ = false;
-    prefix_ = stored_prefix;
-    visit(assign_exp->left());
-    is_end_ = true;
-    prefix_ = stored_prefix;
-    visit(assign_exp->right());
+    os << "literal(" << literal->value() << ")\n";
   }
-  void visit(FuncCallPtr &func_call) override {
+  void visit(RefPtr &ref) {
     auto stored_prefix = append_prefix(prefix_);
     print_front();
-    os << "funcCall(func_name: " << func_call->func_name() << ")\n";
+    os << "ref(" << ref->name() << ")\n";
+  }
+  void visit(CallPtr &call) {
+    auto stored_prefix = append_prefix(prefix_);
+    print_front();
+    os << "call(func_name: " << call->func_name() << ")\n";
     is_end_ = true;
     prefix_ = stored_prefix;
-    visit(func_call->expression_list());
+    visit(call->expression_list());
   }
-  void visit(ArrayPtr &array) override {
+  void visit(IndexPtr &index) {
     auto stored_prefix = append_prefix(prefix_);
     print_front();
-    os << "array\n";
-    auto total_num = 1 + array->expression_vec().size();
+    os << "index\n";
+    auto total_num = 1 + index->index_vec().size();
     int cur_num = 1;
     is_end_ = (cur_num == total_num);
     prefix_ = stored_prefix;
-    if (std::holds_alternative<PrimaryPtr>(array->name())) {
-      visit(std::get<PrimaryPtr>(array->name()));
-    } else if (std::holds_alternative<FuncCallPtr>(array->name())) {
-      visit(std::get<FuncCallPtr>(array->name()));
-    } else {
-      assert(false);
-    }
-    for (auto &exp : array->expression_vec()) {
+    visit(index->base());
+    for (auto &exp : index->index_vec()) {
       ++cur_num;
       is_end_ = (cur_num == total_num);
       prefix_ = stored_prefix;
       visit(exp);
     }
   }
+  void visit(UnaryExprPtr &unary_expr) {
+    auto stored_prefix = append_prefix(prefix_);
+    print_front();
+    os << "unaryExpr\n";
+    is_end_ = false;
+    prefix_ = stored_prefix;
+    visit < UnaryExpr > (unary_expr->op());
+    is_end_ = true;
+    prefix_ = stored_prefix;
+    visit(unary_expr->operand());
+  }
+  void visit(BinaryExprPtr &binary_expr) {
+    auto stored_prefix = append_prefix(prefix_);
+    print_front();
+    os << "binaryExpr\n";
+    is_end_ = false;
+    prefix_ = stored_prefix;
+    visit(binary_expr->left());
+    is_end_ = false;
+    prefix_ = stored_prefix;
+    visit < BinaryExpr > (binary_expr->op());
+    is_end_ = true;
+    prefix_ = stored_prefix;
+    visit(binary_expr->right());
+  }
+  void visit(ConditionalExprPtr &conditional_expr) {
+    auto stored_prefix = append_prefix(prefix_);
+    print_front();
+    os << "conditionalExpr\n";
+    is_end_ = false;
+    prefix_ = stored_prefix;
+    visit(conditional_expr->cond());
+    is_end_ = false;
+    prefix_ = stored_prefix;
+    visit(conditional_expr->cond_true());
+    is_end_ = true;
+    prefix_ = stored_prefix;
+    visit(conditional_expr->cond_false());
+  }
+  void visit(AssignExprPtr &assign_expr) {
+    auto stored_prefix = append_prefix(prefix_);
+    print_front();
+    os << "assignExpr\n";
+    is_end_ = false;
+    prefix_ = stored_prefix;
+    visit(assign_expr->left());
+    is_end_ = true;
+    prefix_ = stored_prefix;
+    visit(assign_expr->right());
+  }
   template<typename T>
   void visit(typename T::Op &op) {
     auto stored_prefix = append_prefix(prefix_);
@@ -695,6 +510,13 @@ std::string to_string(IROp op) {
     case IROp::LOR: return "LOR";
     case IROp::JMP: return "JMP";
     case IROp::BEQZ: return "BEQZ";
+    case IROp::BNEZ: return "BNEZ";
+    case IROp::BEQ: return "BEQ";
+    case IROp::BNE: return "BNE";
+    case IROp::BLT: return "BLT";
+    case IROp::BGE: return "BGE";
+    case IROp::BGT: return "BGT";
+    case IROp::BLE: return "BLE";
     case IROp::PARAM: return "PARAM";
     case IROp::CALL: return "CALL";
     case IROp::LA: return "LA";
@@ -703,6 +525,7 @@ std::string to_string(IROp op) {
     case IROp::ALLOC: return "ALLOC";
     case IROp::GBSS: return "GBSS";
     case IROp::GINI: return "GINI";
+    case IROp::LOC: return "LOC";
     case IROp::LOADFP: return "LOADFP";
     case IROp::STOREFP: return "STOREFP";
     case IROp::LARRAY: return "LARRAY";
@@ -711,19 +534,19 @@ std::string to_string(IROp op) {
 }
 std::ostream &operator<<(std::ostream &os, IRCode &code) {
   os << std::setw(8) << std::left << to_string(code.op());
-  if (code.a0()) {
-    os << *(code.a0());
+  if (!code.a0().empty()) {
+    os << code.a0();
   }
-  if (code.a1()) {
-    os << "    " << *(code.a1());
+  if (!code.a1().empty()) {
+    os << "    " << code.a1();
   }
-  if (code.a2()) {
-    os << "    " << *(code.a2());
+  if (!code.a2().empty()) {
+    os << "    " << code.a2();
   }
   return os;
 }
 std::ostream &operator<<(std::ostream &os, IRBuilderPtr &ir_builder) {
-  for (auto &ir : ir_builder->ircode_list()) {
+  for (auto ir : ir_builder->ircode_list()) {
     os << *ir << "\n";
   }
   return os;
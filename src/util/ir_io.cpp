@@ -0,0 +1,378 @@
+#include "ir_io.hpp"
+
+#include "byte_stream.hpp"
+#include "compile_error.hpp"
+#include "debug.hpp"
+
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+// IR的结构改变时需要增加版本号
+constexpr uint64_t kFormatVersion = 2;
+constexpr std::string_view kIRMagic = "SCIR";
+constexpr IROp kLastOp = IROp::LARRAY;
+
+class IRWriter {
+ public:
+  std::string write(IRList &ir_list) {
+    for (auto code : ir_list) {
+      write_code(code);
+    }
+    ByteWriter header;
+    header.write_bytes(kIRMagic);
+    header.write_uint(kFormatVersion);
+    header.write_uint(name_vec_.size());
+    for (auto name : name_vec_) {
+      auto str = name.str();
+      header.write_uint(str.size());
+      header.write_bytes(str);
+    }
+    header.write_uint(ir_list.size());
+    header.write_bytes(out_.buf());
+    return std::move(header.buf());
+  }
+
+ private:
+  uint64_t name_index(Symbol name) {
+    auto [it, inserted] = name_index_.try_emplace(name, name_vec_.size());
+    if (inserted) name_vec_.push_back(name);
+    return it->second;
+  }
+  // 低2位为种类，其余为编号(函数参数为编号的绝对值)，全局变量的编号为名字的下标
+  void write_var(IRVar var) {
+    uint64_t num = var.is_global() ? name_index(var.name()) : static_cast<uint64_t>(std::abs(var.num()));
+    out_.write_uint(num << 2 | static_cast<uint64_t>(var.kind()));
+  }
+  void write_addr(IRAddr &addr) {
+    switch (addr.kind()) {
+      case IRAddr::Kind::None: break;
+      case IRAddr::Kind::Imm: out_.write_int(addr.imm()); break;
+      case IRAddr::Kind::Name: out_.write_uint(name_index(addr.name())); break;
+      case IRAddr::Kind::Var: write_var(addr.var()); break;
+    }
+  }
+  void write_code(IRCodePtr code) {
+    out_.write_uint(static_cast<uint64_t>(code->op()));
+    out_.write_uint(static_cast<uint64_t>(code->a0().kind())
+                        | static_cast<uint64_t>(code->a1().kind()) << 2
+                        | static_cast<uint64_t>(code->a2().kind()) << 4);
+    write_addr(code->a0());
+    write_addr(code->a1());
+    write_addr(code->a2());
+  }
+
+  ByteWriter out_;
+  std::unordered_map<Symbol, uint64_t> name_index_;
+  std::vector<Symbol> name_vec_;
+};
+
+// 与IRWriter的顺序一一对应
+class IRReader {
+ public:
+  explicit IRReader(std::string_view data) : in_(data) {}
+
+  IRBuilderPtr read() {
+    if (in_.read_bytes(kIRMagic.size()) != kIRMagic || in_.read_uint() != kFormatVersion) throw bad_format();
+    auto name_count = in_.read_count();
+    name_vec_.reserve(name_count);
+    for (std::size_t i = 0; i < name_count; ++i) {
+      name_vec_.push_back(Symbol::intern(in_.read_bytes(in_.read_count())));
+    }
+    auto ir_builder = std::make_shared<IRBuilder>();
+    auto count = in_.read_count();
+    for (std::size_t i = 0; i < count; ++i) {
+      auto op = static_cast<IROp>(in_.read_index(static_cast<std::size_t>(kLastOp)));
+      auto kinds = in_.read_index(0x3f);
+      auto a0 = read_addr(kinds & 3);
+      auto a1 = read_addr(kinds >> 2 & 3);
+      auto a2 = read_addr(kinds >> 4 & 3);
+      ir_builder->new_ir(op, a0, a1, a2);
+    }
+    if (!in_.eof()) throw bad_format();
+    return ir_builder;
+  }
+
+ private:
+  Symbol read_name() {
+    if (name_vec_.empty()) throw bad_format();
+    return name_vec_[in_.read_index(name_vec_.size() - 1)];
+  }
+  IRVar read_var() {
+    auto value = in_.read_uint();
+    auto kind = static_cast<IRVar::Kind>(value & 3);
+    if (kind == IRVar::Kind::Global) {
+      if (name_vec_.empty() || (value >> 2) >= name_vec_.size()) throw bad_format();
+      return IRVar::global(name_vec_[value >> 2]);
+    }
+    if ((value >> 2) > IRVar::kMaxNum) throw bad_format();
+    auto num = static_cast<int>(value >> 2);
+    switch (kind) {
+      case IRVar::Kind::Local: return IRVar::local(num);
+      case IRVar::Kind::Param: return IRVar::param(num);
+      default: return IRVar::reg(num);
+    }
+  }
+  IRAddr read_addr(std::size_t kind) {
+    switch (static_cast<IRAddr::Kind>(kind)) {
+      case IRAddr::Kind::None: return IRAddr();
+      case IRAddr::Kind::Imm: {
+        auto imm = in_.read_int();
+        if (imm < INT32_MIN || imm > INT32_MAX) throw bad_format();
+        return IRAddr(static_cast<int>(imm));
+      }
+      case IRAddr::Kind::Name: return IRAddr(read_name());
+      case IRAddr::Kind::Var: return IRAddr(read_var());
+    }
+    throw bad_format();
+  }
+
+  ByteReader in_;
+  std::vector<Symbol> name_vec_;
+};
+
+// 按行读取文本格式的IR，词法和语法都很简单，直接在text上扫描
+class IRParser {
+ public:
+  explicit IRParser(std::string_view text) : text_(text) {}
+
+  IRBuilderPtr parse() {
+    auto ir_builder = std::make_shared<IRBuilder>();
+    while (pos_ < text_.size()) {
+      auto word = next_word();
+      if (word.substr(0, 2) == "//") {  // 注释行
+        while (pos_ < text_.size() && text_[pos_] != '\n') ++pos_;
+      } else if (!word.empty()) {
+        auto op = parse_op(word);
+        offset_vec_.push_back(offset_of(word));
+        IRAddr addr[3];
+        int count = 0;
+        for (word = next_word(); !word.empty(); word = next_word()) {
+          if (count == 3) throw ir_error("too many operands", offset_of(word));
+          addr[count++] = parse_addr(word);
+        }
+        ir_builder->new_ir(op, addr[0], addr[1], addr[2]);
+      }
+      ++pos_;  // 跳过换行符
+    }
+    return ir_builder;
+  }
+  // 每条指令的操作码在text中的位置，用于检查IR时报告出错的位置
+  std::vector<SourceOffset> &offset_vec() { return offset_vec_; }
+
+ private:
+  // 返回当前行的下一个单词，到达行尾时返回空串，不跳过换行符
+  std::string_view next_word() {
+    while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\r')) ++pos_;
+    auto begin = pos_;
+    while (pos_ < text_.size() && !std::isspace(static_cast<unsigned char>(text_[pos_]))) ++pos_;
+    return text_.substr(begin, pos_ - begin);
+  }
+  [[nodiscard]] SourceOffset offset_of(std::string_view word) const {
+    return static_cast<SourceOffset>(word.data() - text_.data());
+  }
+  IROp parse_op(std::string_view word) {
+    static const auto op_map = [] {
+      std::unordered_map<std::string, IROp> map;
+      for (int op = 0; op <= static_cast<int>(kLastOp); ++op) {
+        map.emplace(to_string(static_cast<IROp>(op)), static_cast<IROp>(op));
+      }
+      return map;
+    }();
+    auto it = op_map.find(std::string(word));
+    if (it == op_map.end()) throw ir_error("unknown ir op '" + std::string(word) + "'", offset_of(word));
+    return it->second;
+  }
+  // 整数必须完整地转换并且在int的范围内
+  int parse_int(std::string_view str, std::string_view word) {
+    int value = 0;
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    if (ec != std::errc() || ptr != str.data() + str.size()) {
+      throw ir_error("bad ir operand '" + std::string(word) + "'", offset_of(word));
+    }
+    return value;
+  }
+  IRAddr parse_addr(std::string_view word) {
+    if (word[0] == '%') {
+      auto num = parse_int(word.substr(1), word);
+      if (num < -static_cast<int>(IRVar::kMaxNum) || num > static_cast<int>(IRVar::kMaxNum)) {
+        throw ir_error("bad ir operand '" + std::string(word) + "'", offset_of(word));
+      }
+      return IRAddr(num < 0 ? IRVar::param(-num) : IRVar::local(num));
+    }
+    if (word[0] == '-' || std::isdigit(static_cast<unsigned char>(word[0]))) {
+      return IRAddr(parse_int(word, word));
+    }
+    return IRAddr(Symbol::intern(word));
+  }
+
+  std::string_view text_;
+  std::size_t pos_{0};
+  std::vector<SourceOffset> offset_vec_;
+};
+
+// 检查读入的IR的结构，之后的优化和代码生成假定IR由translator生成，不再检查：
+// GBSS和GINI在函数之外，其他指令在FUNBEG和FUNEND之间并且函数不能嵌套；
+// 操作数的个数和种类符合ir.hpp中的表，只能出现寄存器分配之前的指令；
+// 读取的局部变量在函数中被赋值过，参数的编号在1和参数个数之间，跳转的标签在函数中有定义并且只定义一次
+class IRChecker {
+ public:
+  // offset_vec为每条指令在文本中的位置，二进制格式没有位置，报错时给出指令的序号
+  explicit IRChecker(std::vector<SourceOffset> offset_vec = {}) : offset_vec_(std::move(offset_vec)) {}
+
+  void check(IRList &ir_list) {
+    code_vec_.assign(ir_list.begin(), ir_list.end());
+    for (index_ = 0; index_ < code_vec_.size(); ++index_) {
+      auto code = code_vec_[index_];
+      check_operands(code);
+      if (code->op() == IROp::GBSS || code->op() == IROp::GINI) continue;
+      if (code->op() != IROp::FUNBEG) error(to_string(code->op()) + " outside of function");
+      check_function();
+    }
+  }
+
+ private:
+  // 操作数种类的集合，第k位表示IRAddr::Kind为k的操作数
+  enum : uint8_t { kNull = 1, kImm = 2, kStr = 4, kVar = 8 };
+  struct OperandKinds {
+    uint8_t a0, a1, a2;
+  };
+
+  static OperandKinds operand_kinds(IROp op) {
+    if (is_unary_op(op)) return {kVar, kVar, kNull};
+    if (is_binary_op(op)) return {kVar, kVar | kImm, kVar | kImm};
+    if (is_compare_jmp_op(op)) return {kVar, kVar | kImm, kImm};
+    switch (op) {
+      case IROp::FUNBEG: return {kStr, kImm, kNull};
+      case IROp::FUNEND: return {kNull, kNull, kNull};
+      case IROp::LABEL: case IROp::JMP: return {kImm, kNull, kNull};
+      case IROp::RET: return {kVar | kImm, kNull, kNull};
+      case IROp::MOV: return {kVar, kVar | kImm, kNull};
+      case IROp::BEQZ: case IROp::BNEZ: return {kVar | kImm, kImm, kNull};
+      case IROp::PARAM: return {kVar, kNull, kNull};
+      case IROp::CALL: case IROp::LA: return {kVar, kStr, kNull};
+      case IROp::LOAD: return {kVar, kVar, kVar | kImm};
+      case IROp::STORE: return {kVar | kImm, kVar, kVar | kImm};
+      case IROp::ALLOC: return {kVar, kImm, kNull};
+      case IROp::GBSS: case IROp::GINI: return {kStr, kImm, kNull};
+      case IROp::LOC: return {kImm, kImm, kNull};
+      default: return {0, 0, 0};  // 寄存器分配之后的指令
+    }
+  }
+  static std::string kinds_to_string(uint8_t kinds) {
+    std::string str;
+    for (auto [kind, name] : {std::pair{kVar, "var"}, {kImm, "imm"}, {kStr, "str"}, {kNull, "null"}}) {
+      if (kinds & kind) str += (str.empty() ? "" : "|") + std::string(name);
+    }
+    return str;
+  }
+  // 结果保存在a0中的指令
+  static bool defines_a0(IROp op) {
+    return op == IROp::MOV || is_unary_op(op) || is_binary_op(op) || op == IROp::CALL || op == IROp::LA
+        || op == IROp::LOAD || op == IROp::ALLOC;
+  }
+
+  void check_operands(IRCodePtr code) {
+    auto kinds = operand_kinds(code->op());
+    if (kinds.a0 == 0) error(to_string(code->op()) + " is only used after register allocation");
+    IRAddr *addr[3] = {&code->a0(), &code->a1(), &code->a2()};
+    uint8_t expected[3] = {kinds.a0, kinds.a1, kinds.a2};
+    for (int i = 0; i < 3; ++i) {
+      if (!(expected[i] >> static_cast<int>(addr[i]->kind()) & 1)) {
+        error("a" + std::to_string(i) + " of " + to_string(code->op()) + " must be " + kinds_to_string(expected[i]));
+      }
+      if (addr[i]->is_var() && addr[i]->var().kind() != IRVar::Kind::Local
+          && addr[i]->var().kind() != IRVar::Kind::Param) {
+        error("a" + std::to_string(i) + " of " + to_string(code->op()) + " is not a local variable or parameter");
+      }
+    }
+  }
+
+  // index_指向FUNBEG，检查整个函数，结束时index_指向对应的FUNEND
+  void check_function() {
+    auto begin = index_;
+    auto funbeg = code_vec_[begin];
+    auto param_count = funbeg->a1().imm();
+    if (param_count < 0) error("negative parameter count");
+    auto end = begin + 1;
+    for (; end < code_vec_.size() && code_vec_[end]->op() != IROp::FUNEND; ++end) {
+      if (code_vec_[end]->op() == IROp::FUNBEG) {
+        index_ = end;
+        error("FUNBEG inside function " + std::string(funbeg->a0().name().str()));
+      }
+    }
+    if (end == code_vec_.size()) error("function " + std::string(funbeg->a0().name().str()) + " has no FUNEND");
+
+    // 先找出函数中所有被赋值的变量和定义的标签，变量可以在跳转之后先读后写
+    std::unordered_set<uint32_t> defined_var_set, label_set;
+    for (index_ = begin + 1; index_ < end; ++index_) {
+      auto code = code_vec_[index_];
+      check_operands(code);
+      if (code->op() == IROp::GBSS || code->op() == IROp::GINI) error(to_string(code->op()) + " inside function");
+      if (defines_a0(code->op())) defined_var_set.insert(code->a0().var().id());
+      if (code->op() == IROp::LABEL && !label_set.insert(code->a0().imm()).second) {
+        error("label " + std::to_string(code->a0().imm()) + " is defined more than once");
+      }
+    }
+    for (index_ = begin + 1; index_ < end; ++index_) {
+      auto code = code_vec_[index_];
+      for (auto addr : {&code->a0(), &code->a1(), &code->a2()}) {
+        if (!addr->is_var()) continue;
+        auto var = addr->var();
+        if (var.is_param() ? -var.num() < 1 || -var.num() > param_count : !defined_var_set.count(var.id())) {
+          error("%" + std::to_string(var.num()) + (var.is_param() ? " is not a parameter" : " is never assigned"));
+        }
+      }
+      if (is_jmp_op(code->op()) && !label_set.count(jmp_target(code))) {
+        error("label " + std::to_string(jmp_target(code)) + " is not defined");
+      }
+    }
+    index_ = end;
+    check_operands(code_vec_[end]);
+  }
+
+  [[noreturn]] void error(const std::string &msg) const {
+    if (offset_vec_.empty()) throw ir_error("instruction " + std::to_string(index_) + ": " + msg);
+    throw ir_error(msg, offset_vec_[index_]);
+  }
+
+  std::vector<SourceOffset> offset_vec_;
+  std::vector<IRCodePtr> code_vec_;
+  std::size_t index_{0};
+};
+
+}  // namespace
+
+std::string serialize_ir(IRBuilderPtr &ir_builder) {
+  return IRWriter().write(ir_builder->ircode_list());
+}
+
+IRBuilderPtr deserialize_ir(std::string_view data) {
+  try {
+    return IRReader(data).read();
+  } catch (const bad_format &) {
+    return nullptr;
+  }
+}
+
+IRBuilderPtr parse_ir(std::string_view text) {
+  return IRParser(text).parse();
+}
+
+IRBuilderPtr read_ir(std::string_view data) {
+  if (data.substr(0, kIRMagic.size()) != kIRMagic) {
+    IRParser parser(data);
+    auto ir_builder = parser.parse();
+    IRChecker(std::move(parser.offset_vec())).check(ir_builder->ircode_list());
+    return ir_builder;
+  }
+  auto ir_builder = deserialize_ir(data);
+  if (!ir_builder) throw ir_error("bad binary ir");
+  IRChecker().check(ir_builder->ircode_list());
+  return ir_builder;
+}
@@ -0,0 +1,24 @@
+#ifndef SCOMPILER_SRC_UTIL_IR_IO_HPP_
+#define SCOMPILER_SRC_UTIL_IR_IO_HPP_
+
+#include "ir.hpp"
+
+#include <string>
+#include <string_view>
+
+// IR的紧凑二进制格式：kIRMagic, 版本号, 名字表, 指令条数, 之后是各条指令
+// 每条指令为操作码、三个操作数的种类(合并在一个字节中)以及各个操作数的值，整数使用LEB128变长编码
+std::string serialize_ir(IRBuilderPtr &ir_builder);
+// 名字驻留为Symbol，data不完整或格式不对时返回nullptr
+IRBuilderPtr deserialize_ir(std::string_view data);
+
+// 读取--ir-file输出的文本格式(寄存器分配之前的IR)：每行一条指令，操作数之间用空白分隔
+// %n为变量(负数为函数参数)，整数为立即数，其余为名字，空行和以//开头的行被忽略
+// 格式不对时抛出ir_error，offset为出错的位置
+IRBuilderPtr parse_ir(std::string_view text);
+
+// 以kIRMagic开头时按二进制格式读取，否则按文本格式读取
+// 读取之后检查IR的结构(函数的嵌套、每种指令的操作数、变量和标签是否有定义)，不合法时抛出ir_error
+IRBuilderPtr read_ir(std::string_view data);
+
+#endif //SCOMPILER_SRC_UTIL_IR_IO_HPP_
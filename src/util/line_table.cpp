@@ -0,0 +1,24 @@
+#include "line_table.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+void LineTable::build() {
+  line_start_vec_.push_back(0);
+  const char *first = source_.data();
+  const char *last = first + source_.size();
+  for (const char *p = first; (p = static_cast<const char *>(std::memchr(p, '\n', last - p))); ++p) {
+    line_start_vec_.push_back(static_cast<SourceOffset>(p - first + 1));
+  }
+}
+
+SourceLocation LineTable::locate(SourceOffset offset) {
+  if (line_start_vec_.empty()) {
+    build();
+  }
+  // 找到最后一个不大于offset的行首
+  auto it = std::upper_bound(line_start_vec_.begin(), line_start_vec_.end(), offset) - 1;
+  int line = static_cast<int>(it - line_start_vec_.begin()) + 1;
+  int column = static_cast<int>(offset - *it) + 1;
+  return {line, column};
+}
@@ -0,0 +1,24 @@
+#ifndef SCOMPILER_SRC_UTIL_LINE_TABLE_HPP_
+#define SCOMPILER_SRC_UTIL_LINE_TABLE_HPP_
+
+#include "source_location.hpp"
+
+#include <string_view>
+#include <vector>
+
+// 将源文件中的偏移转换为行号和列号
+// 每一行的起始偏移在第一次调用locate时才计算，不需要报错或生成调试信息时没有额外开销
+class LineTable {
+ public:
+  explicit LineTable(std::string_view source) : source_(source) {}
+  ~LineTable() = default;
+
+  SourceLocation locate(SourceOffset offset);
+ private:
+  void build();
+
+  std::string_view source_;  // 不拥有源文件的内容
+  std::vector<SourceOffset> line_start_vec_;
+};
+
+#endif //SCOMPILER_SRC_UTIL_LINE_TABLE_HPP_
@@ -0,0 +1,65 @@
+#include "source_buffer.hpp"
+
+#include "compile_error.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SCOMPILER_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+SourceBuffer::SourceBuffer(const fs::path &file) {
+  if (file == "-") {  // 从标准输入读取
+    read_stream(std::cin);
+    return;
+  }
+  if (map_file(file)) return;
+  std::ifstream ifs(file, std::ios::binary);
+  if (!ifs) {
+    throw lex_error("cannot open file: " + file.string());
+  }
+  read_stream(ifs);
+}
+
+SourceBuffer::~SourceBuffer() {
+#ifdef SCOMPILER_HAS_MMAP
+  if (mapped_) {
+    munmap(const_cast<char *>(data_), size_);
+  }
+#endif
+}
+
+bool SourceBuffer::map_file(const fs::path &file) {
+#ifdef SCOMPILER_HAS_MMAP
+  int fd = open(file.c_str(), O_RDONLY);
+  if (fd == -1) return false;
+  struct stat st{};
+  // 只映射非空的普通文件，管道、设备文件等交给read_stream处理
+  if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+    close(fd);
+    return false;
+  }
+  void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);  // 映射建立后即可关闭文件描述符
+  if (addr == MAP_FAILED) return false;
+  madvise(addr, st.st_size, MADV_SEQUENTIAL);
+  data_ = static_cast<const char *>(addr);
+  size_ = st.st_size;
+  mapped_ = true;
+  return true;
+#else
+  return false;
+#endif
+}
+
+void SourceBuffer::read_stream(std::istream &is) {
+  storage_.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+  data_ = storage_.data();
+  size_ = storage_.size();
+}
@@ -0,0 +1,34 @@
+#ifndef SCOMPILER_SRC_UTIL_SOURCE_BUFFER_HPP_
+#define SCOMPILER_SRC_UTIL_SOURCE_BUFFER_HPP_
+
+#include <cstddef>
+#include <filesystem>
+#include <istream>
+#include <string>
+#include <string_view>
+
+namespace fs = std::filesystem;
+
+// 源文件的只读视图
+// 普通文件直接通过mmap映射到内存中，lexer无需再拷贝文件内容
+// 标准输入("-")、管道等无法映射的输入则读入内部的string中
+class SourceBuffer {
+ public:
+  explicit SourceBuffer(const fs::path &file);
+  ~SourceBuffer();
+  SourceBuffer(const SourceBuffer &) = delete;
+  SourceBuffer &operator=(const SourceBuffer &) = delete;
+
+  [[nodiscard]] std::string_view view() const { return {data_, size_}; }
+  [[nodiscard]] bool mapped() const { return mapped_; }
+ private:
+  bool map_file(const fs::path &file);
+  void read_stream(std::istream &is);
+
+  const char *data_{nullptr};
+  std::size_t size_{0};
+  bool mapped_{false};
+  std::string storage_;  // 无法mmap时的后备存储
+};
+
+#endif //SCOMPILER_SRC_UTIL_SOURCE_BUFFER_HPP_
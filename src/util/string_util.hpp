@@ -1,7 +1,10 @@
 #ifndef SCOMPILER_SRC_UTIL_STRING_UTIL_HPP_
 #define SCOMPILER_SRC_UTIL_STRING_UTIL_HPP_
 
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <sstream>
 
 template<typename... Args>
@@ -11,4 +14,22 @@ std::string build_string(const Args &...args) {
   return ss.str();
 }
 
+// 64位哈希，结果与标准库的实现无关，可以保存在文件中
+// 与FNV-1a相同的乘法和异或，但每次处理8个字节，用于对整个文件求哈希
+inline uint64_t hash_bytes(std::string_view str) {
+  constexpr uint64_t kPrime = 1099511628211ull;
+  uint64_t hash = 14695981039346656037ull ^ str.size();
+  std::size_t i = 0;
+  for (; i + 8 <= str.size(); i += 8) {
+    uint64_t word;
+    std::memcpy(&word, str.data() + i, sizeof(word));  // 只在同一种字节序的机器上保证结果相同
+    hash = (hash ^ word) * kPrime;
+    hash ^= hash >> 29;
+  }
+  for (; i < str.size(); ++i) {
+    hash = (hash ^ static_cast<unsigned char>(str[i])) * kPrime;
+  }
+  return hash;
+}
+
 #endif //SCOMPILER_SRC_UTIL_STRING_UTIL_HPP_
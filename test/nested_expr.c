@@ -0,0 +1,7 @@
+int f(int x) {
+  return x;
+}
+int main() {
+  int a = 1;
+  return f((f((f((f((f((f((f((f((f((f((f((f((a))))))))))))))))))))))));
+}
@@ -0,0 +1,39 @@
+// 条件为真时跳转：do-while的条件中的每种比较分别与变量、0(x0)、其他立即数比较，以及立即数在左边(交换操作数，得到BGT/BLE)
+// expect: 325797
+int main() {
+  int i;
+  int c;
+  int z = 0;
+  int r = 0;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && i < z); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && i < 0); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && i < 1); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && 0 < i); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && 1 < i); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && i > z); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && i > 0); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && i > 1); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && 0 > i); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && 1 > i); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && i <= z); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && i <= 0); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && i <= 1); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && 0 <= i); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && 1 <= i); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && i >= z); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && i >= 0); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && i >= 1); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && 0 >= i); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && 1 >= i); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && i == z); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && i == 0); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && i == 1); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && 0 == i); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && 1 == i); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && i != z); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && i != 0); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && i != 1); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && 0 != i); r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; do { c = c + 1; i = i + 1; } while (c < 6 && 1 != i); r = (r * 7 + c) % 1000003;
+  return r;
+}
@@ -0,0 +1,39 @@
+// 条件为假时跳转：if中的每种比较分别与变量、0(x0)、其他立即数比较，以及立即数在左边(交换操作数，得到BGT/BLE)
+// expect: 247060
+int main() {
+  int i;
+  int c;
+  int z = 0;
+  int r = 0;
+  c = 0; i = -2; while (i <= 2) { if (i < z) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (i < 0) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (i < 1) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (0 < i) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (1 < i) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (i > z) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (i > 0) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (i > 1) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (0 > i) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (1 > i) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (i <= z) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (i <= 0) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (i <= 1) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (0 <= i) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (1 <= i) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (i >= z) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (i >= 0) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (i >= 1) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (0 >= i) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (1 >= i) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (i == z) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (i == 0) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (i == 1) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (0 == i) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (1 == i) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (i != z) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (i != 0) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (i != 1) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (0 != i) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  c = 0; i = -2; while (i <= 2) { if (1 != i) c = c + 1; i = i + 1; } r = (r * 7 + c) % 1000003;
+  return r;
+}
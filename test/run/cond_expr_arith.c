@@ -0,0 +1,9 @@
+// ?:的两个分支都读取同一个变量
+// expect: 6
+int main() {
+  int a = 2;
+  int b = 5;
+  int r;
+  r = a > 0 ? b + 1 : b - 1;
+  return r;
+}
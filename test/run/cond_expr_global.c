@@ -0,0 +1,13 @@
+// ?:的两个分支读取不同的全局变量
+// expect: 4
+int g;
+int h;
+int main() {
+  int a = 1;
+  int b = 2;
+  int r;
+  g = 3;
+  h = 4;
+  r = a < b ? g + 1 : h + 2;
+  return r;
+}
@@ -0,0 +1,12 @@
+// 条件中的&&带有赋值的副作用
+// expect: 7
+int g;
+int h;
+int main() {
+  int a = 1;
+  int b = 2;
+  int r;
+  h = 5;
+  r = (a < b && (g = 7)) ? g : 100 + h;
+  return r;
+}
@@ -0,0 +1,10 @@
+// 嵌套的?:，false分支中有赋值
+// expect: 26
+int main() {
+  int a = 1;
+  int b = 2;
+  int c = 3;
+  int r;
+  r = a > b ? a : (b > c ? b : (c = c + 10));
+  return r + c;
+}
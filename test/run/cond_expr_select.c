@@ -0,0 +1,21 @@
+// 两个分支都是字面量或局部变量时，?:不跳转，按result = false + (true - false) * (cond != 0)计算
+// expect: 999707
+int main() {
+  int a;
+  int b = 7;
+  int c = -3;
+  int k = 0;
+  int r = 0;
+  while (k < 4) {
+    a = k - 1;
+    r = (r * 7 + (a ? b : c)) % 1000003;
+    r = (r * 7 + (a > 0 ? 3 : -5)) % 1000003;
+    r = (r * 7 + (a == 0 ? b : 2047)) % 1000003;
+    r = (r * 7 + (!a ? -2048 : c)) % 1000003;
+    r = (r * 7 + (a <= b ? a : b)) % 1000003;
+    r = (r * 7 + (a - 1 ? 0 : 1)) % 1000003;
+    r = (r * 7 + (a ? a : a)) % 1000003;
+    k = k + 1;
+  }
+  return r;
+}
@@ -0,0 +1,9 @@
+// 条件为0时走false分支
+// expect: 0
+int main() {
+  int a = 0;
+  int b = 4;
+  int r;
+  r = a ? b * 2 : a * 3;
+  return r;
+}
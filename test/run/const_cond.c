@@ -0,0 +1,25 @@
+// 常量条件：不会执行的分支和循环体不生成代码
+// expect: 3561
+int g;
+int main() {
+  int b = 1;
+  int c = 2;
+  int i = 0;
+  int s = 5;
+  int r;
+  if (0) b = c + 1;
+  if (1) c = c + 10; else b = c + 100;
+  while (0) { b = c + 1; }
+  for (i = 0; 0; i = i + 1) { s = s + 100; }
+  while (!2 && i < 20) {
+    s = s + i;
+    i = i + 1;
+  }
+  do {
+    s = s + 1;
+    i = i + 1;
+  } while (0);
+  r = 0 ? b + 1 : c * 2;
+  r = r + (0 && (g = 1)) + (-1 || (g = 2)) + (!0 && 3) * 10;
+  return r * 100 + s * 10 + b + g;
+}
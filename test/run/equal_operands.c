@@ -0,0 +1,14 @@
+// ==和!=的结果保存在新的临时变量中，不会覆盖作为右操作数的局部变量
+// expect: 11373
+int main() {
+  int a = 3;
+  int x = 3;
+  int y = 4;
+  int r;
+  int s;
+  r = a == x;
+  s = a != y;
+  r = r * 1000 + s * 100 + x * 10 + y;
+  r = r + (x == a) + (y != a) + (a == x + 0);
+  return r * 10 + x;
+}
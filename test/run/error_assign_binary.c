@@ -0,0 +1,7 @@
+// 赋值的左边不是unary，在=处报错
+// error: 5:9: expression is not assignable
+int main() {
+  int a = 1;
+  a + a = 3;
+  return a;
+}
@@ -0,0 +1,9 @@
+// 函数调用的结果不能作为左值
+// error: 7:7: left side of assignment is not a variable
+int f() {
+  return 1;
+}
+int main() {
+  f() = 1;
+  return 0;
+}
@@ -0,0 +1,7 @@
+// 数字不能作为左值
+// error: 5:5: left side of assignment is not a variable
+int main() {
+  int x = 1;
+  1 = x;
+  return x;
+}
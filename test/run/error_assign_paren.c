@@ -0,0 +1,7 @@
+// 括号中的二元运算同样不能作为赋值的左边
+// error: 5:11: expression is not assignable
+int main() {
+  int a = 1;
+  (a + a) = 3;
+  return a;
+}
@@ -0,0 +1,5 @@
+// 语法错误：函数名之后不是(，声明之后缺少分号
+// error: 3:10: expected ';'
+int main {
+  return 0;
+}
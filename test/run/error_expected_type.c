@@ -0,0 +1,8 @@
+// 语法错误：参数的类型不是int
+// error: 3:7: expected 'int'
+int f(a) {
+  return a;
+}
+int main() {
+  return 0;
+}
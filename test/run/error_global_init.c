@@ -0,0 +1,7 @@
+// 全局变量的初始值只能是常量
+// error: 4:11: initializer of global variable is not a constant
+int a = 1;
+int b = a + 1;
+int main() {
+  return b;
+}
@@ -0,0 +1,6 @@
+// 语法错误：+之后缺少操作数，不能在报错之后继续使用空的节点
+// error: 3:27: expected expression
+int f(int a) { return a + ; }
+int main() {
+  return 0;
+}
@@ -0,0 +1,6 @@
+// 语法错误：缺少分号，报告在下一个token处
+// error: 5:3: expected ';'
+int main() {
+  int a = 1
+  return a;
+}
@@ -0,0 +1,4 @@
+// 语法错误：文件在函数体中结束，报告在最后一个token处
+// error: 4:11: unexpected end of file
+int main() {
+  return 0;
@@ -0,0 +1,14 @@
+// 全局变量的初始值为负数
+// expect: 8
+int h = -5;
+int g = 13;
+int m = -2147483648;
+int main() {
+  int r = g + h;
+  if (m < 0) {
+    r = r + 0;
+  } else {
+    r = 100;
+  }
+  return r;
+}
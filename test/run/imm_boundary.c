@@ -0,0 +1,68 @@
+// 立即数的边界：在12位范围内时生成I型指令，超出时用li加载，乘以2的幂生成slli
+// expect: 648739
+int main() {
+  int x;
+  int k = 0;
+  int r = 0;
+  while (k < 6) {
+    if (k == 0) x = 0;
+    if (k == 1) x = 2047;
+    if (k == 2) x = -2048;
+    if (k == 3) x = 2048;
+    if (k == 4) x = -2049;
+    if (k == 5) x = 12345;
+    r = (r * 7 + (x + 2047)) % 1000003;
+    r = (r * 7 + (x - 2047)) % 1000003;
+    r = (r * 7 + (x + 2048)) % 1000003;
+    r = (r * 7 + (x - 2048)) % 1000003;
+    r = (r * 7 + (x + -2048)) % 1000003;
+    r = (r * 7 + (x - -2048)) % 1000003;
+    r = (r * 7 + (x + -2049)) % 1000003;
+    r = (r * 7 + (x - -2049)) % 1000003;
+    r = (r * 7 + (x < 2046)) % 1000003;
+    r = (r * 7 + (x <= 2046)) % 1000003;
+    r = (r * 7 + (x > 2046)) % 1000003;
+    r = (r * 7 + (x >= 2046)) % 1000003;
+    r = (r * 7 + (x == 2046)) % 1000003;
+    r = (r * 7 + (x != 2046)) % 1000003;
+    r = (r * 7 + (x < 2047)) % 1000003;
+    r = (r * 7 + (x <= 2047)) % 1000003;
+    r = (r * 7 + (x > 2047)) % 1000003;
+    r = (r * 7 + (x >= 2047)) % 1000003;
+    r = (r * 7 + (x == 2047)) % 1000003;
+    r = (r * 7 + (x != 2047)) % 1000003;
+    r = (r * 7 + (x < 2048)) % 1000003;
+    r = (r * 7 + (x <= 2048)) % 1000003;
+    r = (r * 7 + (x > 2048)) % 1000003;
+    r = (r * 7 + (x >= 2048)) % 1000003;
+    r = (r * 7 + (x == 2048)) % 1000003;
+    r = (r * 7 + (x != 2048)) % 1000003;
+    r = (r * 7 + (x < -2048)) % 1000003;
+    r = (r * 7 + (x <= -2048)) % 1000003;
+    r = (r * 7 + (x > -2048)) % 1000003;
+    r = (r * 7 + (x >= -2048)) % 1000003;
+    r = (r * 7 + (x == -2048)) % 1000003;
+    r = (r * 7 + (x != -2048)) % 1000003;
+    r = (r * 7 + (x < -2049)) % 1000003;
+    r = (r * 7 + (x <= -2049)) % 1000003;
+    r = (r * 7 + (x > -2049)) % 1000003;
+    r = (r * 7 + (x >= -2049)) % 1000003;
+    r = (r * 7 + (x == -2049)) % 1000003;
+    r = (r * 7 + (x != -2049)) % 1000003;
+    r = (r * 7 + (x * 1)) % 1000003;
+    r = (r * 7 + (x * 2)) % 1000003;
+    r = (r * 7 + (x * 8)) % 1000003;
+    r = (r * 7 + (x * 1024)) % 1000003;
+    r = (r * 7 + (x * 2048)) % 1000003;
+    r = (r * 7 + (x * 65536)) % 1000003;
+    r = (r * 7 + (x * 3)) % 1000003;
+    r = (r * 7 + (x * -4)) % 1000003;
+    r = (r * 7 + (x * 0)) % 1000003;
+    r = (r * 7 + (2047 + x)) % 1000003;
+    r = (r * 7 + (2048 * x)) % 1000003;
+    r = (r * 7 + (2047 < x)) % 1000003;
+    r = (r * 7 + (-2049 >= x)) % 1000003;
+    k = k + 1;
+  }
+  return r;
+}
@@ -0,0 +1,12 @@
+// 循环中&&的结果跨过标签保存在临时变量中
+// expect: 1
+int main() {
+  int i = 0;
+  int a = 0;
+  int c = 1;
+  while (i < 3) {
+    i = i + 1;
+    a = (c && c);
+  }
+  return a;
+}
@@ -0,0 +1,17 @@
+// &&和||短路时不执行右侧的赋值
+// expect: 321233
+int g;
+int h;
+int k;
+int m;
+int main() {
+  int a = 0;
+  int b = 1;
+  int r = 0;
+  if (a && (g = 1)) r = r + 100;
+  if (b || (h = 1)) r = r + 1000;
+  if (b && (k = 2)) r = r + 200;
+  if (a || (m = 3)) r = r + 30;
+  r = r + (a && (g = 5)) + (b || (h = 5)) * 3;
+  return r + g + h + k * 10000 + m * 100000;
+}
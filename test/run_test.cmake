@@ -0,0 +1,60 @@
+# 编译一个测试程序，用rv_sim执行生成的汇编，并与源文件中"// expect: N"给出的main的返回值比较
+# 源文件中为"// error: 行:列: 信息"时，期望编译失败并在该位置报告该错误
+# .ir文件为文本格式的IR，用--from-ir编译；.c文件还会把-i输出的IR再用--from-ir编译一次，检查两者的返回值
+# 参数: COMPILER, SIMULATOR, SOURCE, OUTPUT
+get_filename_component(source_ext ${SOURCE} LAST_EXT)
+if (source_ext STREQUAL ".ir")
+    set(from_ir --from-ir)
+endif ()
+
+file(READ ${SOURCE} source_text)  # 不用file(STRINGS)，它会把信息中的';'当作列表的分隔符
+string(REGEX MATCH "// error: [0-9]+:[0-9]+: [^\n]*" error_line "${source_text}")
+if (error_line)
+    string(REGEX REPLACE "^// error: ([0-9]+:[0-9]+): " "\\1: error: " expected_error "${error_line}")
+    execute_process(COMMAND ${COMPILER} ${from_ir} ${SOURCE} -o ${OUTPUT}
+            RESULT_VARIABLE compile_result
+            ERROR_VARIABLE compile_error)
+    if (compile_result EQUAL 0)
+        message(FATAL_ERROR "${SOURCE}: compiled, expected '${expected_error}'")
+    endif ()
+    string(FIND "${compile_error}" "${SOURCE}:${expected_error}" found)
+    if (found EQUAL -1)
+        message(FATAL_ERROR "${SOURCE}: expected '${SOURCE}:${expected_error}', got (${compile_result}): ${compile_error}")
+    endif ()
+    return()
+endif ()
+
+file(STRINGS ${SOURCE} expect_line REGEX "^// expect: -?[0-9]+$" LIMIT_COUNT 1)
+if (NOT expect_line)
+    message(FATAL_ERROR "${SOURCE}: missing '// expect: N' or '// error: line:column: message'")
+endif ()
+string(REGEX REPLACE "^// expect: " "" expected "${expect_line}")
+
+# 编译input并执行生成的汇编，比较main的返回值
+function(compile_and_run input output)
+    execute_process(COMMAND ${COMPILER} ${ARGN} ${input} -o ${output}
+            RESULT_VARIABLE compile_result
+            ERROR_VARIABLE compile_error)
+    if (NOT compile_result EQUAL 0)
+        message(FATAL_ERROR "${input}: compiler failed (${compile_result}): ${compile_error}")
+    endif ()
+
+    execute_process(COMMAND ${SIMULATOR} ${output}
+            RESULT_VARIABLE run_result
+            OUTPUT_VARIABLE actual
+            ERROR_VARIABLE run_error
+            OUTPUT_STRIP_TRAILING_WHITESPACE)
+    if (NOT run_result EQUAL 0)
+        message(FATAL_ERROR "${input}: simulation failed: ${run_error}")
+    endif ()
+    if (NOT actual STREQUAL expected)
+        message(FATAL_ERROR "${input}: main returned ${actual}, expected ${expected}")
+    endif ()
+endfunction()
+
+if (from_ir)
+    compile_and_run(${SOURCE} ${OUTPUT} --from-ir)
+else ()
+    compile_and_run(${SOURCE} ${OUTPUT} -i ${OUTPUT}.ir)
+    compile_and_run(${OUTPUT}.ir ${OUTPUT}.ir.s --from-ir)
+endif ()
@@ -0,0 +1,311 @@
+// 测试用的RISC-V(RV32IM)模拟器，只支持ASMGenerator会生成的指令和伪指令
+// 用法: rv_sim file.s，从main开始执行，main返回后输出a0的值(有符号整数)
+// 汇编或执行出错时输出错误信息并返回2，执行的指令数超过上限时同样视为出错
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kTextBase = 0x00010000;   // 指令的地址只用于call保存返回地址
+constexpr uint32_t kDataBase = 0x10000000;   // .data之后紧接着.bss，与链接器的布局相同
+constexpr uint32_t kStackTop = 0x7ffff000;
+constexpr uint32_t kExitAddr = 0xfffffff0;   // main的返回地址，跳转到这里表示程序结束
+constexpr uint64_t kMaxSteps = 100000000;
+
+[[noreturn]] void fail(const std::string &msg) {
+  std::cerr << "rv_sim: " << msg << std::endl;
+  std::exit(2);
+}
+
+struct Instr {
+  std::string op;
+  std::vector<std::string> args;
+  int line;
+};
+
+class Simulator {
+ public:
+  void load(std::istream &in) {
+    std::string line;
+    int line_num = 0;
+    std::string section = ".text";
+    // 数据段的符号先记录在各自段内的偏移，全部读完后再计算地址
+    std::vector<std::pair<std::string, uint32_t>> data_syms, bss_syms;
+    uint32_t data_size = 0, bss_size = 0;
+    std::vector<std::pair<uint32_t, int32_t>> data_words;
+    while (std::getline(in, line)) {
+      ++line_num;
+      auto words = split(line);
+      if (words.empty()) continue;
+      auto &head = words[0];
+      if (head == ".text" || head == ".data" || head == ".bss") {
+        section = head;
+        continue;
+      }
+      if (head == ".global" || head == ".file" || head == ".loc") continue;
+      bool is_label = head.back() == ':' || (words.size() == 1 && head.size() > 2 && head.compare(0, 2, ".L") == 0);
+      if (is_label) {
+        auto name = head.back() == ':' ? head.substr(0, head.size() - 1) : head;
+        if (section == ".text") {
+          text_labels_[name] = static_cast<int>(code_.size());
+        } else if (section == ".data") {
+          data_syms.emplace_back(name, data_size);
+        } else {
+          bss_syms.emplace_back(name, bss_size);
+        }
+        continue;
+      }
+      if (head == ".word") {
+        if (section != ".data") fail("line " + std::to_string(line_num) + ": .word outside .data");
+        data_words.emplace_back(data_size, static_cast<int32_t>(parse_imm(words.at(1), line_num)));
+        data_size += 4;
+        continue;
+      }
+      if (head == ".space") {
+        auto size = static_cast<uint32_t>(parse_imm(words.at(1), line_num));
+        (section == ".data" ? data_size : bss_size) += (size + 3) / 4 * 4;
+        continue;
+      }
+      if (head[0] == '.') fail("line " + std::to_string(line_num) + ": unknown directive " + head);
+      if (section != ".text") fail("line " + std::to_string(line_num) + ": instruction outside .text");
+      code_.push_back({head, {words.begin() + 1, words.end()}, line_num});
+    }
+    for (auto &[name, offset] : data_syms) data_labels_[name] = kDataBase + offset;
+    for (auto &[name, offset] : bss_syms) data_labels_[name] = kDataBase + data_size + offset;
+    for (auto &[offset, value] : data_words) memory_[kDataBase + offset] = value;
+  }
+
+  int32_t run() {
+    auto main_it = text_labels_.find("main");
+    if (main_it == text_labels_.end()) fail("no main");
+    regs_[2] = static_cast<int32_t>(kStackTop);
+    regs_[1] = static_cast<int32_t>(kExitAddr);
+    pc_ = main_it->second;
+    for (uint64_t steps = 0; steps < kMaxSteps; ++steps) {
+      if (pc_ < 0 || pc_ >= static_cast<int>(code_.size())) fail("pc out of range");
+      const auto &instr = code_[pc_++];
+      execute(instr);
+      regs_[0] = 0;
+      if (static_cast<uint32_t>(pc_) == kExitAddr) return regs_[10];
+    }
+    fail("step limit exceeded");
+  }
+
+ private:
+  static std::vector<std::string> split(const std::string &line) {
+    std::vector<std::string> words;
+    std::string word;
+    for (char c : line) {
+      if (c == ' ' || c == '\t' || c == ',' || c == '\r') {
+        if (!word.empty()) words.push_back(std::move(word));
+        word.clear();
+      } else {
+        word.push_back(c);
+      }
+    }
+    if (!word.empty()) words.push_back(std::move(word));
+    return words;
+  }
+  static int64_t parse_imm(const std::string &str, int line) {
+    char *end = nullptr;
+    auto value = std::strtoll(str.c_str(), &end, 0);
+    if (str.empty() || *end != '\0') fail("line " + std::to_string(line) + ": bad immediate " + str);
+    return value;
+  }
+  static int parse_reg(const std::string &str, int line) {
+    static const std::unordered_map<std::string, int> names = {
+        {"zero", 0}, {"ra", 1}, {"sp", 2}, {"gp", 3}, {"tp", 4}, {"t0", 5}, {"t1", 6}, {"t2", 7},
+        {"fp", 8}, {"s0", 8}, {"s1", 9}, {"a0", 10}, {"a1", 11},
+    };
+    auto it = names.find(str);
+    if (it != names.end()) return it->second;
+    if (str.size() >= 2 && str[0] == 'x') {
+      char *end = nullptr;
+      auto num = std::strtol(str.c_str() + 1, &end, 10);
+      if (*end == '\0' && num >= 0 && num < 32) return static_cast<int>(num);
+    }
+    fail("line " + std::to_string(line) + ": bad register " + str);
+  }
+  // 访存指令的操作数: offset(reg)
+  uint32_t parse_mem(const std::string &str, int line) {
+    auto lparen = str.find('(');
+    if (lparen == std::string::npos || str.back() != ')') fail("line " + std::to_string(line) + ": bad address " + str);
+    auto offset = parse_imm(str.substr(0, lparen), line);
+    auto reg = parse_reg(str.substr(lparen + 1, str.size() - lparen - 2), line);
+    auto addr = static_cast<uint32_t>(regs_[reg] + static_cast<int32_t>(offset));
+    if (addr % 4 != 0) fail("line " + std::to_string(line) + ": misaligned access");
+    return addr;
+  }
+  int text_label(const std::string &name, int line) const {
+    auto it = text_labels_.find(name);
+    if (it == text_labels_.end()) fail("line " + std::to_string(line) + ": unknown label " + name);
+    return it->second;
+  }
+
+  void execute(const Instr &instr) {
+    const auto &op = instr.op;
+    const auto &a = instr.args;
+    int line = instr.line;
+    auto need = [&](std::size_t n) {
+      if (a.size() != n) fail("line " + std::to_string(line) + ": wrong operand count for " + op);
+    };
+    auto reg = [&](std::size_t i) -> int32_t & { return regs_[parse_reg(a.at(i), line)]; };
+    auto val = [&](std::size_t i) -> int32_t { return regs_[parse_reg(a.at(i), line)]; };
+    auto imm = [&](std::size_t i) -> int32_t {
+      auto value = parse_imm(a.at(i), line);
+      if (value < -2048 || value > 2047) fail("line " + std::to_string(line) + ": immediate out of range");
+      return static_cast<int32_t>(value);
+    };
+    auto branch = [&](bool cond) {
+      if (cond) pc_ = text_label(a.back(), line);
+    };
+    // 32位补码运算，溢出时回绕
+    auto wrap = [](int64_t value) { return static_cast<int32_t>(static_cast<uint32_t>(value)); };
+
+    static const std::map<std::string, int> reg3 = {
+        {"add", 0}, {"sub", 1}, {"mul", 2}, {"div", 3}, {"rem", 4}, {"slt", 5}, {"sgt", 6},
+        {"and", 7}, {"or", 8}, {"xor", 9},
+    };
+    if (auto it = reg3.find(op); it != reg3.end()) {
+      need(3);
+      int64_t x = val(1), y = val(2);
+      int32_t result = 0;
+      switch (it->second) {
+        case 0: result = wrap(x + y); break;
+        case 1: result = wrap(x - y); break;
+        case 2: result = wrap(x * y); break;
+        case 3: result = y == 0 ? -1 : wrap(x / y); break;
+        case 4: result = y == 0 ? static_cast<int32_t>(x) : wrap(x % y); break;
+        case 5: result = x < y; break;
+        case 6: result = x > y; break;
+        case 7: result = static_cast<int32_t>(x & y); break;
+        case 8: result = static_cast<int32_t>(x | y); break;
+        default: result = static_cast<int32_t>(x ^ y); break;
+      }
+      reg(0) = result;
+    } else if (op == "addi") {
+      need(3);
+      reg(0) = wrap(static_cast<int64_t>(val(1)) + imm(2));
+    } else if (op == "slti") {
+      need(3);
+      reg(0) = val(1) < imm(2);
+    } else if (op == "xori") {
+      need(3);
+      reg(0) = val(1) ^ imm(2);
+    } else if (op == "andi") {
+      need(3);
+      reg(0) = val(1) & imm(2);
+    } else if (op == "ori") {
+      need(3);
+      reg(0) = val(1) | imm(2);
+    } else if (op == "slli" || op == "srai" || op == "srli") {
+      need(3);
+      auto shamt = parse_imm(a.at(2), line);
+      if (shamt < 0 || shamt > 31) fail("line " + std::to_string(line) + ": bad shift amount");
+      auto x = static_cast<uint32_t>(val(1));
+      if (op == "slli") {
+        reg(0) = static_cast<int32_t>(x << shamt);
+      } else if (op == "srli") {
+        reg(0) = static_cast<int32_t>(x >> shamt);
+      } else {
+        reg(0) = val(1) >> shamt;
+      }
+    } else if (op == "li") {
+      need(2);
+      auto value = parse_imm(a.at(1), line);
+      if (value < INT32_MIN || value > UINT32_MAX) fail("line " + std::to_string(line) + ": li out of range");
+      reg(0) = wrap(value);
+    } else if (op == "mv") {
+      need(2);
+      reg(0) = val(1);
+    } else if (op == "neg") {
+      need(2);
+      reg(0) = wrap(-static_cast<int64_t>(val(1)));
+    } else if (op == "not") {
+      need(2);
+      reg(0) = ~val(1);
+    } else if (op == "seqz") {
+      need(2);
+      reg(0) = val(1) == 0;
+    } else if (op == "snez") {
+      need(2);
+      reg(0) = val(1) != 0;
+    } else if (op == "la") {
+      need(2);
+      auto it = data_labels_.find(a[1]);
+      if (it == data_labels_.end()) fail("line " + std::to_string(line) + ": unknown symbol " + a[1]);
+      reg(0) = static_cast<int32_t>(it->second);
+    } else if (op == "lw") {
+      need(2);
+      auto addr = parse_mem(a[1], line);
+      auto it = memory_.find(addr);
+      reg(0) = it == memory_.end() ? 0 : it->second;
+    } else if (op == "sw") {
+      need(2);
+      memory_[parse_mem(a[1], line)] = val(0);
+    } else if (op == "j") {
+      need(1);
+      pc_ = text_label(a[0], line);
+    } else if (op == "call") {
+      need(1);
+      regs_[1] = static_cast<int32_t>(kTextBase + 4 * pc_);
+      pc_ = text_label(a[0], line);
+    } else if (op == "ret") {
+      need(0);
+      auto target = static_cast<uint32_t>(regs_[1]);
+      if (target == kExitAddr) {
+        pc_ = static_cast<int>(kExitAddr);
+      } else {
+        if (target < kTextBase || (target - kTextBase) % 4 != 0) fail("ret to a bad address");
+        pc_ = static_cast<int>((target - kTextBase) / 4);
+      }
+    } else if (op == "beqz" || op == "bnez") {
+      need(2);
+      branch((val(0) == 0) == (op == "beqz"));
+    } else if (op == "beq") {
+      need(3);
+      branch(val(0) == val(1));
+    } else if (op == "bne") {
+      need(3);
+      branch(val(0) != val(1));
+    } else if (op == "blt") {
+      need(3);
+      branch(val(0) < val(1));
+    } else if (op == "bge") {
+      need(3);
+      branch(val(0) >= val(1));
+    } else {
+      fail("line " + std::to_string(line) + ": unsupported instruction " + op);
+    }
+  }
+
+  std::vector<Instr> code_;
+  std::unordered_map<std::string, int> text_labels_;
+  std::unordered_map<std::string, uint32_t> data_labels_;
+  std::unordered_map<uint32_t, int32_t> memory_;
+  int32_t regs_[32]{};
+  int pc_{0};
+};
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    std::cerr << "usage: rv_sim file.s" << std::endl;
+    return 2;
+  }
+  std::ifstream in(argv[1]);
+  if (!in) fail(std::string("cannot open ") + argv[1]);
+  Simulator simulator;
+  simulator.load(in);
+  std::cout << simulator.run() << std::endl;
+  return 0;
+}